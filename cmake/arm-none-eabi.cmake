@@ -23,6 +23,7 @@ set(CMAKE_CXX_COMPILER  ${TOOLCHAIN_PATH}/arm-none-eabi-g++${CMAKE_EXECUTABLE_SU
 set(CMAKE_LINKER        ${TOOLCHAIN_PATH}/arm-none-eabi-ld${CMAKE_EXECUTABLE_SUFFIX})
 set(CMAKE_OBJCOPY       ${TOOLCHAIN_PATH}/arm-none-eabi-objcopy${CMAKE_EXECUTABLE_SUFFIX})
 set(CMAKE_RANLIB        ${TOOLCHAIN_PATH}/arm-none-eabi-ranlib${CMAKE_EXECUTABLE_SUFFIX})
+set(CMAKE_NM            ${TOOLCHAIN_PATH}/arm-none-eabi-nm${CMAKE_EXECUTABLE_SUFFIX})
 set(CMAKE_SIZE          ${TOOLCHAIN_PATH}/arm-none-eabi-size${CMAKE_EXECUTABLE_SUFFIX})
 set(CMAKE_STRIP         ${TOOLCHAIN_PATH}/arm-none-eabi-strip${CMAKE_EXECUTABLE_SUFFIX})
 
@@ -30,10 +31,25 @@ set(CMAKE_STRIP         ${TOOLCHAIN_PATH}/arm-none-eabi-strip${CMAKE_EXECUTABLE_
 set(CMAKE_C_FLAGS       "-Wno-psabi -fdata-sections -ffunction-sections -Wl,--gc-sections" CACHE INTERNAL "")
 set(CMAKE_CXX_FLAGS     "${CMAKE_C_FLAGS} -fno-exceptions" CACHE INTERNAL "")
 
-set(CMAKE_C_FLAGS_DEBUG     "-Os -g" CACHE INTERNAL "")
-set(CMAKE_C_FLAGS_RELEASE   "-Os -DNDEBUG" CACHE INTERNAL "")
-set(CMAKE_CXX_FLAGS_DEBUG   "${CMAKE_C_FLAGS_DEBUG}" CACHE INTERNAL "")
-set(CMAKE_CXX_FLAGS_RELEASE "${CMAKE_C_FLAGS_RELEASE}" CACHE INTERNAL "")
+# Build profiles, selected by CMAKE_BUILD_TYPE:
+# - Debug: no optimization, full debug information,
+# - ReleaseSpeed: optimized for execution time, link time optimization,
+# - ReleaseSize: optimized for code size, link time optimization, no unwind tables.
+# Release profiles keep debug information, it doesn't go to the flashed image but makes the ELF debuggable.
+# LTO needs the optimization level at link time too, because code generation happens in the linker.
+set(CMAKE_C_FLAGS_DEBUG             "-O0 -g3" CACHE INTERNAL "")
+set(CMAKE_C_FLAGS_RELEASE           "-Os -DNDEBUG" CACHE INTERNAL "")
+set(CMAKE_C_FLAGS_RELEASESPEED      "-O2 -g -DNDEBUG -flto" CACHE INTERNAL "")
+set(CMAKE_C_FLAGS_RELEASESIZE       "-Os -g -DNDEBUG -flto -fno-unwind-tables -fno-asynchronous-unwind-tables"
+    CACHE INTERNAL "")
+set(CMAKE_CXX_FLAGS_DEBUG           "${CMAKE_C_FLAGS_DEBUG}" CACHE INTERNAL "")
+set(CMAKE_CXX_FLAGS_RELEASE         "${CMAKE_C_FLAGS_RELEASE}" CACHE INTERNAL "")
+set(CMAKE_CXX_FLAGS_RELEASESPEED    "${CMAKE_C_FLAGS_RELEASESPEED}" CACHE INTERNAL "")
+set(CMAKE_CXX_FLAGS_RELEASESIZE     "${CMAKE_C_FLAGS_RELEASESIZE}" CACHE INTERNAL "")
+set(CMAKE_ASM_FLAGS_RELEASESPEED    "-g" CACHE INTERNAL "")
+set(CMAKE_ASM_FLAGS_RELEASESIZE     "-g" CACHE INTERNAL "")
+set(CMAKE_EXE_LINKER_FLAGS_RELEASESPEED "-O2 -flto" CACHE INTERNAL "")
+set(CMAKE_EXE_LINKER_FLAGS_RELEASESIZE  "-Os -flto" CACHE INTERNAL "")
 
 set(CMAKE_FIND_ROOT_PATH_MODE_PROGRAM NEVER)
 set(CMAKE_FIND_ROOT_PATH_MODE_LIBRARY ONLY)
@@ -0,0 +1,42 @@
+#
+# Copyright (c) 2023 Piotr Pryga
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+
+# Post-build size report. Writes sizes of all sections and all symbols of an ELF file, symbols sorted from the
+# largest, to OUTPUT file and prints the section sizes with the largest symbols to the build log.
+#
+# Usage: cmake -DELF=<elf> -DSIZE=<size tool> -DNM=<nm tool> -DOUTPUT=<report> [-DTOP=<count>] -P size_report.cmake
+
+if(NOT DEFINED TOP)
+        set(TOP 20)
+endif()
+
+execute_process(COMMAND ${SIZE} -A -d ${ELF}
+                OUTPUT_VARIABLE SECTIONS
+                RESULT_VARIABLE RESULT)
+if(NOT RESULT EQUAL 0)
+        message(FATAL_ERROR "${SIZE} failed for ${ELF}")
+endif()
+
+# Only symbols that have size are listed when sorted by size
+execute_process(COMMAND ${NM} --print-size --size-sort --reverse-sort --radix=d ${ELF}
+                OUTPUT_VARIABLE SYMBOLS
+                RESULT_VARIABLE RESULT)
+if(NOT RESULT EQUAL 0)
+        message(FATAL_ERROR "${NM} failed for ${ELF}")
+endif()
+
+file(WRITE ${OUTPUT} "Sections:\n${SECTIONS}\nSymbols (address size type name):\n${SYMBOLS}")
+
+string(REGEX MATCHALL "[^\n]+" SYMBOL_LINES "${SYMBOLS}")
+list(LENGTH SYMBOL_LINES SYMBOL_COUNT)
+if(SYMBOL_COUNT GREATER TOP)
+        list(SUBLIST SYMBOL_LINES 0 ${TOP} SYMBOL_LINES)
+endif()
+string(REPLACE ";" "\n" SYMBOL_LINES "${SYMBOL_LINES}")
+
+message("${SECTIONS}")
+message("Largest ${TOP} symbols (address size type name):\n${SYMBOL_LINES}\n")
+message("Full report: ${OUTPUT}")
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <drivers/nrfx_common.h>
+
+#include "bench.h"
+
+void bench_run()
+{
+	/* Cycle counter is used to measure time */
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+#ifdef BUILD_PROFILE
+	printf("Benchmarks, build profile %s, core clock %lu Hz\r\n", BUILD_PROFILE, SystemCoreClock);
+#else
+	printf("Benchmarks, core clock %lu Hz\r\n", SystemCoreClock);
+#endif /* BUILD_PROFILE */
+
+	bench_rwlock();
+	bench_thread();
+	bench_coro();
+	bench_mem();
+	bench_dsp();
+	bench_crc();
+
+	printf("Benchmarks done\r\n");
+}
+
+void bench_report(const char *name, uint32_t iterations, uint64_t cycles)
+{
+	/* Cycles per operation with two decimal places, without floating point printf support */
+	uint64_t centi_cycles = (iterations != 0) ? (cycles * 100) / iterations : 0;
+
+	printf("%s: %lu ops, %lu.%02lu cycles/op\r\n", name, iterations, (uint32_t)(centi_cycles / 100),
+	       (uint32_t)(centi_cycles % 100));
+}
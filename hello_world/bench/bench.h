@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __BENCH_BENCH_H__
+#define __BENCH_BENCH_H__
+
+#include <stdint.h>
+
+/** @file On-target benchmarks.
+ *
+ * Benchmarks are built when BENCH_BUILD CMake option is enabled. Those are run by main() before the application
+ * threads are created. Results are printed with printf, that is sent over UART. Time is measured with DWT CYCCNT.
+ */
+
+/* @brief Run all benchmarks */
+void bench_run();
+
+/* @brief Print a benchmark result
+ *
+ * @param name Name of the benchmark
+ * @param iterations Number of measured operations
+ * @param cycles Number of cycles the operations took in total
+ */
+void bench_report(const char *name, uint32_t iterations, uint64_t cycles);
+
+/* @brief Compare reader throughput of reader-writer lock and spin lock */
+void bench_rwlock();
+
+/* @brief Measure throughput of short-lived threads creation and exit */
+void bench_thread();
+
+/* @brief Compare RAM per task and switch cost of coroutines and threads */
+void bench_coro();
+
+/* @brief Compare throughput of tools/mem.c functions and newlib memcpy(), memmove(), memset() and memcmp() */
+void bench_mem();
+
+/* @brief Compare cycles per sample of SIMD DSP kernels and their scalar versions */
+void bench_dsp();
+
+/* @brief Measure throughput of CRC functions in bytes per cycle */
+void bench_crc();
+
+#endif /* __BENCH_BENCH_H__ */
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <drivers/nrfx_common.h>
+
+#include "bench.h"
+#include "sys/coro.h"
+#include "sys/event_group.h"
+#include "sys/scheduler.h"
+#include "sys/thread.h"
+#include "tools/coroutine.h"
+#include "tools/misc.h"
+
+/* Number of round trips between two tasks, each round trip is two switches */
+#define BENCH_CORO_ROUND_TRIPS 1000
+
+#define BENCH_EVENT_PING BIT(0)
+#define BENCH_EVENT_PONG BIT(1)
+#define BENCH_EVENT_DONE BIT(2)
+
+/* Coroutine state, this and the coroutine function is all a coroutine task needs */
+typedef struct bench_coro {
+	coro_t coro;
+	uint32_t round_trips;
+} bench_coro_t;
+
+static coro_runner_t m_runner;
+static coro_sem_t m_ping_sem;
+static coro_sem_t m_pong_sem;
+static bench_coro_t m_ping_coro;
+static bench_coro_t m_pong_coro;
+
+static event_group_t m_events;
+
+/* Both benchmarks are timed by the task that starts the exchange, so creation of tasks isn't measured */
+static uint32_t m_start;
+static uint32_t m_cycles;
+
+THREAD_STACK_STATIC(bench_coro_runner, THREAD_STACK_SIZE);
+THREAD_STACK_STATIC(bench_ping, THREAD_STACK_SIZE);
+THREAD_STACK_STATIC(bench_pong, THREAD_STACK_SIZE);
+
+static int bench_ping_coro(coro_t *coro)
+{
+	bench_coro_t *ping = CONTAINER_OF(coro, bench_coro_t, coro);
+
+	CORO_BEGIN(coro);
+	m_start = DWT->CYCCNT;
+	for (ping->round_trips = 0; ping->round_trips < BENCH_CORO_ROUND_TRIPS; ping->round_trips++) {
+		coro_sem_give(&m_pong_sem);
+		CORO_SEM_TAKE(coro, &m_ping_sem);
+	}
+	m_cycles = DWT->CYCCNT - m_start;
+
+	event_group_set(&m_events, BENCH_EVENT_DONE);
+	CORO_END(coro);
+}
+
+static int bench_pong_coro(coro_t *coro)
+{
+	bench_coro_t *pong = CONTAINER_OF(coro, bench_coro_t, coro);
+
+	CORO_BEGIN(coro);
+	for (pong->round_trips = 0; pong->round_trips < BENCH_CORO_ROUND_TRIPS; pong->round_trips++) {
+		CORO_SEM_TAKE(coro, &m_pong_sem);
+		coro_sem_give(&m_ping_sem);
+	}
+	CORO_END(coro);
+}
+
+/* @brief Measure a switch between two coroutines of one runner that signal each other with semaphores */
+static void bench_coro_switch()
+{
+	thread_t *runner_thread;
+
+	coro_runner_init(&m_runner);
+	coro_sem_init(&m_ping_sem, 0, 1);
+	coro_sem_init(&m_pong_sem, 0, 1);
+	event_group_init(&m_events);
+
+	if (coro_runner_thread_start(&m_runner, &runner_thread, stack_bench_coro_runner,
+				     sizeof(stack_bench_coro_runner)) != 0) {
+		printf("coroutine switch: runner thread create failed\r\n");
+		return;
+	}
+
+	coro_start(&m_runner, &m_pong_coro.coro, bench_pong_coro);
+	coro_start(&m_runner, &m_ping_coro.coro, bench_ping_coro);
+
+	(void)event_group_wait(&m_events, BENCH_EVENT_DONE, EVENT_GROUP_WAIT_ANY, SCHED_TIMEOUT_FOREVER, NULL);
+
+	/* Both coroutines have ended, the runner thread pends for more work and isn't needed any more */
+	(void)thread_abort(runner_thread);
+
+	bench_report("coroutine switch", BENCH_CORO_ROUND_TRIPS * 2, m_cycles);
+}
+
+static void bench_ping_thread(void *arg)
+{
+	(void)arg;
+
+	m_start = DWT->CYCCNT;
+	for (int idx = 0; idx < BENCH_CORO_ROUND_TRIPS; idx++) {
+		event_group_set(&m_events, BENCH_EVENT_PONG);
+		(void)event_group_wait(&m_events, BENCH_EVENT_PING, EVENT_GROUP_WAIT_ANY | EVENT_GROUP_CLEAR_ON_EXIT,
+				       SCHED_TIMEOUT_FOREVER, NULL);
+	}
+	m_cycles = DWT->CYCCNT - m_start;
+}
+
+static void bench_pong_thread(void *arg)
+{
+	(void)arg;
+
+	for (int idx = 0; idx < BENCH_CORO_ROUND_TRIPS; idx++) {
+		(void)event_group_wait(&m_events, BENCH_EVENT_PONG, EVENT_GROUP_WAIT_ANY | EVENT_GROUP_CLEAR_ON_EXIT,
+				       SCHED_TIMEOUT_FOREVER, NULL);
+		event_group_set(&m_events, BENCH_EVENT_PING);
+	}
+}
+
+/* @brief Measure a switch between two threads that signal each other with an event group */
+static void bench_thread_switch()
+{
+	thread_t *ping;
+	thread_t *pong;
+
+	event_group_init(&m_events);
+
+	if (thread_create_arg(&pong, bench_pong_thread, NULL, stack_bench_pong, sizeof(stack_bench_pong)) != 0) {
+		printf("thread switch: thread create failed\r\n");
+		return;
+	}
+
+	if (thread_create_arg(&ping, bench_ping_thread, NULL, stack_bench_ping, sizeof(stack_bench_ping)) != 0) {
+		printf("thread switch: thread create failed\r\n");
+		(void)thread_abort(pong);
+		return;
+	}
+
+	thread_join(ping);
+	thread_join(pong);
+
+	bench_report("thread switch", BENCH_CORO_ROUND_TRIPS * 2, m_cycles);
+}
+
+void bench_coro()
+{
+	/* A runner thread and its stack are shared by all coroutines of the runner, so those are not counted per task */
+	printf("RAM per task: coroutine %u B, thread %u B (object %u B, stack %u B)\r\n",
+	       (unsigned int)sizeof(bench_coro_t), (unsigned int)(sizeof(thread_t) + THREAD_STACK_SIZE),
+	       (unsigned int)sizeof(thread_t), (unsigned int)THREAD_STACK_SIZE);
+
+	bench_coro_switch();
+	bench_thread_switch();
+}
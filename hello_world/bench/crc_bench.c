@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <drivers/nrfx_common.h>
+
+#include "bench.h"
+#include "tools/crc.h"
+
+/* Size of a typical UART frame */
+#define BENCH_CRC_FRAME_SIZE 256
+#define BENCH_CRC_FRAMES 64
+
+static uint8_t m_frame[BENCH_CRC_FRAME_SIZE];
+
+/* Results are stored to volatile, so the compiler doesn't drop calls of pure functions */
+static volatile uint32_t m_crc_sink;
+
+/* Bitwise CRC-32, as computed by application code before tools/crc.c */
+static uint32_t bench_crc32_bitwise(const uint8_t *data, uint32_t size)
+{
+	uint32_t crc = 0xFFFFFFFF;
+
+	for (uint32_t idx = 0; idx < size; idx++) {
+		crc ^= data[idx];
+		for (int bit = 0; bit < 8; bit++) {
+			crc = (crc & 1) ? ((crc >> 1) ^ 0xEDB88320UL) : (crc >> 1);
+		}
+	}
+
+	return ~crc;
+}
+
+/* @brief Print throughput in bytes per cycle with three decimal places, without floating point printf support */
+static void bench_crc_report(const char *name, uint32_t cycles)
+{
+	uint64_t bytes = (uint64_t)BENCH_CRC_FRAME_SIZE * BENCH_CRC_FRAMES;
+	uint32_t milli_bytes = (cycles != 0) ? (uint32_t)((bytes * 1000) / cycles) : 0;
+
+	printf("%s: %lu.%03lu B/cycle\r\n", name, milli_bytes / 1000, milli_bytes % 1000);
+}
+
+void bench_crc()
+{
+	uint32_t start;
+
+	for (int idx = 0; idx < BENCH_CRC_FRAME_SIZE; idx++) {
+		m_frame[idx] = (uint8_t)(idx * 31 + 7);
+	}
+
+	start = DWT->CYCCNT;
+	for (int frame = 0; frame < BENCH_CRC_FRAMES; frame++) {
+		m_crc_sink = bench_crc32_bitwise(m_frame, BENCH_CRC_FRAME_SIZE);
+	}
+	bench_crc_report("crc32 bitwise", DWT->CYCCNT - start);
+
+	start = DWT->CYCCNT;
+	for (int frame = 0; frame < BENCH_CRC_FRAMES; frame++) {
+		m_crc_sink = crc32_update(CRC32_INIT, m_frame, BENCH_CRC_FRAME_SIZE);
+	}
+	bench_crc_report("crc32 table", DWT->CYCCNT - start);
+
+	start = DWT->CYCCNT;
+	for (int frame = 0; frame < BENCH_CRC_FRAMES; frame++) {
+		m_crc_sink = crc16_ccitt_update(CRC16_CCITT_INIT, m_frame, BENCH_CRC_FRAME_SIZE);
+	}
+	bench_crc_report("crc16 ccitt table", DWT->CYCCNT - start);
+
+	start = DWT->CYCCNT;
+	for (int frame = 0; frame < BENCH_CRC_FRAMES; frame++) {
+		m_crc_sink = crc8_update(CRC8_INIT, m_frame, BENCH_CRC_FRAME_SIZE);
+	}
+	bench_crc_report("crc8 table", DWT->CYCCNT - start);
+}
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <drivers/nrfx_common.h>
+
+#include "bench.h"
+#include "dsp/dsp.h"
+
+#define BENCH_DSP_BLOCK_SIZE 256
+#define BENCH_DSP_FIR_TAPS 32
+#define BENCH_DSP_BIQUAD_STAGES 2
+/* Blocks processed by each measurement */
+#define BENCH_DSP_BLOCKS 16
+
+static q15_t m_src[BENCH_DSP_BLOCK_SIZE];
+static q15_t m_other[BENCH_DSP_BLOCK_SIZE];
+static q15_t m_dst[BENCH_DSP_BLOCK_SIZE];
+static float m_src_f32[BENCH_DSP_BLOCK_SIZE];
+static float m_dst_f32[BENCH_DSP_BLOCK_SIZE];
+
+static q15_t m_fir_coeffs[BENCH_DSP_FIR_TAPS];
+static q15_t m_fir_state[BENCH_DSP_FIR_TAPS - 1 + BENCH_DSP_BLOCK_SIZE];
+
+/* Low-pass stages */
+static const float m_biquad_coeffs[BENCH_DSP_BIQUAD_STAGES * 5] = {
+	0.0675f, 0.1349f, 0.0675f, -1.1430f, 0.4128f,
+	0.0940f, 0.1880f, 0.0940f, -0.9985f, 0.3745f,
+};
+static float m_biquad_state[BENCH_DSP_BIQUAD_STAGES * 2];
+
+/* Results are stored to volatile, so the compiler doesn't drop calls of pure functions */
+static volatile int64_t m_dot_sink;
+
+static void bench_dsp_report(const char *name, uint32_t cycles)
+{
+	bench_report(name, BENCH_DSP_BLOCKS * BENCH_DSP_BLOCK_SIZE, cycles);
+}
+
+static void bench_dsp_dot()
+{
+	uint32_t start = DWT->CYCCNT;
+	for (int block = 0; block < BENCH_DSP_BLOCKS; block++) {
+		m_dot_sink = dsp_dot_q15(m_src, m_other, BENCH_DSP_BLOCK_SIZE);
+	}
+	bench_dsp_report("dot q15 simd", DWT->CYCCNT - start);
+
+	start = DWT->CYCCNT;
+	for (int block = 0; block < BENCH_DSP_BLOCKS; block++) {
+		m_dot_sink = dsp_dot_q15_scalar(m_src, m_other, BENCH_DSP_BLOCK_SIZE);
+	}
+	bench_dsp_report("dot q15 scalar", DWT->CYCCNT - start);
+}
+
+static void bench_dsp_add()
+{
+	uint32_t start = DWT->CYCCNT;
+	for (int block = 0; block < BENCH_DSP_BLOCKS; block++) {
+		dsp_add_q15(m_src, m_other, m_dst, BENCH_DSP_BLOCK_SIZE);
+	}
+	bench_dsp_report("add q15 simd", DWT->CYCCNT - start);
+
+	start = DWT->CYCCNT;
+	for (int block = 0; block < BENCH_DSP_BLOCKS; block++) {
+		dsp_add_q15_scalar(m_src, m_other, m_dst, BENCH_DSP_BLOCK_SIZE);
+	}
+	bench_dsp_report("add q15 scalar", DWT->CYCCNT - start);
+}
+
+static void bench_dsp_fir()
+{
+	dsp_fir_q15_t fir;
+
+	dsp_fir_q15_init(&fir, m_fir_coeffs, BENCH_DSP_FIR_TAPS, m_fir_state, BENCH_DSP_BLOCK_SIZE);
+
+	uint32_t start = DWT->CYCCNT;
+	for (int block = 0; block < BENCH_DSP_BLOCKS; block++) {
+		dsp_fir_q15(&fir, m_src, m_dst, BENCH_DSP_BLOCK_SIZE);
+	}
+	bench_dsp_report("fir q15 32 taps simd", DWT->CYCCNT - start);
+
+	dsp_fir_q15_init(&fir, m_fir_coeffs, BENCH_DSP_FIR_TAPS, m_fir_state, BENCH_DSP_BLOCK_SIZE);
+
+	start = DWT->CYCCNT;
+	for (int block = 0; block < BENCH_DSP_BLOCKS; block++) {
+		dsp_fir_q15_scalar(&fir, m_src, m_dst, BENCH_DSP_BLOCK_SIZE);
+	}
+	bench_dsp_report("fir q15 32 taps scalar", DWT->CYCCNT - start);
+}
+
+static void bench_dsp_biquad()
+{
+	dsp_biquad_f32_t biquad;
+
+	dsp_biquad_f32_init(&biquad, m_biquad_coeffs, m_biquad_state, BENCH_DSP_BIQUAD_STAGES);
+
+	uint32_t start = DWT->CYCCNT;
+	for (int block = 0; block < BENCH_DSP_BLOCKS; block++) {
+		dsp_biquad_f32(&biquad, m_src_f32, m_dst_f32, BENCH_DSP_BLOCK_SIZE);
+	}
+	bench_dsp_report("biquad f32 2 stages blockwise", DWT->CYCCNT - start);
+
+	dsp_biquad_f32_init(&biquad, m_biquad_coeffs, m_biquad_state, BENCH_DSP_BIQUAD_STAGES);
+
+	start = DWT->CYCCNT;
+	for (int block = 0; block < BENCH_DSP_BLOCKS; block++) {
+		dsp_biquad_f32_scalar(&biquad, m_src_f32, m_dst_f32, BENCH_DSP_BLOCK_SIZE);
+	}
+	bench_dsp_report("biquad f32 2 stages scalar", DWT->CYCCNT - start);
+}
+
+static void bench_dsp_stats()
+{
+	dsp_stats_q15_t stats;
+
+	uint32_t start = DWT->CYCCNT;
+	for (int block = 0; block < BENCH_DSP_BLOCKS; block++) {
+		dsp_stats_q15(m_src, BENCH_DSP_BLOCK_SIZE, &stats);
+	}
+	bench_dsp_report("stats q15 simd", DWT->CYCCNT - start);
+
+	start = DWT->CYCCNT;
+	for (int block = 0; block < BENCH_DSP_BLOCKS; block++) {
+		dsp_stats_q15_scalar(m_src, BENCH_DSP_BLOCK_SIZE, &stats);
+	}
+	bench_dsp_report("stats q15 scalar", DWT->CYCCNT - start);
+
+	printf("stats: min %d max %d mean %d rms %d\r\n", stats.min, stats.max, stats.mean, stats.rms);
+}
+
+void bench_dsp()
+{
+	/* Deterministic pseudo-random samples */
+	uint32_t seed = 12345;
+
+	for (int idx = 0; idx < BENCH_DSP_BLOCK_SIZE; idx++) {
+		seed = seed * 1664525UL + 1013904223UL;
+		m_src[idx] = (q15_t)(seed >> 16);
+		m_other[idx] = (q15_t)seed;
+	}
+
+	for (int idx = 0; idx < BENCH_DSP_FIR_TAPS; idx++) {
+		m_fir_coeffs[idx] = (q15_t)(32768 / BENCH_DSP_FIR_TAPS);
+	}
+
+	dsp_q15_to_f32(m_src, m_src_f32, BENCH_DSP_BLOCK_SIZE);
+
+	/* Results are cycles per sample */
+	bench_dsp_dot();
+	bench_dsp_add();
+	bench_dsp_fir();
+	bench_dsp_biquad();
+	bench_dsp_stats();
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <drivers/nrfx_common.h>
+
+#include "bench.h"
+#include "tools/mem.h"
+#include "tools/misc.h"
+
+#define BENCH_MEM_MAX_SIZE 4096
+/* Repeat short operations, so call overhead of cycle counter reads is spread */
+#define BENCH_MEM_BYTES_PER_SIZE (16 * 1024)
+
+#ifdef MEM_LIBC_WRAP_ENABLED
+/* C library functions are wrapped, originals are available under __real_ names */
+void *__real_memcpy(void *dst, const void *src, size_t size);
+void *__real_memmove(void *dst, const void *src, size_t size);
+void *__real_memset(void *dst, int value, size_t size);
+int __real_memcmp(const void *a, const void *b, size_t size);
+#define BENCH_LIBC_MEMCPY __real_memcpy
+#define BENCH_LIBC_MEMMOVE __real_memmove
+#define BENCH_LIBC_MEMSET __real_memset
+#define BENCH_LIBC_MEMCMP __real_memcmp
+#else
+#define BENCH_LIBC_MEMCPY memcpy
+#define BENCH_LIBC_MEMMOVE memmove
+#define BENCH_LIBC_MEMSET memset
+#define BENCH_LIBC_MEMCMP memcmp
+#endif /* MEM_LIBC_WRAP_ENABLED */
+
+/* Extra bytes allow for misaligned source and destination */
+static uint8_t m_src[BENCH_MEM_MAX_SIZE + 4] __attribute__((aligned(4)));
+static uint8_t m_dst[BENCH_MEM_MAX_SIZE + 4] __attribute__((aligned(4)));
+
+static const uint32_t m_sizes[] = { 1, 4, 16, 64, 256, 1024, 4096 };
+
+typedef enum {
+	BENCH_MEM_COPY,
+	BENCH_MEM_MOVE,
+	BENCH_MEM_SET,
+	BENCH_MEM_COMPARE,
+} BENCH_MEM_OP_T;
+
+/* @brief Measure cycles of repeated operation on areas of the same size
+ *
+ * Function pointers are called through volatile variables, so the compiler can't inline the C library functions as
+ * builtins and both implementations are measured in the same way.
+ */
+static uint32_t bench_mem_run(BENCH_MEM_OP_T op, bool use_libc, uint8_t *dst, const uint8_t *src, uint32_t size,
+			      uint32_t repeat)
+{
+	void *(*volatile copy)(void *, const void *, size_t) = use_libc ? BENCH_LIBC_MEMCPY : mem_copy;
+	void *(*volatile move)(void *, const void *, size_t) = use_libc ? BENCH_LIBC_MEMMOVE : mem_move;
+	void *(*volatile set)(void *, int, size_t) = use_libc ? BENCH_LIBC_MEMSET : mem_set;
+	int (*volatile compare)(const void *, const void *, size_t) = use_libc ? BENCH_LIBC_MEMCMP : mem_compare;
+	uint32_t start = DWT->CYCCNT;
+
+	for (uint32_t idx = 0; idx < repeat; idx++) {
+		switch (op) {
+		case BENCH_MEM_COPY:
+			copy(dst, src, size);
+			break;
+		case BENCH_MEM_MOVE:
+			move(dst, src, size);
+			break;
+		case BENCH_MEM_SET:
+			set(dst, 0x5A, size);
+			break;
+		case BENCH_MEM_COMPARE:
+			(void)compare(dst, src, size);
+			break;
+		}
+	}
+
+	return DWT->CYCCNT - start;
+}
+
+/* @brief Print throughput in bytes per cycle with two decimal places, without floating point printf support */
+static void bench_mem_report(const char *name, uint32_t size, uint32_t repeat, uint32_t cycles,
+			     uint32_t libc_cycles)
+{
+	uint64_t bytes = (uint64_t)size * repeat;
+	uint32_t centi_bytes = (cycles != 0) ? (uint32_t)((bytes * 100) / cycles) : 0;
+	uint32_t libc_centi_bytes = (libc_cycles != 0) ? (uint32_t)((bytes * 100) / libc_cycles) : 0;
+
+	printf("%s %4lu B: %lu.%02lu B/cycle, newlib %lu.%02lu B/cycle\r\n", name, size, centi_bytes / 100,
+	       centi_bytes % 100, libc_centi_bytes / 100, libc_centi_bytes % 100);
+}
+
+static void bench_mem_op(BENCH_MEM_OP_T op, const char *name, uint32_t dst_offset, uint32_t src_offset)
+{
+	for (uint32_t idx = 0; idx < ARRAY_SIZE(m_sizes); idx++) {
+		uint32_t size = m_sizes[idx];
+		uint32_t repeat = BENCH_MEM_BYTES_PER_SIZE / size;
+		uint8_t *dst = &m_dst[dst_offset];
+		/* Move is measured on overlapping areas, the copy direction depends on order of the offsets */
+		const uint8_t *src = (op == BENCH_MEM_MOVE) ? &m_dst[src_offset] : &m_src[src_offset];
+
+		/* Equal areas are the worst case of compare, all bytes are read */
+		if (op != BENCH_MEM_MOVE) {
+			mem_copy(dst, src, size);
+		}
+
+		uint32_t cycles = bench_mem_run(op, false, dst, src, size, repeat);
+		uint32_t libc_cycles = bench_mem_run(op, true, dst, src, size, repeat);
+
+		bench_mem_report(name, size, repeat, cycles, libc_cycles);
+	}
+}
+
+void bench_mem()
+{
+	for (uint32_t idx = 0; idx < sizeof(m_src); idx++) {
+		m_src[idx] = (uint8_t)idx;
+	}
+
+	bench_mem_op(BENCH_MEM_COPY, "memcpy aligned", 0, 0);
+	bench_mem_op(BENCH_MEM_COPY, "memcpy misaligned", 0, 1);
+	bench_mem_op(BENCH_MEM_MOVE, "memmove forward", 0, 4);
+	bench_mem_op(BENCH_MEM_MOVE, "memmove backward", 4, 0);
+	bench_mem_op(BENCH_MEM_MOVE, "memmove forward misaligned", 0, 1);
+	bench_mem_op(BENCH_MEM_MOVE, "memmove backward misaligned", 1, 0);
+	bench_mem_op(BENCH_MEM_SET, "memset aligned", 0, 0);
+	bench_mem_op(BENCH_MEM_SET, "memset misaligned", 3, 0);
+	bench_mem_op(BENCH_MEM_COMPARE, "memcmp aligned", 0, 0);
+	bench_mem_op(BENCH_MEM_COMPARE, "memcmp misaligned", 0, 2);
+}
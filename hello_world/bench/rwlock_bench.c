@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <drivers/nrfx_common.h>
+
+#include "bench.h"
+#include "sys/rwlock.h"
+#include "sys/spin_lock.h"
+#include "sys/thread.h"
+#include "tools/misc.h"
+
+#define BENCH_RWLOCK_ITERATIONS 10000
+/* Reader threads use thread objects from the pool, leave enough of those for main() */
+#define BENCH_RWLOCK_READERS 2
+#define BENCH_RWLOCK_TABLE_SIZE 16
+
+/* Stand-in for configuration data that is read on every packet */
+static uint32_t m_table[BENCH_RWLOCK_TABLE_SIZE];
+
+static rwlock_t m_rwlock;
+static spin_lock_t m_spin_lock = { .lock = SPIN_LOCK_UNLOCKED };
+
+/* Both phases of concurrent benchmark are timed by cycle counter, so readers don't need any kernel call to check
+ * if a phase is done.
+ */
+static uint32_t m_rwlock_phase_end;
+static uint32_t m_spin_phase_end;
+static volatile uint32_t m_rwlock_reads[BENCH_RWLOCK_READERS];
+static volatile uint32_t m_spin_reads[BENCH_RWLOCK_READERS];
+
+THREAD_STACK_STATIC(bench_reader_0, THREAD_STACK_SIZE);
+THREAD_STACK_STATIC(bench_reader_1, THREAD_STACK_SIZE);
+
+static uint8_t *const m_reader_stack[BENCH_RWLOCK_READERS] = {
+	stack_bench_reader_0,
+	stack_bench_reader_1,
+};
+
+static uint32_t bench_table_read()
+{
+	uint32_t sum = 0;
+
+	for (int idx = 0; idx < BENCH_RWLOCK_TABLE_SIZE; idx++) {
+		sum += m_table[idx];
+	}
+
+	return sum;
+}
+
+static bool bench_phase_running(uint32_t phase_end)
+{
+	/* Signed difference handles cycle counter wrap */
+	return (int32_t)(DWT->CYCCNT - phase_end) < 0;
+}
+
+static void bench_reader(void *arg)
+{
+	uint32_t reader = (uint32_t)arg;
+	volatile uint32_t sum;
+
+	while (bench_phase_running(m_rwlock_phase_end)) {
+		rwlock_read_lock(&m_rwlock);
+		sum = bench_table_read();
+		rwlock_read_unlock(&m_rwlock);
+
+		m_rwlock_reads[reader]++;
+	}
+
+	while (bench_phase_running(m_spin_phase_end)) {
+		spin_lock(&m_spin_lock);
+		sum = bench_table_read();
+		spin_unlock(&m_spin_lock);
+
+		m_spin_reads[reader]++;
+	}
+
+	(void)sum;
+}
+
+/* @brief Measure cost of uncontended lock and unlock */
+static void bench_rwlock_uncontended()
+{
+	uint32_t start;
+	uint32_t flags;
+
+	start = DWT->CYCCNT;
+	for (int idx = 0; idx < BENCH_RWLOCK_ITERATIONS; idx++) {
+		rwlock_read_lock(&m_rwlock);
+		rwlock_read_unlock(&m_rwlock);
+	}
+	bench_report("rwlock read lock/unlock", BENCH_RWLOCK_ITERATIONS, DWT->CYCCNT - start);
+
+	start = DWT->CYCCNT;
+	for (int idx = 0; idx < BENCH_RWLOCK_ITERATIONS; idx++) {
+		rwlock_write_lock(&m_rwlock);
+		rwlock_write_unlock(&m_rwlock);
+	}
+	bench_report("rwlock write lock/unlock", BENCH_RWLOCK_ITERATIONS, DWT->CYCCNT - start);
+
+	start = DWT->CYCCNT;
+	for (int idx = 0; idx < BENCH_RWLOCK_ITERATIONS; idx++) {
+		spin_lock(&m_spin_lock);
+		spin_unlock(&m_spin_lock);
+	}
+	bench_report("spin_lock lock/unlock", BENCH_RWLOCK_ITERATIONS, DWT->CYCCNT - start);
+
+	start = DWT->CYCCNT;
+	for (int idx = 0; idx < BENCH_RWLOCK_ITERATIONS; idx++) {
+		flags = spin_lock_irq_store(&m_spin_lock);
+		spin_unlock_irq_restore(&m_spin_lock, flags);
+	}
+	bench_report("spin_lock_irq_store lock/unlock", BENCH_RWLOCK_ITERATIONS,
+		     DWT->CYCCNT - start);
+}
+
+/* @brief Count read sections done by concurrent readers in the same time for both locks
+ *
+ * Readers are preempted by the round-robin scheduler. A reader preempted inside a spin lock section blocks all
+ * other readers until it is scheduled again, while rwlock readers proceed.
+ */
+static void bench_rwlock_concurrent()
+{
+	thread_t *readers[BENCH_RWLOCK_READERS];
+	uint32_t rwlock_total = 0;
+	uint32_t spin_total = 0;
+
+	m_rwlock_phase_end = DWT->CYCCNT + SystemCoreClock;
+	m_spin_phase_end = m_rwlock_phase_end + SystemCoreClock;
+
+	for (uint32_t idx = 0; idx < BENCH_RWLOCK_READERS; idx++) {
+		thread_create_arg(&readers[idx], bench_reader, (void *)idx, m_reader_stack[idx],
+				  THREAD_STACK_SIZE);
+	}
+
+	for (uint32_t idx = 0; idx < BENCH_RWLOCK_READERS; idx++) {
+		thread_join(readers[idx]);
+
+		rwlock_total += m_rwlock_reads[idx];
+		spin_total += m_spin_reads[idx];
+	}
+
+	printf("%d readers in 1 s: rwlock %lu reads, spin_lock %lu reads\r\n", BENCH_RWLOCK_READERS,
+	       rwlock_total, spin_total);
+}
+
+void bench_rwlock()
+{
+	for (int idx = 0; idx < BENCH_RWLOCK_TABLE_SIZE; idx++) {
+		m_table[idx] = idx;
+	}
+
+	rwlock_init(&m_rwlock);
+
+	bench_rwlock_uncontended();
+	bench_rwlock_concurrent();
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <drivers/nrfx_common.h>
+
+#include "bench.h"
+#include "sys/thread.h"
+
+#define BENCH_THREAD_ITERATIONS 1000
+/* Workers use thread objects from the pool, leave enough of those for main() */
+#define BENCH_THREAD_WORKERS 2
+
+static volatile uint32_t m_worker_runs;
+
+THREAD_STACK_STATIC(bench_worker_0, THREAD_STACK_SIZE);
+THREAD_STACK_STATIC(bench_worker_1, THREAD_STACK_SIZE);
+
+static uint8_t *const m_worker_stack[BENCH_THREAD_WORKERS] = {
+	stack_bench_worker_0,
+	stack_bench_worker_1,
+};
+
+/* Stand-in for a short request handled by a dedicated thread */
+static void bench_worker(void *arg)
+{
+	(void)arg;
+
+	m_worker_runs++;
+}
+
+/* @brief Measure a full life of a short-lived thread: create, run, end, join and reclaim of its thread object
+ *
+ * The same stack is used again as soon as join returns, because the ended thread has been switched out by then.
+ */
+static void bench_thread_churn_single()
+{
+	thread_t *worker;
+	uint32_t failed = 0;
+	uint32_t start;
+
+	m_worker_runs = 0;
+
+	start = DWT->CYCCNT;
+	for (int idx = 0; idx < BENCH_THREAD_ITERATIONS; idx++) {
+		if (thread_create_arg(&worker, bench_worker, NULL, m_worker_stack[0],
+				      THREAD_STACK_SIZE) != 0) {
+			failed++;
+			continue;
+		}
+
+		thread_join(worker);
+	}
+	bench_report("thread create/exit/join", BENCH_THREAD_ITERATIONS, DWT->CYCCNT - start);
+
+	printf("thread churn: %lu runs, %lu create failures\r\n", m_worker_runs, failed);
+}
+
+/* @brief Measure throughput of thread objects reuse when more than one short-lived thread is alive at once */
+static void bench_thread_churn_batch()
+{
+	thread_t *workers[BENCH_THREAD_WORKERS];
+	uint32_t failed = 0;
+	uint32_t start;
+
+	m_worker_runs = 0;
+
+	start = DWT->CYCCNT;
+	for (int idx = 0; idx < BENCH_THREAD_ITERATIONS; idx++) {
+		for (int worker = 0; worker < BENCH_THREAD_WORKERS; worker++) {
+			if (thread_create_arg(&workers[worker], bench_worker, NULL,
+					      m_worker_stack[worker], THREAD_STACK_SIZE) != 0) {
+				workers[worker] = NULL;
+				failed++;
+			}
+		}
+
+		for (int worker = 0; worker < BENCH_THREAD_WORKERS; worker++) {
+			if (workers[worker] != NULL) {
+				thread_join(workers[worker]);
+			}
+		}
+	}
+	bench_report("thread create/exit/join batch", BENCH_THREAD_ITERATIONS * BENCH_THREAD_WORKERS,
+		     DWT->CYCCNT - start);
+
+	printf("thread batch churn: %lu runs, %lu create failures\r\n", m_worker_runs, failed);
+}
+
+void bench_thread()
+{
+	bench_thread_churn_single();
+	bench_thread_churn_batch();
+}
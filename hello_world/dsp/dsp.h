@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __DSP_DSP_H__
+#define __DSP_DSP_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/** @file Signal processing kernels.
+ *
+ * Fixed point kernels work on pairs of q15 samples with Cortex-M4 SIMD instructions (SMLALD, QADD16, SSAT). On CPUs
+ * without DSP extension, e.g. on host for unit tests, the instructions are emulated in C, so the same code is
+ * exercised. Floating point kernels use single precision FPU.
+ *
+ * Each kernel has a plain scalar implementation with _scalar suffix. Those are the reference for unit tests and
+ * benchmarks, results of both implementations are bit-exact.
+ *
+ * Sample buffers need 2 byte alignment only. Kernels are not thread safe, filter objects must not be shared.
+ */
+
+/* Fixed point Q1.15 number, range [-1, 1) */
+typedef int16_t q15_t;
+/* Fixed point Q1.31 number, range [-1, 1) */
+typedef int32_t q31_t;
+
+/* Q1.15 FIR filter */
+typedef struct dsp_fir_q15 {
+	/* Coefficients in time-reversed order, coeffs[taps - 1] multiplies the newest sample */
+	const q15_t *coeffs;
+	/* Delay line, taps - 1 + block_size_max samples */
+	q15_t *state;
+	uint16_t taps;
+	uint32_t block_size_max;
+} dsp_fir_q15_t;
+
+/* Cascade of single precision biquad filters in direct form II transposed */
+typedef struct dsp_biquad_f32 {
+	/* Five coefficients per stage: b0, b1, b2, a1, a2. The transfer function of a stage is
+	 * (b0 + b1 z^-1 + b2 z^-2) / (1 + a1 z^-1 + a2 z^-2).
+	 */
+	const float *coeffs;
+	/* Two state variables per stage */
+	float *state;
+	uint8_t stages;
+} dsp_biquad_f32_t;
+
+/* Statistics of a block of samples */
+typedef struct dsp_stats_q15 {
+	q15_t min;
+	q15_t max;
+	/* Mean rounded toward zero */
+	q15_t mean;
+	/* Root mean square rounded down, saturated to the largest q15 value */
+	q15_t rms;
+} dsp_stats_q15_t;
+
+/* @brief Dot product of q15 vectors
+ *
+ * @return Sum of products in Q2.30 format, in 64 bits so it doesn't overflow
+ */
+int64_t dsp_dot_q15(const q15_t *a, const q15_t *b, uint32_t size);
+
+/* @brief Add q15 vectors element-wise with saturation, dst may be the same as a or b */
+void dsp_add_q15(const q15_t *a, const q15_t *b, q15_t *dst, uint32_t size);
+
+/* @brief Convert q15 samples to q31, the conversion is exact */
+void dsp_q15_to_q31(const q15_t *src, q31_t *dst, uint32_t size);
+
+/* @brief Convert q31 samples to q15, lower 16 bits are dropped (rounding toward minus infinity) */
+void dsp_q31_to_q15(const q31_t *src, q15_t *dst, uint32_t size);
+
+/* @brief Convert float samples to q15, rounded to nearest and saturated to the q15 range */
+void dsp_f32_to_q15(const float *src, q15_t *dst, uint32_t size);
+
+/* @brief Convert q15 samples to float, the conversion is exact */
+void dsp_q15_to_f32(const q15_t *src, float *dst, uint32_t size);
+
+/* @brief Initialize a FIR filter, the delay line is cleared
+ *
+ * @param fir Pointer to a filter object
+ * @param coeffs Coefficients in time-reversed order, kept by the filter
+ * @param taps Number of coefficients
+ * @param state Delay line buffer of taps - 1 + block_size_max samples
+ * @param block_size_max Maximum number of samples processed by single dsp_fir_q15() call
+ */
+void dsp_fir_q15_init(dsp_fir_q15_t *fir, const q15_t *coeffs, uint16_t taps, q15_t *state,
+		      uint32_t block_size_max);
+
+/* @brief Filter a block of samples
+ *
+ * Products are accumulated in 64 bits, the result is shifted to q15 and saturated.
+ *
+ * @param fir Pointer to a filter object
+ * @param src Input samples
+ * @param dst Output samples, may not be the same as src
+ * @param block_size Number of samples, not more than block_size_max
+ */
+void dsp_fir_q15(dsp_fir_q15_t *fir, const q15_t *src, q15_t *dst, uint32_t block_size);
+
+/* @brief Initialize a biquad cascade, state is cleared
+ *
+ * @param biquad Pointer to a filter object
+ * @param coeffs Five coefficients per stage, kept by the filter
+ * @param state State buffer of two values per stage
+ * @param stages Number of stages
+ */
+void dsp_biquad_f32_init(dsp_biquad_f32_t *biquad, const float *coeffs, float *state, uint8_t stages);
+
+/* @brief Filter a block of samples, src and dst may be the same buffer */
+void dsp_biquad_f32(dsp_biquad_f32_t *biquad, const float *src, float *dst, uint32_t block_size);
+
+/* @brief Compute statistics of a block of samples, size must not be zero */
+void dsp_stats_q15(const q15_t *src, uint32_t size, dsp_stats_q15_t *stats);
+
+/* Reference scalar implementations, see the kernels above */
+int64_t dsp_dot_q15_scalar(const q15_t *a, const q15_t *b, uint32_t size);
+void dsp_add_q15_scalar(const q15_t *a, const q15_t *b, q15_t *dst, uint32_t size);
+void dsp_fir_q15_scalar(dsp_fir_q15_t *fir, const q15_t *src, q15_t *dst, uint32_t block_size);
+void dsp_biquad_f32_scalar(dsp_biquad_f32_t *biquad, const float *src, float *dst, uint32_t block_size);
+void dsp_stats_q15_scalar(const q15_t *src, uint32_t size, dsp_stats_q15_t *stats);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __DSP_DSP_H__ */
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "dsp.h"
+#include "simd.h"
+
+void dsp_fir_q15_init(dsp_fir_q15_t *fir, const q15_t *coeffs, uint16_t taps, q15_t *state,
+		      uint32_t block_size_max)
+{
+	assert(fir);
+	assert(coeffs);
+	assert(state);
+	assert(taps != 0);
+
+	fir->coeffs = coeffs;
+	fir->state = state;
+	fir->taps = taps;
+	fir->block_size_max = block_size_max;
+
+	memset(state, 0, (taps - 1 + block_size_max) * sizeof(q15_t));
+}
+
+void dsp_fir_q15(dsp_fir_q15_t *fir, const q15_t *src, q15_t *dst, uint32_t block_size)
+{
+	assert(fir);
+	assert(block_size <= fir->block_size_max);
+
+	uint32_t history = fir->taps - 1;
+
+	/* New samples follow history in the delay line, so the window of each output is contiguous in memory */
+	memcpy(&fir->state[history], src, block_size * sizeof(q15_t));
+
+	for (uint32_t idx = 0; idx < block_size; idx++) {
+		dst[idx] = dsp_q30_to_q15_sat(dsp_dot_q15(fir->coeffs, &fir->state[idx], fir->taps));
+	}
+
+	memmove(fir->state, &fir->state[block_size], history * sizeof(q15_t));
+}
+
+void dsp_fir_q15_scalar(dsp_fir_q15_t *fir, const q15_t *src, q15_t *dst, uint32_t block_size)
+{
+	assert(fir);
+	assert(block_size <= fir->block_size_max);
+
+	uint32_t history = fir->taps - 1;
+
+	for (uint32_t idx = 0; idx < block_size; idx++) {
+		fir->state[history + idx] = src[idx];
+	}
+
+	for (uint32_t idx = 0; idx < block_size; idx++) {
+		int64_t acc = 0;
+
+		for (uint32_t tap = 0; tap < fir->taps; tap++) {
+			acc += (int32_t)fir->coeffs[tap] * fir->state[idx + tap];
+		}
+
+		acc >>= 15;
+		dst[idx] = (q15_t)((acc > INT16_MAX) ? INT16_MAX : ((acc < INT16_MIN) ? INT16_MIN : acc));
+	}
+
+	for (uint32_t idx = 0; idx < history; idx++) {
+		fir->state[idx] = fir->state[block_size + idx];
+	}
+}
+
+void dsp_biquad_f32_init(dsp_biquad_f32_t *biquad, const float *coeffs, float *state, uint8_t stages)
+{
+	assert(biquad);
+	assert(coeffs);
+	assert(state);
+
+	biquad->coeffs = coeffs;
+	biquad->state = state;
+	biquad->stages = stages;
+
+	memset(state, 0, 2 * stages * sizeof(float));
+}
+
+void dsp_biquad_f32(dsp_biquad_f32_t *biquad, const float *src, float *dst, uint32_t block_size)
+{
+	assert(biquad);
+
+	const float *coeffs = biquad->coeffs;
+	float *state = biquad->state;
+
+	/* Whole block goes through one stage at a time, so coefficients and state of the stage stay in FPU registers
+	 * instead of being reloaded for every sample.
+	 */
+	for (uint8_t stage = 0; stage < biquad->stages; stage++) {
+		float b0 = coeffs[0];
+		float b1 = coeffs[1];
+		float b2 = coeffs[2];
+		float a1 = coeffs[3];
+		float a2 = coeffs[4];
+		float d1 = state[0];
+		float d2 = state[1];
+		const float *in = src;
+
+		for (uint32_t idx = 0; idx < block_size; idx++) {
+			float x = in[idx];
+			float y = b0 * x + d1;
+
+			d1 = b1 * x - a1 * y + d2;
+			d2 = b2 * x - a2 * y;
+			dst[idx] = y;
+		}
+
+		state[0] = d1;
+		state[1] = d2;
+
+		/* Next stages work in place on the output */
+		src = dst;
+		coeffs += 5;
+		state += 2;
+	}
+}
+
+void dsp_biquad_f32_scalar(dsp_biquad_f32_t *biquad, const float *src, float *dst, uint32_t block_size)
+{
+	assert(biquad);
+
+	/* Each sample goes through all stages, state is kept in memory */
+	for (uint32_t idx = 0; idx < block_size; idx++) {
+		float sample = src[idx];
+
+		for (uint8_t stage = 0; stage < biquad->stages; stage++) {
+			const float *coeffs = &biquad->coeffs[stage * 5];
+			float *state = &biquad->state[stage * 2];
+			float y = coeffs[0] * sample + state[0];
+
+			state[0] = coeffs[1] * sample - coeffs[3] * y + state[1];
+			state[1] = coeffs[2] * sample - coeffs[4] * y;
+			sample = y;
+		}
+
+		dst[idx] = sample;
+	}
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __DSP_SIMD_H__
+#define __DSP_SIMD_H__
+
+#include <stdint.h>
+
+#include "dsp.h"
+
+/** @file SIMD instructions used by DSP kernels, internal to dsp module.
+ *
+ * A pair of q15 samples is kept in a 32 bit word, the first sample in the lower half, as it is stored in memory by
+ * little-endian CPU. On Cortex-M4 the functions map to single instructions via CMSIS intrinsics, elsewhere those
+ * are emulated with the same results.
+ */
+
+#if defined(__ARM_FEATURE_DSP)
+#include <drivers/nrfx_common.h>
+#define DSP_SIMD_ENABLED 1
+#endif /* __ARM_FEATURE_DSP */
+
+/* Pair of q15 samples that may be accessed at any 2 byte aligned address */
+typedef struct {
+	uint32_t value;
+} __attribute__((packed, may_alias)) dsp_q15_pair_t;
+
+static inline uint32_t dsp_pair_load(const q15_t *src)
+{
+	return ((const dsp_q15_pair_t *)src)->value;
+}
+
+static inline void dsp_pair_store(q15_t *dst, uint32_t pair)
+{
+	((dsp_q15_pair_t *)dst)->value = pair;
+}
+
+static inline int32_t dsp_pair_low(uint32_t pair)
+{
+	return (int16_t)(pair & 0xFFFF);
+}
+
+static inline int32_t dsp_pair_high(uint32_t pair)
+{
+	return (int16_t)(pair >> 16);
+}
+
+#ifdef DSP_SIMD_ENABLED
+/* @brief Add products of lower and upper halves to 64 bit accumulator */
+static inline int64_t dsp_smlald(uint32_t a, uint32_t b, int64_t acc)
+{
+	return (int64_t)__SMLALD(a, b, (uint64_t)acc);
+}
+
+/* @brief Add halves with saturation to q15 range */
+static inline uint32_t dsp_qadd16(uint32_t a, uint32_t b)
+{
+	return __QADD16(a, b);
+}
+
+/* @brief Saturate to q15 range */
+static inline int32_t dsp_ssat16(int32_t value)
+{
+	return __SSAT(value, 16);
+}
+#else
+static inline int64_t dsp_smlald(uint32_t a, uint32_t b, int64_t acc)
+{
+	return acc + dsp_pair_low(a) * dsp_pair_low(b) + dsp_pair_high(a) * dsp_pair_high(b);
+}
+
+static inline int32_t dsp_ssat16(int32_t value)
+{
+	return (value > INT16_MAX) ? INT16_MAX : ((value < INT16_MIN) ? INT16_MIN : value);
+}
+
+static inline uint32_t dsp_qadd16(uint32_t a, uint32_t b)
+{
+	uint32_t low = (uint16_t)dsp_ssat16(dsp_pair_low(a) + dsp_pair_low(b));
+	uint32_t high = (uint16_t)dsp_ssat16(dsp_pair_high(a) + dsp_pair_high(b));
+
+	return low | (high << 16);
+}
+#endif /* DSP_SIMD_ENABLED */
+
+/* @brief Convert 64 bit Q2.30 accumulator to q15 with saturation */
+static inline q15_t dsp_q30_to_q15_sat(int64_t acc)
+{
+	int64_t value = acc >> 15;
+
+	/* Sum of many products may not fit in 32 bits, SSAT handles the common case */
+	if (value > INT32_MAX) {
+		value = INT32_MAX;
+	} else if (value < INT32_MIN) {
+		value = INT32_MIN;
+	}
+
+	return (q15_t)dsp_ssat16((int32_t)value);
+}
+
+#endif /* __DSP_SIMD_H__ */
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <assert.h>
+#include <stdint.h>
+
+#include "dsp.h"
+#include "simd.h"
+
+/* Both halves are one, SMLALD with it adds the pair of samples */
+#define DSP_PAIR_ONES 0x00010001UL
+
+/* @brief Integer square root rounded down, bit by bit, so it is exact and doesn't need FPU */
+static uint32_t dsp_isqrt64(uint64_t value)
+{
+	uint64_t root = 0;
+	uint64_t bit = 1ULL << 62;
+
+	while (bit > value) {
+		bit >>= 2;
+	}
+
+	while (bit != 0) {
+		if (value >= root + bit) {
+			value -= root + bit;
+			root = (root >> 1) + bit;
+		} else {
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+
+	return (uint32_t)root;
+}
+
+/* @brief Fill mean and rms from sum and sum of squares, shared with scalar version to get the same rounding */
+static void dsp_stats_q15_finish(dsp_stats_q15_t *stats, int64_t sum, int64_t sum_squares, uint32_t size)
+{
+	uint32_t rms = dsp_isqrt64((uint64_t)sum_squares / size);
+
+	stats->mean = (q15_t)(sum / (int64_t)size);
+	/* RMS of a block of -1 values is 1, that isn't a q15 value */
+	stats->rms = (q15_t)((rms > INT16_MAX) ? INT16_MAX : rms);
+}
+
+void dsp_stats_q15(const q15_t *src, uint32_t size, dsp_stats_q15_t *stats)
+{
+	assert(src);
+	assert(stats);
+	assert(size != 0);
+
+	uint32_t remaining = size;
+	int64_t sum = 0;
+	int64_t sum_squares = 0;
+	int32_t min = INT16_MAX;
+	int32_t max = INT16_MIN;
+
+	while (remaining >= 2) {
+		uint32_t pair = dsp_pair_load(src);
+		int32_t low = dsp_pair_low(pair);
+		int32_t high = dsp_pair_high(pair);
+
+		sum = dsp_smlald(pair, DSP_PAIR_ONES, sum);
+		sum_squares = dsp_smlald(pair, pair, sum_squares);
+
+		if (low < min) {
+			min = low;
+		}
+		if (high < min) {
+			min = high;
+		}
+		if (low > max) {
+			max = low;
+		}
+		if (high > max) {
+			max = high;
+		}
+
+		src += 2;
+		remaining -= 2;
+	}
+
+	if (remaining != 0) {
+		sum += *src;
+		sum_squares += (int32_t)*src * *src;
+
+		if (*src < min) {
+			min = *src;
+		}
+		if (*src > max) {
+			max = *src;
+		}
+	}
+
+	stats->min = (q15_t)min;
+	stats->max = (q15_t)max;
+	dsp_stats_q15_finish(stats, sum, sum_squares, size);
+}
+
+void dsp_stats_q15_scalar(const q15_t *src, uint32_t size, dsp_stats_q15_t *stats)
+{
+	assert(src);
+	assert(stats);
+	assert(size != 0);
+
+	int64_t sum = 0;
+	int64_t sum_squares = 0;
+
+	stats->min = src[0];
+	stats->max = src[0];
+
+	for (uint32_t idx = 0; idx < size; idx++) {
+		sum += src[idx];
+		sum_squares += (int32_t)src[idx] * src[idx];
+
+		if (src[idx] < stats->min) {
+			stats->min = src[idx];
+		}
+		if (src[idx] > stats->max) {
+			stats->max = src[idx];
+		}
+	}
+
+	dsp_stats_q15_finish(stats, sum, sum_squares, size);
+}
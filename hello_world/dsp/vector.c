@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <assert.h>
+#include <stdint.h>
+
+#include "dsp.h"
+#include "simd.h"
+
+int64_t dsp_dot_q15(const q15_t *a, const q15_t *b, uint32_t size)
+{
+	int64_t acc = 0;
+
+	/* Two pairs per iteration, so load latency of one pair is hidden by the multiply of the other */
+	while (size >= 4) {
+		acc = dsp_smlald(dsp_pair_load(a), dsp_pair_load(b), acc);
+		acc = dsp_smlald(dsp_pair_load(a + 2), dsp_pair_load(b + 2), acc);
+		a += 4;
+		b += 4;
+		size -= 4;
+	}
+
+	while (size != 0) {
+		acc += (int32_t)*a++ * *b++;
+		size--;
+	}
+
+	return acc;
+}
+
+int64_t dsp_dot_q15_scalar(const q15_t *a, const q15_t *b, uint32_t size)
+{
+	int64_t acc = 0;
+
+	for (uint32_t idx = 0; idx < size; idx++) {
+		acc += (int32_t)a[idx] * b[idx];
+	}
+
+	return acc;
+}
+
+void dsp_add_q15(const q15_t *a, const q15_t *b, q15_t *dst, uint32_t size)
+{
+	while (size >= 2) {
+		dsp_pair_store(dst, dsp_qadd16(dsp_pair_load(a), dsp_pair_load(b)));
+		a += 2;
+		b += 2;
+		dst += 2;
+		size -= 2;
+	}
+
+	if (size != 0) {
+		*dst = (q15_t)dsp_ssat16(*a + *b);
+	}
+}
+
+void dsp_add_q15_scalar(const q15_t *a, const q15_t *b, q15_t *dst, uint32_t size)
+{
+	for (uint32_t idx = 0; idx < size; idx++) {
+		int32_t sum = a[idx] + b[idx];
+
+		dst[idx] = (q15_t)((sum > INT16_MAX) ? INT16_MAX : ((sum < INT16_MIN) ? INT16_MIN : sum));
+	}
+}
+
+void dsp_q15_to_q31(const q15_t *src, q31_t *dst, uint32_t size)
+{
+	while (size-- != 0) {
+		*dst++ = (q31_t)((uint32_t)*src++ << 16);
+	}
+}
+
+void dsp_q31_to_q15(const q31_t *src, q15_t *dst, uint32_t size)
+{
+	while (size-- != 0) {
+		*dst++ = (q15_t)(*src++ >> 16);
+	}
+}
+
+void dsp_f32_to_q15(const float *src, q15_t *dst, uint32_t size)
+{
+	while (size-- != 0) {
+		float scaled = *src++ * 32768.0f;
+
+		/* Saturate in float, conversion of out of range value to integer is undefined */
+		if (scaled >= (float)INT16_MAX) {
+			*dst++ = INT16_MAX;
+		} else if (scaled <= (float)INT16_MIN) {
+			*dst++ = INT16_MIN;
+		} else {
+			*dst++ = (q15_t)((scaled >= 0.0f) ? (int32_t)(scaled + 0.5f) : (int32_t)(scaled - 0.5f));
+		}
+	}
+}
+
+void dsp_q15_to_f32(const q15_t *src, float *dst, uint32_t size)
+{
+	while (size-- != 0) {
+		*dst++ = (float)*src++ * (1.0f / 32768.0f);
+	}
+}
@@ -17,6 +17,10 @@
 #include "sys/thread.h"
 #include "sys/spin_lock.h"
 
+#ifdef BENCH_ENABLED
+#include "bench/bench.h"
+#endif /* BENCH_ENABLED */
+
 /* TODO check why globals are not cleaned or initialized */
 THREAD_STACK_STATIC(thread1, THREAD_STACK_SIZE);
 THREAD_STACK_STATIC(thread2, THREAD_STACK_SIZE);
@@ -214,6 +218,10 @@ int main(void)
 	/* Needed some debug outputs, so went for uart. */
 	uarte_init();
 
+#ifdef BENCH_ENABLED
+	bench_run();
+#endif /* BENCH_ENABLED */
+
 	memset(stack_thread1, 0xBA, sizeof(stack_thread1));
 	memset(stack_thread2, 0xBA, sizeof(stack_thread2));
 
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdint.h>
+
+#include <drivers/nrfx_common.h>
+
+#include "clock.h"
+#include "isr.h"
+
+#define CLOCK_TIMER NRF_TIMER1
+#define CLOCK_TIMER_IRQn TIMER1_IRQn
+
+/* Compare channels mark start of each half of the counter period, capture channel is used to read the counter */
+#define CLOCK_CC_LOWER_HALF 0
+#define CLOCK_CC_UPPER_HALF 1
+#define CLOCK_CC_CAPTURE 2
+
+#define CLOCK_COUNTER_HALF 0x80000000UL
+
+/* Number of half periods of the counter observed by the ISR.
+ *
+ * Counting halves instead of overflows makes reads lock-free. Parity of the value matches the counter most
+ * significant bit, unless the ISR for the latest half is still pending. A reader that sees a mismatch knows the
+ * ISR lags by one half and corrects the value. The variable is written by the ISR only, 32-bit aligned access is
+ * atomic.
+ */
+static volatile uint32_t m_clock_halves;
+
+ISR_DEFINE(TIMER1_IRQHandler)
+{
+	if (CLOCK_TIMER->EVENTS_COMPARE[CLOCK_CC_LOWER_HALF]) {
+		CLOCK_TIMER->EVENTS_COMPARE[CLOCK_CC_LOWER_HALF] = 0;
+		m_clock_halves++;
+	}
+
+	if (CLOCK_TIMER->EVENTS_COMPARE[CLOCK_CC_UPPER_HALF]) {
+		CLOCK_TIMER->EVENTS_COMPARE[CLOCK_CC_UPPER_HALF] = 0;
+		m_clock_halves++;
+	}
+}
+
+void clock_init()
+{
+	CLOCK_TIMER->TASKS_STOP = 1;
+	CLOCK_TIMER->TASKS_CLEAR = 1;
+
+	CLOCK_TIMER->MODE = TIMER_MODE_MODE_Timer;
+	CLOCK_TIMER->BITMODE = TIMER_BITMODE_BITMODE_32Bit;
+	/* 16 MHz / 2^0 */
+	CLOCK_TIMER->PRESCALER = 0;
+
+	CLOCK_TIMER->CC[CLOCK_CC_LOWER_HALF] = 0;
+	CLOCK_TIMER->CC[CLOCK_CC_UPPER_HALF] = CLOCK_COUNTER_HALF;
+	CLOCK_TIMER->EVENTS_COMPARE[CLOCK_CC_LOWER_HALF] = 0;
+	CLOCK_TIMER->EVENTS_COMPARE[CLOCK_CC_UPPER_HALF] = 0;
+	CLOCK_TIMER->INTENSET = TIMER_INTENSET_COMPARE0_Msk | TIMER_INTENSET_COMPARE1_Msk;
+
+	m_clock_halves = 0;
+
+	/* Highest priority keeps the ISR lag minimal */
+	NVIC_SetPriority(CLOCK_TIMER_IRQn, 0);
+	NVIC_EnableIRQ(CLOCK_TIMER_IRQn);
+
+	CLOCK_TIMER->TASKS_START = 1;
+}
+
+uint64_t clock_cycle_get()
+{
+	/* The order matters: halves count read before the counter may only lag behind it, never be ahead */
+	uint32_t halves = m_clock_halves;
+
+	/* If the capture is interrupted by other context that captures as well, the later value is read. That is
+	 * still a valid time of this call.
+	 */
+	CLOCK_TIMER->TASKS_CAPTURE[CLOCK_CC_CAPTURE] = 1;
+	uint32_t counter = CLOCK_TIMER->CC[CLOCK_CC_CAPTURE];
+
+	uint32_t counter_upper_half = (counter & CLOCK_COUNTER_HALF) ? 1 : 0;
+	if ((halves & 1) != counter_upper_half) {
+		halves++;
+	}
+
+	return ((uint64_t)(halves >> 1) << 32) | counter;
+}
+
+uint64_t clock_uptime_us_get()
+{
+	return clock_cycle_get() / CLOCK_CYCLES_PER_USEC;
+}
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __SYS_CLOCK_H__
+#define __SYS_CLOCK_H__
+
+#include <stdint.h>
+
+/** @file System clock, 64-bit monotonic time since boot.
+ *
+ * The clock is a free running 32-bit TIMER1 at 16 MHz, extended to 64 bits by an overflow epoch counted in the
+ * TIMER1 ISR. The clock may be read from any context without a lock and without disabling interrupts. It is
+ * correct as long as TIMER1 ISR isn't delayed for more than a half of the timer period, that is about 134 s.
+ */
+
+/* Frequency of the clock counter */
+#define CLOCK_CYCLES_PER_SEC 16000000UL
+#define CLOCK_CYCLES_PER_USEC (CLOCK_CYCLES_PER_SEC / 1000000UL)
+
+/* @brief Start the system clock
+ *
+ * Must be called once during system initialization, before the clock is read.
+ */
+void clock_init();
+
+/* @brief Get number of clock cycles since the clock was started
+ *
+ * The function may be called from any context.
+ *
+ * @return Number of 16 MHz clock cycles
+ */
+uint64_t clock_cycle_get();
+
+/* @brief Get time since the clock was started
+ *
+ * The function may be called from any context.
+ *
+ * @return Uptime in microseconds
+ */
+uint64_t clock_uptime_us_get();
+
+#endif /* __SYS_CLOCK_H__ */
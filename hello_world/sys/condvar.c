@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "condvar.h"
+#include "../tools/slist.h"
+
+void condvar_init(condvar_t *cv)
+{
+	assert(cv);
+
+	slist_init(&cv->wait_queue);
+	cv->mutex = NULL;
+}
+
+int condvar_wait(condvar_t *cv, mutex_t *mutex, uint32_t ticks)
+{
+	assert(cv);
+	assert(mutex);
+
+	thread_t *current = sched_current_thread_get();
+	uint32_t flags = sched_lock();
+
+	assert(mutex->owner == current);
+	assert(mutex->lock_count == 1);
+	assert(cv->mutex == NULL || cv->mutex == mutex);
+
+	cv->mutex = mutex;
+
+	/* Release the mutex and pend with scheduler lock held, so there is no window for a lost signal */
+	mutex_handoff_locked(mutex);
+
+	int ret = sched_thread_pend_timeout(&cv->wait_queue, flags, ticks);
+
+	/* A thread moved to the mutex wait queue by broadcast is woken up as the mutex owner. A thread woken up by
+	 * signal or timeout has to lock the mutex on its own.
+	 */
+	if (mutex->owner != current) {
+		mutex_lock(mutex);
+	}
+
+	return ret;
+}
+
+void condvar_signal(condvar_t *cv)
+{
+	assert(cv);
+
+	uint32_t flags = sched_lock();
+
+	sched_thread_wake_one(&cv->wait_queue);
+
+	if (slist_head_peek(&cv->wait_queue) == NULL) {
+		cv->mutex = NULL;
+	}
+
+	sched_unlock(flags);
+}
+
+void condvar_broadcast(condvar_t *cv)
+{
+	assert(cv);
+
+	uint32_t flags = sched_lock();
+	mutex_t *mutex = cv->mutex;
+
+	if (mutex != NULL) {
+		sched_threads_requeue(&cv->wait_queue, &mutex->wait_queue);
+		cv->mutex = NULL;
+
+		/* Nobody is going to unlock the mutex, pass it to the first waiter now */
+		if (mutex->owner == NULL) {
+			mutex_handoff_locked(mutex);
+		}
+	}
+
+	sched_unlock(flags);
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __SYS_CONDVAR_H__
+#define __SYS_CONDVAR_H__
+
+#include <stdint.h>
+
+#include "mutex.h"
+#include "../tools/slist.h"
+
+/** @file Condition variables allow a thread to wait for a predicate on a state guarded by a kernel mutex.
+ *
+ * The mutex is released and the thread pends atomically, so a signal sent after the mutex is released is never
+ * lost. The caller must check the predicate again when condvar_wait() returns.
+ *
+ * condvar_broadcast() doesn't make all waiters ready at once. Those are moved to the mutex wait queue and acquire
+ * the mutex one after another when it is unlocked, so they don't contend for the mutex again.
+ *
+ * All threads that wait on a condition variable at the same time must use the same mutex.
+ */
+
+typedef struct sys_condvar {
+	/* Threads waiting for a signal */
+	slist_t wait_queue;
+	/* Mutex used by waiting threads, NULL if there is no waiting thread */
+	mutex_t *mutex;
+} condvar_t;
+
+/* @brief Initialize a condition variable
+ *
+ * @param cv Pointer to condition variable
+ */
+void condvar_init(condvar_t *cv);
+
+/* @brief Release a mutex and wait for a condition variable to be signalled
+ *
+ * The mutex is locked again before the function returns, also when the timeout expires.
+ *
+ * @param cv Pointer to condition variable
+ * @param mutex Pointer to mutex locked once by the current thread
+ * @param ticks Number of system ticks to wait, SCHED_TIMEOUT_FOREVER or SCHED_TIMEOUT_NO_WAIT
+ *
+ * @return 0 The condition variable was signalled
+ *         -EAGAIN Timeout expired
+ */
+int condvar_wait(condvar_t *cv, mutex_t *mutex, uint32_t ticks);
+
+/* @brief Wake up one thread waiting for a condition variable
+ *
+ * The function may be called with or without the mutex locked, also from ISR.
+ *
+ * @param cv Pointer to condition variable
+ */
+void condvar_signal(condvar_t *cv);
+
+/* @brief Wake up all threads waiting for a condition variable
+ *
+ * Waiting threads are moved to the mutex wait queue. The function may be called with or without the mutex locked,
+ * also from ISR.
+ *
+ * @param cv Pointer to condition variable
+ */
+void condvar_broadcast(condvar_t *cv);
+
+#endif /* __SYS_CONDVAR_H__ */
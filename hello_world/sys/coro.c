@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "coro.h"
+#include "thread.h"
+#include "scheduler.h"
+#include "../tools/coroutine.h"
+#include "../tools/misc.h"
+#include "../tools/slist.h"
+
+#define CORO_OBJECT_GET(coro_node_ptr) CONTAINER_OF(coro_node_ptr, coro_t, node)
+
+/* All coroutine lists are guarded by scheduler lock. That allows to put a coroutine into ready list and wake up its
+ * runner thread from ISR without a race with the runner going to sleep.
+ */
+
+/* @brief Put a coroutine into its runner ready list, must be called with scheduler lock held */
+static void coro_ready_locked(coro_t *coro)
+{
+	coro_runner_t *runner = (coro_runner_t *)coro->runner;
+
+	coro->state = CORO_STATE_READY;
+	coro->node.next = NULL;
+	slist_tail_put(&runner->ready, &coro->node);
+
+	sched_thread_wake_one(&runner->wait_queue);
+}
+
+/* @brief Resume first coroutine from a wait list, must be called with scheduler lock held */
+static void coro_waiter_resume_locked(slist_t *waiters)
+{
+	slist_node_t *coro_node = slist_head_get(waiters);
+
+	if (coro_node != NULL) {
+		coro_ready_locked(CORO_OBJECT_GET(coro_node));
+	}
+}
+
+/* @brief Put a coroutine into a wait list, must be called with scheduler lock held */
+static void coro_wait_locked(slist_t *waiters, coro_t *coro)
+{
+	coro->state = CORO_STATE_WAITING;
+	coro->node.next = NULL;
+	slist_tail_put(waiters, &coro->node);
+}
+
+static void coro_runner_thread(void *arg)
+{
+	coro_runner_t *runner = (coro_runner_t *)arg;
+	slist_node_t *coro_node;
+	uint32_t flags;
+	int result;
+
+	while (1) {
+		flags = sched_lock();
+
+		coro_node = slist_head_get(&runner->ready);
+		if (coro_node == NULL) {
+			/* Lock is released by pend, take it again when woken up */
+			sched_thread_pend(&runner->wait_queue, flags);
+			continue;
+		}
+
+		coro_node->next = NULL;
+
+		coro_t *coro = CORO_OBJECT_GET(coro_node);
+		coro->state = CORO_STATE_RUNNING;
+
+		sched_unlock(flags);
+
+		result = coro->func(coro);
+
+		flags = sched_lock();
+
+		/* A waiting coroutine is already in a wait list. It may be even resumed and put into ready list by ISR,
+		 * before the lock was taken here. Hence only coroutines that are still running are handled.
+		 */
+		if (coro->state == CORO_STATE_RUNNING) {
+			if (result == CORO_YIELDED) {
+				coro->state = CORO_STATE_READY;
+				slist_tail_put(&runner->ready, &coro->node);
+			} else {
+				assert(result == CORO_ENDED);
+				coro->state = CORO_STATE_IDLE;
+			}
+		}
+
+		sched_unlock(flags);
+	}
+}
+
+void coro_runner_init(coro_runner_t *runner)
+{
+	assert(runner);
+
+	slist_init(&runner->ready);
+	slist_init(&runner->wait_queue);
+}
+
+int coro_runner_thread_start(coro_runner_t *runner, thread_t **thread, stack_ptr_t stack_ptr, uint32_t stack_size)
+{
+	assert(runner);
+
+	thread_t *runner_thread;
+	int err = thread_create_arg(&runner_thread, coro_runner_thread, runner, stack_ptr, stack_size);
+
+	if (err == 0 && thread != NULL) {
+		*thread = runner_thread;
+	}
+
+	return err;
+}
+
+void coro_start(coro_runner_t *runner, coro_t *coro, coro_func_t func)
+{
+	assert(runner);
+	assert(coro);
+	assert(func);
+
+	CORO_INIT(coro, func);
+	coro->runner = runner;
+
+	uint32_t flags = sched_lock();
+	coro_ready_locked(coro);
+	sched_unlock(flags);
+}
+
+void coro_sem_init(coro_sem_t *sem, uint32_t count, uint32_t limit)
+{
+	assert(sem);
+	assert(count <= limit);
+
+	sem->count = count;
+	sem->limit = limit;
+	slist_init(&sem->waiters);
+}
+
+void coro_sem_give(coro_sem_t *sem)
+{
+	assert(sem);
+
+	uint32_t flags = sched_lock();
+
+	if (sem->count < sem->limit) {
+		sem->count++;
+	}
+
+	/* Resumed coroutine takes the semaphore when it is executed. In the meantime other coroutine may take it,
+	 * then the resumed one waits again.
+	 */
+	coro_waiter_resume_locked(&sem->waiters);
+
+	sched_unlock(flags);
+}
+
+bool coro_sem_try_take(coro_sem_t *sem, coro_t *coro)
+{
+	assert(sem);
+	assert(coro);
+
+	bool taken = false;
+	uint32_t flags = sched_lock();
+
+	if (sem->count > 0) {
+		sem->count--;
+		taken = true;
+	} else {
+		coro_wait_locked(&sem->waiters, coro);
+	}
+
+	sched_unlock(flags);
+
+	return taken;
+}
+
+void coro_queue_init(coro_queue_t *queue)
+{
+	assert(queue);
+
+	slist_init(&queue->items);
+	slist_init(&queue->waiters);
+}
+
+void coro_queue_put(coro_queue_t *queue, slist_node_t *item)
+{
+	assert(queue);
+	assert(item);
+
+	uint32_t flags = sched_lock();
+
+	item->next = NULL;
+	slist_tail_put(&queue->items, item);
+
+	coro_waiter_resume_locked(&queue->waiters);
+
+	sched_unlock(flags);
+}
+
+slist_node_t *coro_queue_try_get(coro_queue_t *queue, coro_t *coro)
+{
+	assert(queue);
+	assert(coro);
+
+	uint32_t flags = sched_lock();
+
+	slist_node_t *item = slist_head_get(&queue->items);
+	if (item != NULL) {
+		item->next = NULL;
+	} else {
+		coro_wait_locked(&queue->waiters, coro);
+	}
+
+	sched_unlock(flags);
+
+	return item;
+}
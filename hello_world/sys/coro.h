@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __SYS_CORO_H__
+#define __SYS_CORO_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "thread.h"
+#include "../tools/coroutine.h"
+#include "../tools/slist.h"
+
+/** @file Coroutine runner executes many stackless coroutines in a single kernel thread.
+ *
+ * A coroutine costs sizeof(coro_t) plus its own state instead of a thread object and a stack. Coroutines are
+ * scheduled cooperatively in order of readiness. When no coroutine is ready the runner thread pends in scheduler,
+ * so it doesn't use CPU.
+ *
+ * Coroutines may wait for coro_sem_t and coro_queue_t objects. Those objects may be signalled from any context,
+ * including ISR and other threads.
+ */
+
+typedef enum CORO_STATE {
+	/* Coroutine isn't started or has ended */
+	CORO_STATE_IDLE,
+	/* Coroutine is in runner ready list */
+	CORO_STATE_READY,
+	/* Coroutine is executed by runner thread */
+	CORO_STATE_RUNNING,
+	/* Coroutine is in a wait list of an object */
+	CORO_STATE_WAITING,
+} CORO_STATE_T;
+
+typedef struct sys_coro_runner {
+	/* Coroutines ready to be resumed */
+	slist_t ready;
+	/* Runner thread waits here when no coroutine is ready */
+	slist_t wait_queue;
+} coro_runner_t;
+
+typedef struct sys_coro_sem {
+	uint32_t count;
+	uint32_t limit;
+	/* Coroutines waiting for the semaphore */
+	slist_t waiters;
+} coro_sem_t;
+
+typedef struct sys_coro_queue {
+	/* Items are intrusive list nodes, the queue doesn't copy data */
+	slist_t items;
+	/* Coroutines waiting for an item */
+	slist_t waiters;
+} coro_queue_t;
+
+/* @brief Take a semaphore, wait if it isn't available */
+#define CORO_SEM_TAKE(coro, sem) CORO_AWAIT(coro, coro_sem_try_take(sem, coro))
+
+/* @brief Get an item from a queue, wait if the queue is empty
+ *
+ * Mind that item has to be used before next CORO_ macro if it is a local variable, local variables are not
+ * preserved when a coroutine is suspended.
+ */
+#define CORO_QUEUE_GET(coro, queue, item)                                                          \
+	CORO_AWAIT(coro, ((item) = coro_queue_try_get(queue, coro)) != NULL)
+
+/* @brief Initialize a coroutine runner
+ *
+ * @param runner Pointer to coroutine runner
+ */
+void coro_runner_init(coro_runner_t *runner);
+
+/* @brief Create a thread that executes coroutines of a runner
+ *
+ * The runner thread never ends by itself, it may be stopped with thread_abort() when none of its coroutines is
+ * running.
+ *
+ * @param runner Pointer to coroutine runner
+ * @param [out] thread Optional pointer to store the runner thread object
+ * @param stack_ptr Pointer to runner thread stack, it is shared by all coroutines of the runner
+ * @param stack_size Size of the runner thread stack
+ *
+ * @return 0 Runner thread created
+ *         -ENOMEM Not enough memory to allocate new thread object
+ */
+int coro_runner_thread_start(coro_runner_t *runner, thread_t **thread, stack_ptr_t stack_ptr, uint32_t stack_size);
+
+/* @brief Start a coroutine in a runner
+ *
+ * The function may be called from any context.
+ *
+ * @param runner Pointer to coroutine runner
+ * @param coro Pointer to coroutine
+ * @param func Coroutine function
+ */
+void coro_start(coro_runner_t *runner, coro_t *coro, coro_func_t func);
+
+/* @brief Initialize a semaphore
+ *
+ * @param sem Pointer to semaphore
+ * @param count Initial count
+ * @param limit Maximum count
+ */
+void coro_sem_init(coro_sem_t *sem, uint32_t count, uint32_t limit);
+
+/* @brief Give a semaphore and resume a coroutine that waits for it
+ *
+ * The function may be called from any context.
+ *
+ * @param sem Pointer to semaphore
+ */
+void coro_sem_give(coro_sem_t *sem);
+
+/* @brief Try to take a semaphore, if not available put the coroutine into its wait list
+ *
+ * Use CORO_SEM_TAKE() instead of direct call.
+ *
+ * @return true if the semaphore was taken, false if coroutine has to wait
+ */
+bool coro_sem_try_take(coro_sem_t *sem, coro_t *coro);
+
+/* @brief Initialize a queue
+ *
+ * @param queue Pointer to queue
+ */
+void coro_queue_init(coro_queue_t *queue);
+
+/* @brief Put an item into a queue and resume a coroutine that waits for it
+ *
+ * The function may be called from any context.
+ *
+ * @param queue Pointer to queue
+ * @param item Pointer to list node embedded in the item
+ */
+void coro_queue_put(coro_queue_t *queue, slist_node_t *item);
+
+/* @brief Try to get an item from a queue, if empty put the coroutine into its wait list
+ *
+ * Use CORO_QUEUE_GET() instead of direct call.
+ *
+ * @return Pointer to list node of the item, NULL if coroutine has to wait
+ */
+slist_node_t *coro_queue_try_get(coro_queue_t *queue, coro_t *coro);
+
+#endif /* __SYS_CORO_H__ */
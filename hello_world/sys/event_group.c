@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "event_group.h"
+#include "../tools/slist.h"
+
+/* Wait request of a pending thread. It is stored on the waiter stack, it is valid as long as the thread pends. */
+typedef struct {
+	uint32_t events;
+	uint32_t options;
+	/* Set by event_group_set() when the thread is woken up */
+	uint32_t matched;
+} event_group_waiter_t;
+
+/* State of event_group_set() shared by all waiter checks */
+typedef struct {
+	uint32_t events;
+	/* Events to clear after all waiters were checked */
+	uint32_t clear;
+} event_group_set_ctx_t;
+
+/* @brief Check if events satisfy a wait request
+ *
+ * @return Matched events, zero if the wait request isn't satisfied
+ */
+static uint32_t event_group_match(uint32_t events, uint32_t wanted, uint32_t options)
+{
+	uint32_t matched = events & wanted;
+
+	if ((options & EVENT_GROUP_WAIT_ALL) && matched != wanted) {
+		return 0;
+	}
+
+	return matched;
+}
+
+static bool event_group_waiter_match(thread_t *thread, void *arg)
+{
+	event_group_set_ctx_t *ctx = (event_group_set_ctx_t *)arg;
+	event_group_waiter_t *waiter = (event_group_waiter_t *)thread->pend_data;
+
+	uint32_t matched = event_group_match(ctx->events, waiter->events, waiter->options);
+	if (matched == 0) {
+		return false;
+	}
+
+	waiter->matched = matched;
+
+	if (waiter->options & EVENT_GROUP_CLEAR_ON_EXIT) {
+		ctx->clear |= matched;
+	}
+
+	return true;
+}
+
+void event_group_init(event_group_t *group)
+{
+	assert(group);
+
+	group->events = 0;
+	slist_init(&group->wait_queue);
+}
+
+uint32_t event_group_set(event_group_t *group, uint32_t events)
+{
+	assert(group);
+
+	uint32_t flags = sched_lock();
+
+	group->events |= events;
+
+	event_group_set_ctx_t ctx = { .events = group->events, .clear = 0 };
+
+	sched_threads_wake_match(&group->wait_queue, event_group_waiter_match, &ctx);
+
+	group->events &= ~ctx.clear;
+	events = group->events;
+
+	sched_unlock(flags);
+
+	return events;
+}
+
+uint32_t event_group_clear(event_group_t *group, uint32_t events)
+{
+	assert(group);
+
+	uint32_t flags = sched_lock();
+	uint32_t prev = group->events;
+
+	group->events &= ~events;
+
+	sched_unlock(flags);
+
+	return prev;
+}
+
+uint32_t event_group_get(event_group_t *group)
+{
+	assert(group);
+
+	/* Aligned 32 bit read is atomic */
+	return group->events;
+}
+
+int event_group_wait(event_group_t *group, uint32_t events, uint32_t options, uint32_t ticks,
+		     uint32_t *matched)
+{
+	assert(group);
+	assert(events != 0);
+
+	uint32_t flags = sched_lock();
+	uint32_t matched_now = event_group_match(group->events, events, options);
+
+	if (matched_now != 0) {
+		if (options & EVENT_GROUP_CLEAR_ON_EXIT) {
+			group->events &= ~matched_now;
+		}
+
+		sched_unlock(flags);
+
+		if (matched) {
+			*matched = matched_now;
+		}
+
+		return 0;
+	}
+
+	event_group_waiter_t waiter = { .events = events, .options = options, .matched = 0 };
+
+	sched_current_thread_get()->pend_data = &waiter;
+
+	/* Scheduler lock is released by pend */
+	int ret = sched_thread_pend_timeout(&group->wait_queue, flags, ticks);
+
+	if (matched) {
+		*matched = waiter.matched;
+	}
+
+	return ret;
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __SYS_EVENT_GROUP_H__
+#define __SYS_EVENT_GROUP_H__
+
+#include <stdint.h>
+
+#include "thread.h"
+#include "scheduler.h"
+#include "../tools/misc.h"
+#include "../tools/slist.h"
+
+/** @file Event groups allow a thread to wait for any or all of up to 32 events.
+ *
+ * Events are set from any context, including ISR. Waiting threads pend in a scheduler wait queue. A single set
+ * operation wakes all matching threads in one pass with scheduler lock held, so all of them see the same state of
+ * events. Events requested to be cleared on exit are cleared after all waiters were checked.
+ */
+
+/* Wake up when any of requested events is set */
+#define EVENT_GROUP_WAIT_ANY 0
+/* Wake up when all of requested events are set */
+#define EVENT_GROUP_WAIT_ALL BIT(0)
+/* Clear matched events when the wait is satisfied */
+#define EVENT_GROUP_CLEAR_ON_EXIT BIT(1)
+
+typedef struct sys_event_group {
+	uint32_t events;
+	/* Threads waiting for events */
+	slist_t wait_queue;
+} event_group_t;
+
+/* @brief Initialize an event group, all events are cleared
+ *
+ * @param group Pointer to event group
+ */
+void event_group_init(event_group_t *group);
+
+/* @brief Set events and wake up threads that wait for those
+ *
+ * The function may be called from ISR.
+ *
+ * @param group Pointer to event group
+ * @param events Events to set
+ *
+ * @return Events of the group after waiters were woken up and their events cleared
+ */
+uint32_t event_group_set(event_group_t *group, uint32_t events);
+
+/* @brief Clear events
+ *
+ * The function may be called from ISR.
+ *
+ * @param group Pointer to event group
+ * @param events Events to clear
+ *
+ * @return Events of the group before they were cleared
+ */
+uint32_t event_group_clear(event_group_t *group, uint32_t events);
+
+/* @brief Get events that are set
+ *
+ * @param group Pointer to event group
+ *
+ * @return Events of the group
+ */
+uint32_t event_group_get(event_group_t *group);
+
+/* @brief Wait for events
+ *
+ * May be called from ISR with SCHED_TIMEOUT_NO_WAIT only.
+ *
+ * @param group Pointer to event group
+ * @param events Events to wait for, must not be zero
+ * @param options EVENT_GROUP_WAIT_ANY or EVENT_GROUP_WAIT_ALL, optionally with EVENT_GROUP_CLEAR_ON_EXIT
+ * @param ticks Number of system ticks to wait, SCHED_TIMEOUT_FOREVER or SCHED_TIMEOUT_NO_WAIT
+ * @param [out] matched Optional pointer to store events that satisfied the wait
+ *
+ * @return 0 Wait satisfied
+ *         -EAGAIN Timeout expired or events were not set and SCHED_TIMEOUT_NO_WAIT was used
+ */
+int event_group_wait(event_group_t *group, uint32_t events, uint32_t options, uint32_t ticks,
+		     uint32_t *matched);
+
+#endif /* __SYS_EVENT_GROUP_H__ */
@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <malloc.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/reent.h>
+
+#include <drivers/nrfx_common.h>
+
+#include "heap.h"
+#include "mutex.h"
+#include "scheduler.h"
+
+/* Bounds of heap region, provided by the SoC linker script */
+extern uint8_t __HeapBase[];
+extern uint8_t __HeapLimit[];
+
+/* Current end of memory taken by malloc from heap region */
+static uint8_t *m_heap_brk = __HeapBase;
+static uint8_t *m_heap_brk_peak = __HeapBase;
+static uint32_t m_heap_sbrk_failures;
+
+/* Allocation counters, guarded by malloc lock */
+static uint32_t m_heap_live;
+static uint32_t m_heap_live_peak;
+static uint32_t m_heap_alloc_count;
+static uint32_t m_heap_free_count;
+/* Nesting level of wrapped calls, only the outermost call is counted */
+static uint32_t m_heap_call_depth;
+
+static mutex_t m_malloc_mutex;
+
+void *__real__malloc_r(struct _reent *reent, size_t size);
+void __real__free_r(struct _reent *reent, void *ptr);
+void *__real__realloc_r(struct _reent *reent, void *ptr, size_t size);
+void *__real__calloc_r(struct _reent *reent, size_t count, size_t size);
+void *__real__memalign_r(struct _reent *reent, size_t align, size_t size);
+
+/* @brief Extend memory used by malloc, called by newlib with malloc lock held */
+void *_sbrk(ptrdiff_t incr)
+{
+	uint8_t *prev_brk = m_heap_brk;
+
+	/* Compare sizes instead of pointers to avoid overflow of pointer arithmetic */
+	if ((incr > 0 && incr > (__HeapLimit - m_heap_brk)) ||
+	    (incr < 0 && -incr > (m_heap_brk - __HeapBase))) {
+		m_heap_sbrk_failures++;
+		errno = ENOMEM;
+
+		return (void *)-1;
+	}
+
+	m_heap_brk += incr;
+	if (m_heap_brk > m_heap_brk_peak) {
+		m_heap_brk_peak = m_heap_brk;
+	}
+
+	return prev_brk;
+}
+
+/* @brief Lock malloc, newlib calls the lock recursively, e.g. realloc calls malloc */
+void __malloc_lock(struct _reent *reent)
+{
+	(void)reent;
+
+	/* Before scheduler is started there is a single thread only */
+	if (sched_current_thread_get() == NULL) {
+		return;
+	}
+
+	assert(__get_IPSR() == 0);
+
+	mutex_lock(&m_malloc_mutex);
+}
+
+void __malloc_unlock(struct _reent *reent)
+{
+	(void)reent;
+
+	if (sched_current_thread_get() == NULL) {
+		return;
+	}
+
+	mutex_unlock(&m_malloc_mutex);
+}
+
+/* @brief Account a block allocated by the outermost wrapped call, must be called with malloc lock held */
+static void heap_alloc_account(struct _reent *reent, void *ptr)
+{
+	if (ptr == NULL || m_heap_call_depth != 0) {
+		return;
+	}
+
+	m_heap_alloc_count++;
+	m_heap_live += _malloc_usable_size_r(reent, ptr);
+	if (m_heap_live > m_heap_live_peak) {
+		m_heap_live_peak = m_heap_live;
+	}
+}
+
+/* @brief Account a block freed by the outermost wrapped call, must be called with malloc lock held */
+static void heap_free_account(struct _reent *reent, void *ptr)
+{
+	if (ptr == NULL || m_heap_call_depth != 0) {
+		return;
+	}
+
+	m_heap_free_count++;
+	m_heap_live -= _malloc_usable_size_r(reent, ptr);
+}
+
+/* Targets of linker --wrap option, see sys/CMakeLists.txt. Marked as used to survive link time optimization. */
+__attribute__((used)) void *__wrap__malloc_r(struct _reent *reent, size_t size)
+{
+	__malloc_lock(reent);
+
+	m_heap_call_depth++;
+	void *ptr = __real__malloc_r(reent, size);
+	m_heap_call_depth--;
+
+	heap_alloc_account(reent, ptr);
+
+	__malloc_unlock(reent);
+
+	return ptr;
+}
+
+__attribute__((used)) void __wrap__free_r(struct _reent *reent, void *ptr)
+{
+	__malloc_lock(reent);
+
+	heap_free_account(reent, ptr);
+
+	m_heap_call_depth++;
+	__real__free_r(reent, ptr);
+	m_heap_call_depth--;
+
+	__malloc_unlock(reent);
+}
+
+__attribute__((used)) void *__wrap__realloc_r(struct _reent *reent, void *ptr, size_t size)
+{
+	__malloc_lock(reent);
+
+	uint32_t old_size = (ptr != NULL) ? _malloc_usable_size_r(reent, ptr) : 0;
+
+	m_heap_call_depth++;
+	void *new_ptr = __real__realloc_r(reent, ptr, size);
+	m_heap_call_depth--;
+
+	/* Failed realloc leaves the old block untouched */
+	if (m_heap_call_depth == 0 && (new_ptr != NULL || size == 0)) {
+		if (new_ptr != ptr) {
+			/* The old block is already freed, so it is accounted with the size captured before the call */
+			if (ptr != NULL) {
+				m_heap_free_count++;
+				m_heap_live -= old_size;
+			}
+			heap_alloc_account(reent, new_ptr);
+		} else {
+			m_heap_live = m_heap_live - old_size + _malloc_usable_size_r(reent, new_ptr);
+			if (m_heap_live > m_heap_live_peak) {
+				m_heap_live_peak = m_heap_live;
+			}
+		}
+	}
+
+	__malloc_unlock(reent);
+
+	return new_ptr;
+}
+
+__attribute__((used)) void *__wrap__calloc_r(struct _reent *reent, size_t count, size_t size)
+{
+	__malloc_lock(reent);
+
+	m_heap_call_depth++;
+	void *ptr = __real__calloc_r(reent, count, size);
+	m_heap_call_depth--;
+
+	heap_alloc_account(reent, ptr);
+
+	__malloc_unlock(reent);
+
+	return ptr;
+}
+
+__attribute__((used)) void *__wrap__memalign_r(struct _reent *reent, size_t align, size_t size)
+{
+	__malloc_lock(reent);
+
+	m_heap_call_depth++;
+	void *ptr = __real__memalign_r(reent, align, size);
+	m_heap_call_depth--;
+
+	heap_alloc_account(reent, ptr);
+
+	__malloc_unlock(reent);
+
+	return ptr;
+}
+
+void heap_init()
+{
+	mutex_init(&m_malloc_mutex);
+}
+
+void heap_stats_get(heap_stats_t *stats)
+{
+	assert(stats);
+
+	/* mallinfo() takes malloc lock, sbrk values are read with the lock held too to get a consistent snapshot */
+	__malloc_lock(_REENT);
+
+	struct mallinfo info = mallinfo();
+
+	stats->region_size = __HeapLimit - __HeapBase;
+	stats->sbrk_size = m_heap_brk - __HeapBase;
+	stats->sbrk_peak = m_heap_brk_peak - __HeapBase;
+	stats->sbrk_failures = m_heap_sbrk_failures;
+	stats->allocated = info.uordblks;
+	stats->live = m_heap_live;
+	stats->live_peak = m_heap_live_peak;
+	stats->alloc_count = m_heap_alloc_count;
+	stats->free_count = m_heap_free_count;
+	stats->free = info.fordblks;
+	stats->free_chunks = info.ordblks;
+
+	__malloc_unlock(_REENT);
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __SYS_HEAP_H__
+#define __SYS_HEAP_H__
+
+#include <stdint.h>
+
+/** @file C library heap.
+ *
+ * Newlib malloc gets memory from _sbrk(), that is bounded by heap region of the linker script: __HeapBase to
+ * __HeapLimit. Size of the region is set by __HEAP_SIZE in startup code. Malloc is serialized by a kernel mutex, so it
+ * may be used by many threads, but not from ISR.
+ *
+ * Allocations are counted by wrappers of newlib _malloc_r(), _free_r(), _realloc_r(), _calloc_r() and _memalign_r(),
+ * see sys/CMakeLists.txt. Allocations made by newlib functions internally, e.g. by calloc() through malloc(), are
+ * counted once.
+ */
+
+typedef struct sys_heap_stats {
+	/* Size of heap region */
+	uint32_t region_size;
+	/* Memory taken from heap region by malloc */
+	uint32_t sbrk_size;
+	/* The highest value of sbrk_size */
+	uint32_t sbrk_peak;
+	/* Number of requests for memory from heap region that failed due to lack of space */
+	uint32_t sbrk_failures;
+	/* Memory allocated by application, including malloc overhead */
+	uint32_t allocated;
+	/* Usable size of all live allocations */
+	uint32_t live;
+	/* The highest value of live */
+	uint32_t live_peak;
+	/* Number of successful allocations, including realloc() that moved or created a block */
+	uint32_t alloc_count;
+	/* Number of freed blocks, including realloc() that moved or freed a block */
+	uint32_t free_count;
+	/* Memory taken by malloc from heap region, but not allocated by application */
+	uint32_t free;
+	/* Number of free chunks, growing number of free chunks with constant free memory means fragmentation */
+	uint32_t free_chunks;
+} heap_stats_t;
+
+/* @brief Initialize heap
+ *
+ * Must be called during system initialization, before scheduler is started. Malloc may be used before the call, but
+ * it isn't thread safe then.
+ */
+void heap_init();
+
+/* @brief Get heap statistics
+ *
+ * May not be called from ISR.
+ *
+ * @param [out] stats Pointer to store statistics in
+ */
+void heap_stats_get(heap_stats_t *stats);
+
+#endif /* __SYS_HEAP_H__ */
@@ -6,6 +6,8 @@
 
 #include <stdint.h>
 
+#include "isr.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -13,23 +15,72 @@ extern "C" {
 #ifndef __SYS_IRQ_H__
 #define __SYS_IRQ_H__
 
-static void irq_disable()
+/* Functions are always inlined, so return address points to a caller of a function that changes
+ * IRQ state, e.g. caller of spin_lock_irq(). That is reported as a source of the longest IRQ-off
+ * window.
+ */
+#define IRQ_ALWAYS_INLINE static inline __attribute__((always_inline))
+
+#ifdef ISR_STATS_ENABLED
+#define IRQ_OFF_ENTER(flags)                                                                       \
+	do {                                                                                       \
+		if ((flags) == 0) {                                                                \
+			isr_stats_irq_off_enter((uint32_t)__builtin_return_address(0));            \
+		}                                                                                  \
+	} while (0)
+#define IRQ_OFF_EXIT(flags)                                                                        \
+	do {                                                                                       \
+		if ((flags) == 0) {                                                                \
+			isr_stats_irq_off_exit();                                                  \
+		}                                                                                  \
+	} while (0)
+#else
+#define IRQ_OFF_ENTER(flags)                                                                       \
+	do {                                                                                       \
+	} while (0)
+#define IRQ_OFF_EXIT(flags)                                                                        \
+	do {                                                                                       \
+	} while (0)
+#endif /* ISR_STATS_ENABLED */
+
+IRQ_ALWAYS_INLINE uint32_t irq_primask_get()
+{
+	uint32_t flags;
+
+	asm volatile("       mrs     %[flags], primask"
+		     : [flags] "=r"(flags)
+		     : /* no input */
+		     : "memory");
+
+	return flags;
+}
+
+IRQ_ALWAYS_INLINE void irq_disable()
 {
+#ifdef ISR_STATS_ENABLED
+	uint32_t flags = irq_primask_get();
+#endif /* ISR_STATS_ENABLED */
+
 	asm volatile("       cpsid   i"
 		     : /* no output */
 		     : /* no input */
 		     : "memory", "cc");
+
+	IRQ_OFF_ENTER(flags);
 }
 
-static void irq_enable()
+IRQ_ALWAYS_INLINE void irq_enable()
 {
+	/* IRQ-off window end is recorded only if it was started, so there is no need to check PRIMASK */
+	IRQ_OFF_EXIT(0);
+
 	asm volatile("       cpsie   i"
 		     : /* no output */
 		     : /* no input */
 		     : "memory", "cc");
 }
 
-static uint32_t irq_disable_store()
+IRQ_ALWAYS_INLINE uint32_t irq_disable_store()
 {
 	uint32_t flags;
 
@@ -39,11 +90,15 @@ static uint32_t irq_disable_store()
 		     : /* no input */
 		     : "memory", "cc");
 
+	IRQ_OFF_ENTER(flags);
+
 	return flags;
 }
 
-static void irq_enable_restore(uint32_t flags)
+IRQ_ALWAYS_INLINE void irq_enable_restore(uint32_t flags)
 {
+	IRQ_OFF_EXIT(flags);
+
 	asm volatile("       msr     primask, %[flags]"
 		     : /* no output */
 		     : [flags] "r"(flags)
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <drivers/nrfx_common.h>
+
+#include "../tools/misc.h"
+#include "isr.h"
+#include "trace.h"
+
+#ifdef ISR_STATS_ENABLED
+typedef struct {
+	/* Saturating counters, it is enough to see a distribution */
+	uint16_t hist[ISR_STATS_HIST_BUCKETS];
+	uint32_t count;
+	uint32_t max_cycles;
+} isr_stats_t;
+
+static isr_stats_t m_isr_stats[ISR_STATS_EXC_NUM];
+
+/* All IRQ-off data is accessed with interrupts disabled, hence there is no need for a lock */
+static uint32_t m_irq_off_start;
+static uint32_t m_irq_off_pc;
+static bool m_irq_off_active;
+static uint32_t m_irq_off_max_cycles;
+static uint32_t m_irq_off_max_pc;
+
+static uint32_t isr_stats_bucket_get(uint32_t cycles)
+{
+	if (cycles < BIT(ISR_STATS_HIST_SHIFT + 1)) {
+		return 0;
+	}
+
+	/* Index of most significant bit is log2 of cycles */
+	uint32_t bucket = (31 - __CLZ(cycles)) - ISR_STATS_HIST_SHIFT;
+
+	return (bucket < ISR_STATS_HIST_BUCKETS) ? bucket : (ISR_STATS_HIST_BUCKETS - 1);
+}
+
+static void isr_stats_update(uint32_t exc_num, uint32_t cycles)
+{
+	if (exc_num >= ISR_STATS_EXC_NUM) {
+		return;
+	}
+
+	isr_stats_t *stats = &m_isr_stats[exc_num];
+	uint16_t *bucket = &stats->hist[isr_stats_bucket_get(cycles)];
+
+	if (*bucket < UINT16_MAX) {
+		(*bucket)++;
+	}
+
+	stats->count++;
+	if (cycles > stats->max_cycles) {
+		stats->max_cycles = cycles;
+	}
+}
+#endif /* ISR_STATS_ENABLED */
+
+uint32_t isr_enter()
+{
+#ifdef TRACE_ENABLED
+	trace_isr_enter();
+#endif /* TRACE_ENABLED */
+
+	return DWT->CYCCNT;
+}
+
+void isr_exit(uint32_t start)
+{
+#ifdef ISR_STATS_ENABLED
+	/* Nested ISRs of higher priority are included in the duration */
+	uint32_t cycles = DWT->CYCCNT - start;
+	uint32_t flags = __get_PRIMASK();
+
+	__disable_irq();
+	isr_stats_update(__get_IPSR(), cycles);
+	if (flags == 0) {
+		__enable_irq();
+	}
+#endif /* ISR_STATS_ENABLED */
+
+#ifdef TRACE_ENABLED
+	trace_isr_exit();
+#endif /* TRACE_ENABLED */
+}
+
+#ifdef ISR_STATS_ENABLED
+void isr_stats_init()
+{
+	/* Cycle counter is used to measure durations */
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	uint32_t flags = __get_PRIMASK();
+
+	__disable_irq();
+	memset(m_isr_stats, 0, sizeof(m_isr_stats));
+	m_irq_off_max_cycles = 0;
+	m_irq_off_max_pc = 0;
+	if (flags == 0) {
+		__enable_irq();
+	}
+}
+
+void isr_stats_irq_off_enter(uint32_t pc)
+{
+	m_irq_off_start = DWT->CYCCNT;
+	m_irq_off_pc = pc;
+	m_irq_off_active = true;
+}
+
+void isr_stats_irq_off_exit()
+{
+	if (!m_irq_off_active) {
+		return;
+	}
+
+	uint32_t cycles = DWT->CYCCNT - m_irq_off_start;
+
+	if (cycles > m_irq_off_max_cycles) {
+		m_irq_off_max_cycles = cycles;
+		m_irq_off_max_pc = m_irq_off_pc;
+	}
+
+	m_irq_off_active = false;
+}
+
+void isr_stats_dump()
+{
+	isr_stats_t stats;
+	uint32_t irq_off_max_cycles;
+	uint32_t irq_off_max_pc;
+
+	__disable_irq();
+	irq_off_max_cycles = m_irq_off_max_cycles;
+	irq_off_max_pc = m_irq_off_max_pc;
+	__enable_irq();
+
+	printf("IRQ off max: %lu cycles, PC: 0x%08lx\r\n", irq_off_max_cycles, irq_off_max_pc);
+	printf("ISR durations, bucket n: [2^(n+%d), 2^(n+%d+1)) cycles\r\n", ISR_STATS_HIST_SHIFT,
+	       ISR_STATS_HIST_SHIFT);
+
+	for (uint32_t exc_num = 0; exc_num < ISR_STATS_EXC_NUM; exc_num++) {
+		/* Copy with IRQs disabled to print consistent data without blocking IRQs during printf */
+		__disable_irq();
+		stats = m_isr_stats[exc_num];
+		__enable_irq();
+
+		if (stats.count == 0) {
+			continue;
+		}
+
+		printf("EXC %lu: count %lu, max %lu:", exc_num, stats.count, stats.max_cycles);
+		for (uint32_t bucket = 0; bucket < ISR_STATS_HIST_BUCKETS; bucket++) {
+			printf(" %u", stats.hist[bucket]);
+		}
+		printf("\r\n");
+	}
+}
+#endif /* ISR_STATS_ENABLED */
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __SYS_ISR_H__
+#define __SYS_ISR_H__
+
+#include <stdint.h>
+
+/** @file Kernel hooks for interrupt service routines and interrupt latency statistics.
+ *
+ * ISRs defined with ISR_DEFINE() call isr_enter() and isr_exit(). Those feed kernel tracing and, if
+ * ISR_STATS_ENABLED is defined, a histogram of ISR durations per exception number.
+ *
+ * With ISR_STATS_ENABLED all IRQ disable sites in irq.h record the longest window with interrupts
+ * disabled together with PC of the code that disabled interrupts.
+ */
+
+/* Uncomment to enable ISR and IRQ-off statistics. TODO move into KConfig in future */
+/* #define ISR_STATS_ENABLED 1 */
+
+/* Number of exceptions tracked: 16 system exceptions and nRF52833 peripheral interrupts */
+#define ISR_STATS_EXC_NUM (16 + 48)
+
+/* Number of histogram buckets. Bucket n counts durations in range [2^(n + SHIFT), 2^(n + SHIFT + 1))
+ * cycles, first bucket counts also all shorter durations and last bucket all longer ones.
+ */
+#define ISR_STATS_HIST_BUCKETS 16
+#define ISR_STATS_HIST_SHIFT 4
+
+/** @brief Define an ISR that is instrumented by kernel hooks.
+ *
+ * Example:
+ *
+ * ISR_DEFINE(UARTE0_UART0_IRQHandler)
+ * {
+ *      handle_uart();
+ * }
+ *
+ * @param isr_name Name of the ISR, as expected by vector table
+ */
+#define ISR_DEFINE(isr_name)                                                                       \
+	static void isr_name##_body(void);                                                         \
+	void isr_name(void)                                                                        \
+	{                                                                                          \
+		uint32_t isr_start = isr_enter();                                                  \
+		isr_name##_body();                                                                 \
+		isr_exit(isr_start);                                                               \
+	}                                                                                          \
+	static void isr_name##_body(void)
+
+/* @brief Kernel hook called at beginning of an ISR
+ *
+ * @return Timestamp of ISR entry to be passed to isr_exit()
+ */
+uint32_t isr_enter();
+
+/* @brief Kernel hook called at end of an ISR
+ *
+ * @param start Timestamp returned by isr_enter()
+ */
+void isr_exit(uint32_t start);
+
+#ifdef ISR_STATS_ENABLED
+/* @brief Initialize and reset ISR statistics */
+void isr_stats_init();
+
+/* @brief Record begin of a window with interrupts disabled
+ *
+ * Called by irq.h functions only, when interrupts are disabled and were enabled before.
+ *
+ * @param pc Address of code that disabled interrupts
+ */
+void isr_stats_irq_off_enter(uint32_t pc);
+
+/* @brief Record end of a window with interrupts disabled
+ *
+ * Called by irq.h functions only, just before interrupts are enabled.
+ */
+void isr_stats_irq_off_exit();
+
+/* @brief Print ISR statistics with printf, that is sent over UART */
+void isr_stats_dump();
+#endif /* ISR_STATS_ENABLED */
+
+#endif /* __SYS_ISR_H__ */
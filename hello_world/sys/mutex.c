@@ -4,62 +4,78 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <assert.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+
 #include "mutex.h"
 
 void mutex_init(mutex_t *mutex)
 {
-	/* There is an assumption that there is no value store in the mutex hence ordinary store is
-	 * enough. */
-	asm("1:     LDR     r1, =%[lock_const]\n\t"  /* Load MUTEX_LOCKED into r1 */
-	    "       LDREX   r2, [%[lock_value]]\n\t" /* Load-ex value of the mutext stored in memory
-						      */
-	    "       CMP     r1, r2\n\t"		     /* Compare loaded data to lock constant */
-	    "       ITTE    NE\n\t" /* If not locked - then execute next two instructions */
-	    "       STREXNE r2, r1, [%[lock_value]]\n\t" /*      - Store-ex locked value in mutex
-							    memory */
-	    "       CMPNE   r2, #1\n\t" /*      - Check result of store operation. */
-	    "       BEQ     2f\n\t"	/* else
-					 *      - jump to label 2.
-					 */
-	    "       IT      EQ\n\t"	/* Mind that this if-then block refers to CMPNE above,
-					 * the BEQ is an else in former if-then-else.
-					 */
-	    "       BEQ     1b\n\t"
-	    "       DMB\n\t"
-	    "       BX      LR\n\t"
-	    "2:     WFI\n\t"
-	    "       B       1b\n\t"
-	    :
-	    : [lock_const] "i"(MUTEX_LOCKED), [lock_value] "r"(&mutex->lock)
-	    :);
+	assert(mutex);
+
+	mutex->owner = NULL;
+	mutex->lock_count = 0;
+	slist_init(&mutex->wait_queue);
 }
 
 void mutex_lock(mutex_t *mutex)
 {
-	asm("1:     LDR     r1, =%[lock_const]\n\t"  /* Load MUTEX_LOCKED into r1 */
-	    "       LDREX   r2, [%[lock_value]]\n\t" /* Load-ex value of the mutext stored in memory
-						      */
-	    "       CMP     r1, r2\n\t"		     /* Compare loaded data to lock constant */
-	    "       ITTE    NE\n\t" /* If not locked - then execute next two instructions */
-	    "       STREXNE r2, r1, [%[lock_value]]\n\t" /*      - Store-ex locked value in mutex
-							    memory */
-	    "       CMPNE   r2, #1\n\t" /*      - Check result of store operation. */
-	    "       BEQ     2f\n\t"	/* else
-					 *      - jump to label 2.
-					 */
-	    "       IT      EQ\n\t"	/* Mind that this if-then block refers to CMPNE above,
-					 * the BEQ is an else in former if-then-else.
-					 */
-	    "       BEQ     1b\n\t"
-	    "       DMB\n\t"
-	    "       BX      LR\n\t"
-	    "2:     WFI\n\t"
-	    "       B       1b\n\t"
-	    :
-	    : [lock_const] "i"(MUTEX_LOCKED), [lock_value] "r"(&mutex->lock)
-	    : "r1", "r2");
+	int ret = mutex_lock_timeout(mutex, SCHED_TIMEOUT_FOREVER);
+
+	assert(ret == 0);
+	(void)ret;
+}
+
+int mutex_lock_timeout(mutex_t *mutex, uint32_t ticks)
+{
+	assert(mutex);
+
+	thread_t *current = sched_current_thread_get();
+	uint32_t flags = sched_lock();
+
+	if (mutex->owner == NULL) {
+		mutex->owner = current;
+		mutex->lock_count = 1;
+	} else if (mutex->owner == current) {
+		mutex->lock_count++;
+	} else {
+		/* Scheduler lock is released by pend. If the thread is woken up, it is the mutex owner already. */
+		int ret = sched_thread_pend_timeout(&mutex->wait_queue, flags, ticks);
+
+		assert(ret != 0 || mutex->owner == current);
+
+		return ret;
+	}
+
+	sched_unlock(flags);
+
+	return 0;
 }
 
 void mutex_unlock(mutex_t *mutex)
 {
-}
\ No newline at end of file
+	assert(mutex);
+
+	uint32_t flags = sched_lock();
+
+	assert(mutex->owner == sched_current_thread_get());
+	assert(mutex->lock_count > 0);
+
+	mutex->lock_count--;
+	if (mutex->lock_count == 0) {
+		mutex_handoff_locked(mutex);
+	}
+
+	/* If a waiting thread was woken up, it runs when scheduled, there is no immediate swap */
+	sched_unlock(flags);
+}
+
+void mutex_handoff_locked(mutex_t *mutex)
+{
+	assert(mutex);
+
+	mutex->owner = sched_thread_wake_one(&mutex->wait_queue);
+	mutex->lock_count = (mutex->owner != NULL) ? 1 : 0;
+}
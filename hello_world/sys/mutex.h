@@ -4,25 +4,79 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#ifndef __SYS_MUTEX_H__
+#define __SYS_MUTEX_H__
+
 #include <stdint.h>
 
+#include "thread.h"
+#include "scheduler.h"
+#include "../tools/slist.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
 
-typedef enum MUTEX_STATE {
-	MUTEX_UNLOCKED,
-        MUTEX_LOCKED
-} MUTEX_STATE_T;
+/** @file Kernel mutex.
+ *
+ * A thread that attempts to lock a mutex owned by other thread pends in the mutex wait queue. On unlock the
+ * ownership is passed directly to the first waiting thread, so waiters acquire the mutex in FIFO order and a thread
+ * that unlocks and locks again in a loop can't starve them. The mutex is recursive, the owner may lock it again and
+ * has to unlock it the same number of times.
+ *
+ * Mutex state is guarded by scheduler lock. Mutex may not be used from ISR.
+ */
 
 typedef struct sys_mutex {
-	uint32_t lock; /* ARM7-M TRM requires the muthex lock to be 4 bytes aligned */
-} mutex_t __attribute__((aligned(4)));
+	/* Thread that holds the mutex, NULL if the mutex is unlocked */
+	thread_t *owner;
+	/* Number of times the owner has locked the mutex */
+	uint32_t lock_count;
+	/* Threads waiting for the mutex */
+	slist_t wait_queue;
+} mutex_t;
 
+/* @brief Initialize a mutex, the mutex is unlocked
+ *
+ * @param mutex Pointer to mutex object
+ */
 void mutex_init(mutex_t *mutex);
+
+/* @brief Lock a mutex, wait as long as it is locked by other thread
+ *
+ * @param mutex Pointer to mutex object
+ */
 void mutex_lock(mutex_t *mutex);
+
+/* @brief Lock a mutex, wait for limited time if it is locked by other thread
+ *
+ * @param mutex Pointer to mutex object
+ * @param ticks Number of system ticks to wait, SCHED_TIMEOUT_FOREVER or SCHED_TIMEOUT_NO_WAIT
+ *
+ * @return 0 Mutex locked
+ *         -EAGAIN Mutex is locked by other thread and timeout expired
+ */
+int mutex_lock_timeout(mutex_t *mutex, uint32_t ticks);
+
+/* @brief Unlock a mutex
+ *
+ * Must be called by the mutex owner.
+ *
+ * @param mutex Pointer to mutex object
+ */
 void mutex_unlock(mutex_t *mutex);
 
+/* @brief Pass a mutex to the first waiting thread or unlock it if there is no waiting thread
+ *
+ * Must be called with scheduler lock held, when the mutex has no owner or its owner gives it up entirely.
+ * Intended for kernel objects that release a mutex on behalf of a thread, e.g. condition variables.
+ *
+ * @param mutex Pointer to mutex object
+ */
+void mutex_handoff_locked(mutex_t *mutex);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
+
+#endif /* __SYS_MUTEX_H__ */
@@ -0,0 +1,347 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "net_buf.h"
+#include "scheduler.h"
+#include "thread.h"
+#include "../tools/misc.h"
+#include "../tools/slist.h"
+
+#define NET_BUF_OBJECT_GET(node_ptr) CONTAINER_OF(node_ptr, net_buf_t, node)
+#define NET_BUF_FRAG_GET(node_ptr) CONTAINER_OF(node_ptr, net_buf_t, frag_node)
+
+/* @brief Put current thread into a wait queue until other thread hands it a buffer
+ *
+ * Must be called with scheduler lock held, the lock is released by the function. The handing thread stores the
+ * buffer through pend_data of the woken up thread.
+ */
+static net_buf_t *net_buf_wait(slist_t *wait_queue, uint32_t flags, uint32_t ticks)
+{
+	net_buf_t *buf = NULL;
+
+	sched_current_thread_get()->pend_data = &buf;
+
+	if (sched_thread_pend_timeout(wait_queue, flags, ticks) != 0) {
+		return NULL;
+	}
+
+	return buf;
+}
+
+/* @brief Pass a buffer to the first waiting thread, must be called with scheduler lock held
+ *
+ * @return true if the buffer was passed, false if no thread waits
+ */
+static bool net_buf_handoff(slist_t *wait_queue, net_buf_t *buf)
+{
+	thread_t *thread = sched_thread_wake_one(wait_queue);
+
+	if (thread == NULL) {
+		return false;
+	}
+
+	*(net_buf_t **)thread->pend_data = buf;
+
+	return true;
+}
+
+static void net_buf_reset(net_buf_t *buf)
+{
+	buf->node.next = NULL;
+	buf->frag_node.next = NULL;
+	buf->data = buf->storage;
+	buf->len = 0;
+	buf->ref = 1;
+}
+
+void net_buf_pool_init(net_buf_pool_t *pool)
+{
+	assert(pool);
+
+	slist_init(&pool->free);
+	slist_init(&pool->wait_queue);
+
+	for (uint16_t idx = 0; idx < pool->count; idx++) {
+		net_buf_t *buf = &pool->bufs[idx];
+
+		buf->pool = pool;
+		buf->storage = pool->storage + (uint32_t)idx * pool->buf_size;
+		buf->size = pool->buf_size;
+		buf->ref = 0;
+		buf->node.next = NULL;
+
+		slist_tail_put(&pool->free, &buf->node);
+	}
+
+	pool->free_count = pool->count;
+	pool->free_count_min = pool->count;
+}
+
+net_buf_t *net_buf_alloc(net_buf_pool_t *pool, uint32_t ticks)
+{
+	assert(pool);
+
+	net_buf_t *buf;
+	uint32_t flags = sched_lock();
+	slist_node_t *node = slist_head_get(&pool->free);
+
+	if (node != NULL) {
+		pool->free_count--;
+		if (pool->free_count < pool->free_count_min) {
+			pool->free_count_min = pool->free_count;
+		}
+
+		sched_unlock(flags);
+
+		buf = NET_BUF_OBJECT_GET(node);
+	} else {
+		/* Released buffer is handed to the waiting thread, it doesn't go through the free list */
+		buf = net_buf_wait(&pool->wait_queue, flags, ticks);
+		if (buf == NULL) {
+			return NULL;
+		}
+	}
+
+	net_buf_reset(buf);
+
+	return buf;
+}
+
+net_buf_t *net_buf_ref(net_buf_t *buf)
+{
+	assert(buf);
+
+	uint32_t flags = sched_lock();
+
+	assert(buf->ref > 0 && buf->ref < UINT8_MAX);
+	buf->ref++;
+
+	sched_unlock(flags);
+
+	return buf;
+}
+
+void net_buf_unref(net_buf_t *buf)
+{
+	assert(buf);
+
+	/* Fragments are released in a loop instead of recursion, each fragment holds a reference of the chain */
+	while (buf != NULL) {
+		net_buf_t *frag = NULL;
+		net_buf_pool_t *pool = buf->pool;
+		uint32_t flags = sched_lock();
+
+		assert(buf->ref > 0);
+		buf->ref--;
+
+		if (buf->ref > 0) {
+			sched_unlock(flags);
+
+			return;
+		}
+
+		if (buf->frag_node.next != NULL) {
+			frag = NET_BUF_FRAG_GET(buf->frag_node.next);
+			buf->frag_node.next = NULL;
+		}
+
+		if (!net_buf_handoff(&pool->wait_queue, buf)) {
+			slist_tail_put(&pool->free, &buf->node);
+			pool->free_count++;
+		}
+
+		sched_unlock(flags);
+
+		buf = frag;
+	}
+}
+
+void net_buf_reserve(net_buf_t *buf, uint16_t headroom)
+{
+	assert(buf);
+	assert(buf->len == 0);
+	assert(headroom <= buf->size);
+
+	buf->data = buf->storage + headroom;
+}
+
+uint16_t net_buf_headroom(const net_buf_t *buf)
+{
+	assert(buf);
+
+	return buf->data - buf->storage;
+}
+
+uint16_t net_buf_tailroom(const net_buf_t *buf)
+{
+	assert(buf);
+
+	return buf->size - net_buf_headroom(buf) - buf->len;
+}
+
+uint8_t *net_buf_tail(const net_buf_t *buf)
+{
+	assert(buf);
+
+	return buf->data + buf->len;
+}
+
+uint8_t *net_buf_add(net_buf_t *buf, uint16_t len)
+{
+	assert(net_buf_tailroom(buf) >= len);
+
+	uint8_t *tail = net_buf_tail(buf);
+
+	buf->len += len;
+
+	return tail;
+}
+
+uint8_t *net_buf_add_mem(net_buf_t *buf, const void *mem, uint16_t len)
+{
+	assert(mem);
+
+	return memcpy(net_buf_add(buf, len), mem, len);
+}
+
+uint8_t *net_buf_remove(net_buf_t *buf, uint16_t len)
+{
+	assert(buf);
+	assert(buf->len >= len);
+
+	buf->len -= len;
+
+	return net_buf_tail(buf);
+}
+
+uint8_t *net_buf_push(net_buf_t *buf, uint16_t len)
+{
+	assert(net_buf_headroom(buf) >= len);
+
+	buf->data -= len;
+	buf->len += len;
+
+	return buf->data;
+}
+
+uint8_t *net_buf_pull(net_buf_t *buf, uint16_t len)
+{
+	assert(buf);
+	assert(buf->len >= len);
+
+	uint8_t *data = buf->data;
+
+	buf->data += len;
+	buf->len -= len;
+
+	return data;
+}
+
+net_buf_t *net_buf_frag_next(const net_buf_t *buf)
+{
+	assert(buf);
+
+	if (buf->frag_node.next == NULL) {
+		return NULL;
+	}
+
+	return NET_BUF_FRAG_GET(buf->frag_node.next);
+}
+
+net_buf_t *net_buf_frag_last(net_buf_t *buf)
+{
+	assert(buf);
+
+	while (buf->frag_node.next != NULL) {
+		buf = NET_BUF_FRAG_GET(buf->frag_node.next);
+	}
+
+	return buf;
+}
+
+void net_buf_frag_add(net_buf_t *head, net_buf_t *frag)
+{
+	assert(head);
+	assert(frag);
+
+	net_buf_frag_last(head)->frag_node.next = &frag->frag_node;
+}
+
+net_buf_t *net_buf_frag_del(net_buf_t *parent)
+{
+	net_buf_t *frag = net_buf_frag_next(parent);
+
+	if (frag == NULL) {
+		return NULL;
+	}
+
+	net_buf_t *next = net_buf_frag_next(frag);
+
+	parent->frag_node.next = frag->frag_node.next;
+	frag->frag_node.next = NULL;
+
+	net_buf_unref(frag);
+
+	return next;
+}
+
+uint32_t net_buf_frags_len(const net_buf_t *buf)
+{
+	uint32_t len = 0;
+
+	while (buf != NULL) {
+		len += buf->len;
+		buf = net_buf_frag_next(buf);
+	}
+
+	return len;
+}
+
+void net_buf_queue_init(net_buf_queue_t *queue)
+{
+	assert(queue);
+
+	slist_init(&queue->bufs);
+	slist_init(&queue->wait_queue);
+}
+
+void net_buf_put(net_buf_queue_t *queue, net_buf_t *buf)
+{
+	assert(queue);
+	assert(buf);
+
+	uint32_t flags = sched_lock();
+
+	if (!net_buf_handoff(&queue->wait_queue, buf)) {
+		buf->node.next = NULL;
+		slist_tail_put(&queue->bufs, &buf->node);
+	}
+
+	sched_unlock(flags);
+}
+
+net_buf_t *net_buf_get(net_buf_queue_t *queue, uint32_t ticks)
+{
+	assert(queue);
+
+	uint32_t flags = sched_lock();
+	slist_node_t *node = slist_head_get(&queue->bufs);
+
+	if (node != NULL) {
+		sched_unlock(flags);
+
+		node->next = NULL;
+
+		return NET_BUF_OBJECT_GET(node);
+	}
+
+	return net_buf_wait(&queue->wait_queue, flags, ticks);
+}
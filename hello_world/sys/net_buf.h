@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __SYS_NET_BUF_H__
+#define __SYS_NET_BUF_H__
+
+#include <stdint.h>
+
+#include "thread.h"
+#include "scheduler.h"
+#include "../tools/slist.h"
+
+/** @file Reference counted buffers for zero-copy data pipelines.
+ *
+ * A buffer has fixed size storage taken from a pool. Data is a window in the storage, with headroom before and
+ * tailroom after it, so a protocol layer prepends or strips its header in place instead of copying the payload.
+ * Buffers are reference counted, a buffer returns to its pool when the last reference is released. Data that doesn't
+ * fit a single buffer is a chain of fragments, each fragment is a buffer that holds its own reference.
+ *
+ * Pipeline stages pass buffers through buffer queues, putting a buffer into a queue passes the caller reference to
+ * the thread that gets it.
+ *
+ * Pools and queues are guarded by scheduler lock. Functions that don't wait may be called from ISR.
+ */
+
+typedef struct sys_net_buf_pool net_buf_pool_t;
+
+typedef struct sys_net_buf {
+	/* Used by pool free list and by buffer queues */
+	slist_node_t node;
+	/* Next fragment of a chain */
+	slist_node_t frag_node;
+	net_buf_pool_t *pool;
+	/* Start of data */
+	uint8_t *data;
+	/* Length of data */
+	uint16_t len;
+	/* Size of the storage */
+	uint16_t size;
+	uint8_t ref;
+	/* Start of the storage */
+	uint8_t *storage;
+} net_buf_t;
+
+struct sys_net_buf_pool {
+	/* Free buffers */
+	slist_t free;
+	/* Threads waiting for a free buffer */
+	slist_t wait_queue;
+	net_buf_t *bufs;
+	uint8_t *storage;
+	uint16_t count;
+	uint16_t buf_size;
+	/* Number of free buffers and the lowest value of it, to size pools */
+	uint16_t free_count;
+	uint16_t free_count_min;
+};
+
+typedef struct sys_net_buf_queue {
+	slist_t bufs;
+	/* Threads waiting for a buffer */
+	slist_t wait_queue;
+} net_buf_queue_t;
+
+/** @brief Define a buffer pool.
+ *
+ * The pool has to be initialized with net_buf_pool_init() before use.
+ *
+ * @param name Name of the pool object
+ * @param _count Number of buffers in the pool
+ * @param _size Size of storage of each buffer, headroom included
+ */
+#define NET_BUF_POOL_DEFINE(name, _count, _size)                                                   \
+	static uint8_t net_buf_storage_##name[(_count) * (_size)] __attribute__((aligned(4)));     \
+	static net_buf_t net_buf_bufs_##name[_count];                                              \
+	net_buf_pool_t name = {                                                                    \
+		.bufs = net_buf_bufs_##name,                                                       \
+		.storage = net_buf_storage_##name,                                                 \
+		.count = (_count),                                                                 \
+		.buf_size = (_size),                                                               \
+	}
+
+/* @brief Initialize a buffer pool, all buffers become free
+ *
+ * @param pool Pointer to pool defined by NET_BUF_POOL_DEFINE()
+ */
+void net_buf_pool_init(net_buf_pool_t *pool);
+
+/* @brief Allocate a buffer from a pool
+ *
+ * The buffer has one reference, no data, no fragments and the whole storage is tailroom. A buffer released while
+ * threads wait is passed directly to the first waiting thread. May be called from ISR with SCHED_TIMEOUT_NO_WAIT
+ * only.
+ *
+ * @param pool Pointer to buffer pool
+ * @param ticks Number of system ticks to wait for a free buffer, SCHED_TIMEOUT_FOREVER or SCHED_TIMEOUT_NO_WAIT
+ *
+ * @return Pointer to buffer, NULL if there was no free buffer until timeout expired
+ */
+net_buf_t *net_buf_alloc(net_buf_pool_t *pool, uint32_t ticks);
+
+/* @brief Take a reference to a buffer
+ *
+ * @return Pointer to the buffer
+ */
+net_buf_t *net_buf_ref(net_buf_t *buf);
+
+/* @brief Release a reference to a buffer
+ *
+ * When the last reference is released, references to the buffer fragments are released and the buffer returns to its
+ * pool.
+ */
+void net_buf_unref(net_buf_t *buf);
+
+/* @brief Reserve headroom in an empty buffer */
+void net_buf_reserve(net_buf_t *buf, uint16_t headroom);
+
+/* @brief Get number of bytes that may be prepended to buffer data */
+uint16_t net_buf_headroom(const net_buf_t *buf);
+
+/* @brief Get number of bytes that may be appended to buffer data */
+uint16_t net_buf_tailroom(const net_buf_t *buf);
+
+/* @brief Get pointer to the first byte after buffer data */
+uint8_t *net_buf_tail(const net_buf_t *buf);
+
+/* @brief Extend buffer data at its end
+ *
+ * @return Pointer to the added space
+ */
+uint8_t *net_buf_add(net_buf_t *buf, uint16_t len);
+
+/* @brief Copy memory to the end of buffer data
+ *
+ * @return Pointer to the copied data in the buffer
+ */
+uint8_t *net_buf_add_mem(net_buf_t *buf, const void *mem, uint16_t len);
+
+/* @brief Remove bytes from the end of buffer data
+ *
+ * @return Pointer to the removed bytes, valid until the buffer is extended again
+ */
+uint8_t *net_buf_remove(net_buf_t *buf, uint16_t len);
+
+/* @brief Extend buffer data at its start, e.g. to prepend a header
+ *
+ * @return Pointer to the new start of data
+ */
+uint8_t *net_buf_push(net_buf_t *buf, uint16_t len);
+
+/* @brief Remove bytes from start of buffer data, e.g. to strip a header
+ *
+ * @return Pointer to the removed bytes, those stay valid until the buffer is pushed again
+ */
+uint8_t *net_buf_pull(net_buf_t *buf, uint16_t len);
+
+/* @brief Get next fragment of a buffer
+ *
+ * @return Pointer to next fragment, NULL if the buffer is the last one
+ */
+net_buf_t *net_buf_frag_next(const net_buf_t *buf);
+
+/* @brief Get the last fragment of a chain */
+net_buf_t *net_buf_frag_last(net_buf_t *buf);
+
+/* @brief Append a fragment, or a chain of fragments, at end of a chain
+ *
+ * The chain takes over the caller reference to the fragment.
+ *
+ * @param head Pointer to the first buffer of the chain
+ * @param frag Pointer to the fragment to append
+ */
+void net_buf_frag_add(net_buf_t *head, net_buf_t *frag);
+
+/* @brief Remove a fragment that follows a buffer in a chain and release the chain reference to it
+ *
+ * @param parent Pointer to the buffer the fragment follows
+ *
+ * @return Pointer to the fragment that followed the removed one, NULL if there is none
+ */
+net_buf_t *net_buf_frag_del(net_buf_t *parent);
+
+/* @brief Get total length of data of a buffer and all its fragments */
+uint32_t net_buf_frags_len(const net_buf_t *buf);
+
+/* @brief Initialize a buffer queue */
+void net_buf_queue_init(net_buf_queue_t *queue);
+
+/* @brief Put a buffer at end of a queue
+ *
+ * The caller reference to the buffer is passed to the queue. If a thread waits for a buffer, the buffer is passed
+ * directly to the first waiting thread. May be called from ISR.
+ */
+void net_buf_put(net_buf_queue_t *queue, net_buf_t *buf);
+
+/* @brief Get a buffer from start of a queue
+ *
+ * The caller gets the queue reference to the buffer. May be called from ISR with SCHED_TIMEOUT_NO_WAIT only.
+ *
+ * @param queue Pointer to buffer queue
+ * @param ticks Number of system ticks to wait for a buffer, SCHED_TIMEOUT_FOREVER or SCHED_TIMEOUT_NO_WAIT
+ *
+ * @return Pointer to buffer, NULL if the queue was empty until timeout expired
+ */
+net_buf_t *net_buf_get(net_buf_queue_t *queue, uint32_t ticks);
+
+#endif /* __SYS_NET_BUF_H__ */
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <drivers/nrfx_common.h>
+
+#include "ramfunc.h"
+
+#ifdef RAMFUNC_ENABLED
+/* Bounds of RAM functions and their load address, provided by ramfunc.ld */
+extern uint8_t __ramfunc_start[];
+extern uint8_t __ramfunc_end[];
+extern const uint8_t __ramfunc_load_start[];
+#endif /* RAMFUNC_ENABLED */
+
+void ramfunc_init()
+{
+#ifdef RAMFUNC_ENABLED
+	memcpy(__ramfunc_start, __ramfunc_load_start, (size_t)(__ramfunc_end - __ramfunc_start));
+
+	/* Make sure the code is written before it is fetched */
+	__DSB();
+	__ISB();
+#endif /* RAMFUNC_ENABLED */
+}
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __SYS_RAMFUNC_H__
+#define __SYS_RAMFUNC_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/** @file Functions executed from RAM.
+ *
+ * Flash is read with wait states at the full core clock, so code on hot paths of the kernel, e.g. context switch and
+ * system tick handling, is linked to .ramfunc section. The section is loaded to flash and copied to RAM by
+ * ramfunc_init(), see ramfunc.ld. Calls between flash and RAM are out of range of BL instruction, the linker
+ * inserts veneers for those.
+ *
+ * The feature is enabled by RAMFUNC_ENABLED, otherwise RAMFUNC has no effect.
+ */
+
+#ifdef RAMFUNC_ENABLED
+/* @brief Link a function to RAM
+ *
+ * The function must not be called before ramfunc_init(). If compiler inlines the function, the inlined copy is
+ * placed where the caller is.
+ */
+#define RAMFUNC __attribute__((section(".ramfunc")))
+#else
+#define RAMFUNC
+#endif /* RAMFUNC_ENABLED */
+
+/* @brief Copy functions linked to RAM from their load address in flash
+ *
+ * Must be called by system initialization code before any of the functions is executed.
+ */
+void ramfunc_init();
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __SYS_RAMFUNC_H__ */
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <drivers/nrfx_common.h>
+
+#include "thread.h"
+#include "scheduler.h"
+#include "rwlock.h"
+#include "../tools/slist.h"
+
+/* Slow path functions modify the state with plain stores, with scheduler lock held. It is safe because the lock
+ * disables interrupts and exception entry clears the exclusive monitor, so a fast path update interrupted between
+ * LDREX and STREX fails and is repeated with the new state.
+ */
+
+static bool rwlock_read_fast_lock(rwlock_t *lock)
+{
+	uint32_t state;
+
+	do {
+		state = __LDREXW(&lock->state);
+		if (state & (RWLOCK_STATE_WRITER | RWLOCK_STATE_WAITERS)) {
+			__CLREX();
+			return false;
+		}
+	} while (__STREXW(state + 1, &lock->state) != 0);
+
+	__DMB();
+
+	return true;
+}
+
+static bool rwlock_read_fast_unlock(rwlock_t *lock)
+{
+	uint32_t state;
+
+	__DMB();
+
+	do {
+		state = __LDREXW(&lock->state);
+		if (state & RWLOCK_STATE_WAITERS) {
+			__CLREX();
+			return false;
+		}
+	} while (__STREXW(state - 1, &lock->state) != 0);
+
+	return true;
+}
+
+static bool rwlock_write_fast_lock(rwlock_t *lock)
+{
+	do {
+		if (__LDREXW(&lock->state) != 0) {
+			__CLREX();
+			return false;
+		}
+	} while (__STREXW(RWLOCK_STATE_WRITER, &lock->state) != 0);
+
+	__DMB();
+
+	return true;
+}
+
+static bool rwlock_write_fast_unlock(rwlock_t *lock)
+{
+	__DMB();
+
+	do {
+		if (__LDREXW(&lock->state) != RWLOCK_STATE_WRITER) {
+			__CLREX();
+			return false;
+		}
+	} while (__STREXW(0, &lock->state) != 0);
+
+	return true;
+}
+
+/* @brief Update waiters flag, must be called with scheduler lock held */
+static void rwlock_waiters_update(rwlock_t *lock)
+{
+	if (slist_head_peek(&lock->read_queue) != NULL || slist_head_peek(&lock->write_queue) != NULL) {
+		lock->state |= RWLOCK_STATE_WAITERS;
+	} else {
+		lock->state &= ~RWLOCK_STATE_WAITERS;
+	}
+}
+
+/* @brief Pass a released lock to waiting threads, must be called with scheduler lock held
+ *
+ * A waiting writer is preferred. If there is none, all waiting readers get the lock at once.
+ */
+static void rwlock_handoff(rwlock_t *lock)
+{
+	assert((lock->state & (RWLOCK_STATE_WRITER | RWLOCK_STATE_READERS_MASK)) == 0);
+
+	if (sched_thread_wake_one(&lock->write_queue) != NULL) {
+		lock->state |= RWLOCK_STATE_WRITER;
+	} else {
+		while (sched_thread_wake_one(&lock->read_queue) != NULL) {
+			lock->state++;
+		}
+	}
+
+	rwlock_waiters_update(lock);
+}
+
+void rwlock_init(rwlock_t *lock)
+{
+	assert(lock);
+
+	lock->state = 0;
+	slist_init(&lock->read_queue);
+	slist_init(&lock->write_queue);
+}
+
+void rwlock_read_lock(rwlock_t *lock)
+{
+	assert(lock);
+
+	if (rwlock_read_fast_lock(lock)) {
+		return;
+	}
+
+	uint32_t flags = sched_lock();
+
+	if ((lock->state & RWLOCK_STATE_WRITER) == 0 && slist_head_peek(&lock->write_queue) == NULL) {
+		assert((lock->state & RWLOCK_STATE_READERS_MASK) < RWLOCK_STATE_READERS_MASK);
+		lock->state++;
+		sched_unlock(flags);
+
+		return;
+	}
+
+	lock->state |= RWLOCK_STATE_WAITERS;
+
+	/* Scheduler lock is released by pend. The thread is woken up as a lock holder. */
+	sched_thread_pend(&lock->read_queue, flags);
+}
+
+void rwlock_read_unlock(rwlock_t *lock)
+{
+	assert(lock);
+
+	if (rwlock_read_fast_unlock(lock)) {
+		return;
+	}
+
+	uint32_t flags = sched_lock();
+
+	assert((lock->state & RWLOCK_STATE_READERS_MASK) != 0);
+	lock->state--;
+
+	/* Last reader passes the lock to a waiting writer */
+	if ((lock->state & RWLOCK_STATE_READERS_MASK) == 0) {
+		rwlock_handoff(lock);
+	}
+
+	sched_unlock(flags);
+}
+
+void rwlock_write_lock(rwlock_t *lock)
+{
+	assert(lock);
+
+	if (rwlock_write_fast_lock(lock)) {
+		return;
+	}
+
+	uint32_t flags = sched_lock();
+
+	if ((lock->state & (RWLOCK_STATE_WRITER | RWLOCK_STATE_READERS_MASK)) == 0) {
+		lock->state |= RWLOCK_STATE_WRITER;
+		sched_unlock(flags);
+
+		return;
+	}
+
+	lock->state |= RWLOCK_STATE_WAITERS;
+
+	/* Scheduler lock is released by pend. The thread is woken up as a lock holder. */
+	sched_thread_pend(&lock->write_queue, flags);
+}
+
+void rwlock_write_unlock(rwlock_t *lock)
+{
+	assert(lock);
+
+	if (rwlock_write_fast_unlock(lock)) {
+		return;
+	}
+
+	uint32_t flags = sched_lock();
+
+	assert(lock->state & RWLOCK_STATE_WRITER);
+	lock->state &= ~RWLOCK_STATE_WRITER;
+
+	rwlock_handoff(lock);
+
+	sched_unlock(flags);
+}
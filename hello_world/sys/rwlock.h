@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __SYS_RWLOCK_H__
+#define __SYS_RWLOCK_H__
+
+#include <stdint.h>
+
+#include "../tools/misc.h"
+#include "../tools/slist.h"
+
+/** @file Reader-writer lock for read-mostly data.
+ *
+ * Many readers may hold the lock at once, a writer holds it exclusively. Writers are preferred: when a writer
+ * waits, new readers wait as well, so a continuous stream of readers can't starve writers.
+ *
+ * Uncontended lock and unlock is a single LDREX/STREX update of the lock state, without scheduler involvement.
+ * When the lock has to wait, or there are waiting threads to wake up, the slow path is taken. It is guarded by
+ * scheduler lock and passes the lock directly to woken up threads.
+ *
+ * The lock may not be used from ISR. It isn't recursive.
+ */
+
+/* Lock state: number of readers holding the lock and flags */
+#define RWLOCK_STATE_WRITER BIT(31)
+#define RWLOCK_STATE_WAITERS BIT(30)
+#define RWLOCK_STATE_READERS_MASK (RWLOCK_STATE_WAITERS - 1)
+
+typedef struct sys_rwlock {
+	volatile uint32_t state;
+	/* Readers waiting for a writer to release the lock */
+	slist_t read_queue;
+	/* Writers waiting for readers or other writer to release the lock */
+	slist_t write_queue;
+} rwlock_t;
+
+/* @brief Initialize a reader-writer lock, the lock is released
+ *
+ * @param lock Pointer to reader-writer lock
+ */
+void rwlock_init(rwlock_t *lock);
+
+/* @brief Acquire a lock for reading, wait if a writer holds the lock or waits for it
+ *
+ * @param lock Pointer to reader-writer lock
+ */
+void rwlock_read_lock(rwlock_t *lock);
+
+/* @brief Release a lock acquired for reading
+ *
+ * @param lock Pointer to reader-writer lock
+ */
+void rwlock_read_unlock(rwlock_t *lock);
+
+/* @brief Acquire a lock for writing, wait if other thread holds the lock
+ *
+ * @param lock Pointer to reader-writer lock
+ */
+void rwlock_write_lock(rwlock_t *lock);
+
+/* @brief Release a lock acquired for writing
+ *
+ * @param lock Pointer to reader-writer lock
+ */
+void rwlock_write_unlock(rwlock_t *lock);
+
+#endif /* __SYS_RWLOCK_H__ */
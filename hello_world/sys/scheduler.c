@@ -8,12 +8,19 @@
 
 #include <stdint.h>
 #include <assert.h>
+#include <errno.h>
 
 #include <drivers/include/nrfx_systick.h>
 
+#include "clock.h"
+#include "isr.h"
+#include "ramfunc.h"
 #include "spin_lock.h"
 #include "thread.h"
 #include "scheduler.h"
+#include "soft_timer.h"
+#include "timeout.h"
+#include "trace.h"
 
 /** @brief Free thread objects pool.
  * 
@@ -22,6 +29,11 @@
  */
 static slist_t m_thread_ready_pool;
 
+/* Threads that ended and were switched out. Those are put into free threads pool by sched_zombies_reclaim(), out of
+ * PendSV handler, to keep the context switch short.
+ */
+static slist_t m_zombie_threads;
+
 /* Current implementation of Round-robin scheduler is based on ready threads pool.
  *
  * Currently executed thread is stored in global variable g_current_thread.
@@ -47,23 +59,43 @@ static spin_lock_t m_sched_lock;
 /* For debuggin purposes */
 uint64_t tick_cnt = 0;
 
-static void sched_threads_waiting_resume(slist_t *wait_queue);
+#ifdef THREAD_STATS_ENABLED
+/* Cycle counter value when current thread was switched in */
+static uint32_t m_slice_start;
+/* Sum of cycles accounted to all threads on context switches */
+static uint64_t m_total_cycles;
+/* Set by schedule(), tells if the pending switch was requested by the current thread itself */
+static bool m_switch_voluntary;
+#endif /* THREAD_STATS_ENABLED */
+
 static bool schedule(bool is_ending);
+static void sched_current_pend(slist_t *wait_queue, THREAD_STATUS_T reason);
+static void sched_thread_unpend(thread_t *thread, int result);
 
-void swap_threads()
+RAMFUNC void swap_threads()
 {
 	g_current_thread->ctx_ptr.status &= (~THREAD_STATUS_ACTIVE);
 	g_next_thread->ctx_ptr.status |= THREAD_STATUS_ACTIVE;
 
+	TRACE_EVENT(TRACE_EVENT_SWAP_REQUEST, 0, g_next_thread->id);
+
 	SCB->ICSR |= SCB_ICSR_PENDSVSET_Msk;
 	__DSB();
 	__ISB();
 }
 
-void SysTick_Handler(void)
+/* System tick handler and its body run on every tick, link both to RAM */
+RAMFUNC void SysTick_Handler(void);
+RAMFUNC static void SysTick_Handler_body(void);
+
+ISR_DEFINE(SysTick_Handler)
 {
 	tick_cnt++;
 
+	/* Expired timeouts and timers may make threads ready, so handle those before schedule */
+	timeout_tick_announce();
+	soft_timer_tick_announce();
+
 	/* Lock it to avoid race when other irq happens */
 	spin_lock_irq(&m_sched_lock);
 
@@ -89,6 +121,7 @@ void scheduler_init(thread_t *main_thread, thread_t *idle_thread)
 	assert(idle_thread != NULL);
 
 	slist_init(&m_thread_ready_pool);
+	slist_init(&m_zombie_threads);
 
 	/* Initialize current thread to main_thread. There may not be any thread before call to this function. */
 	g_current_thread = main_thread;
@@ -100,10 +133,28 @@ void scheduler_init(thread_t *main_thread, thread_t *idle_thread)
          */
 	nrfx_systick_init();
 
+	clock_init();
+	soft_timer_subsys_init();
+
+#ifdef TRACE_ENABLED
+	trace_init();
+#endif /* TRACE_ENABLED */
+#ifdef ISR_STATS_ENABLED
+	isr_stats_init();
+#endif /* ISR_STATS_ENABLED */
+
 	//	SCB->SHP[11] = (uint8_t)(0x01 << (8U - __NVIC_PRIO_BITS));
 	/* Set long time - just for now. Later change it to configurable time slice. */
 	SysTick->CTRL |= SysTick_CTRL_TICKINT_Msk;
 	SysTick->LOAD = (0x1 << 24);
+
+#ifdef THREAD_STATS_ENABLED
+	/* Enable cycle counter that is used to measure threads time slices */
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	m_slice_start = 0;
+#endif /* THREAD_STATS_ENABLED */
 }
 
 /* @brief Get next thread to execute
@@ -145,7 +196,7 @@ static thread_t *ready_next_remove()
 	}
 }
 
-static bool schedule(bool is_ending)
+RAMFUNC static bool schedule(bool is_ending)
 {
 	thread_t *next_thread = ready_next_peek();
 
@@ -159,6 +210,11 @@ static bool schedule(bool is_ending)
 	g_next_thread = ready_next_get();
 	assert(next_thread == g_next_thread || next_thread == NULL);
 
+#ifdef THREAD_STATS_ENABLED
+	/* Current thread that ends or pends gives up the CPU, otherwise it is preempted */
+	m_switch_voluntary = is_ending;
+#endif /* THREAD_STATS_ENABLED */
+
 	/* Put current thread into ready queue again in case its not ending and not idle thread. */
 	if (is_ending == false && g_current_thread != m_idle_thread) {
 		/* Put next node at end of rady list for next re-schedule. */
@@ -178,93 +234,200 @@ void sched_ready_enqueu(thread_t *thread)
 	slist_tail_put(&m_thread_ready_pool, &thread->list_node);
 
 	thread->ctx_ptr.status |= THREAD_STATUS_WAITING;
+
+	TRACE_EVENT(TRACE_EVENT_READY, 0, thread->id);
 }
 
 void sched_ready_remove(thread_t *thread)
 {
-	slist_node_t *node = slist_head_peek(&m_thread_ready_pool);
+	(void)slist_find_remove(&m_thread_ready_pool, &thread->list_node);
+}
 
-	/* If a thread is head of ready threads pool, remove it and return */
-	if (node == &thread->list_node) {
-		slist_head_remove(&m_thread_ready_pool);
+/* @brief Remove a thread that isn't current thread from a queue it is in
+ *
+ * A thread is in a wait queue if it pends, otherwise it is in ready threads pool unless it is suspended. Must be
+ * called with scheduler lock held.
+ */
+static void sched_thread_dequeue(thread_t *thread)
+{
+	if (thread->pend_queue != NULL) {
+		(void)slist_find_remove(thread->pend_queue, &thread->list_node);
+		thread->pend_queue = NULL;
 
-		return;
+		/* Lock order is scheduler lock first, then timeout lock */
+		timeout_abort(&thread->pend_timeout);
+	} else if ((thread->ctx_ptr.status & THREAD_STATUS_SUSPENDED) == 0) {
+		sched_ready_remove(thread);
 	}
 
-	/* The thread isn't head of the ready threads pool, check remaining nodes */
-	slist_node_t *node_next = slist_next_peek(node);
-
-	do {
-		/* If thread is next node in the pool, remove next and return */
-		if (node_next == &thread->list_node) {
-			slist_next_remove(&m_thread_ready_pool, node);
-
-			return;
-		}
-
-		/* Next node becomes current node now. Continue loop until thread is found or we reach end of list */
-		node = node_next;
-		node_next = slist_next_peek(node_next);
-	} while (node_next != NULL);
+	thread->list_node.next = NULL;
 }
 
 void sched_thread_end(thread_t *thread)
 {
-	/* A thread function has returned, hence this isn't called from interrupt context.
-	 * Anyway execution may be interrupted by e.g. Systick and we are updating sheduling
-	 * queues, so we have to lock access to those and disable interrupts until we are done.
-	 * At end there is an attempt to swap to new thread.
+	/* The function is called by a thread that returned from its function or by other thread that aborts it. In both
+	 * cases execution may be interrupted by e.g. Systick and we are updating sheduling queues, so we have to lock
+	 * access to those and disable interrupts until we are done. At end there may be an attempt to swap to new thread.
 	 */
-	/* Lock it to avoid race when other irq happens */
-	spin_lock_irq(&m_sched_lock);
+	uint32_t flags = sched_lock();
+
+	/* The thread may have been aborted by other thread before the lock was taken */
+	if ((thread->ctx_ptr.status & (THREAD_STATUS_NONE | THREAD_STATUS_ENDED)) != 0) {
+		sched_unlock(flags);
+
+		return;
+	}
+
+	thread->ctx_ptr.status |= THREAD_STATUS_ENDED;
+	thread->ctx_ptr.status &= ~(THREAD_STATUS_SUSPENDED | THREAD_STATUS_PENDING | THREAD_STATUS_WAITING);
 
 	/* Rresume all threads that waited (called thread_join) on this thread */
 	sched_threads_waiting_resume(&thread->wait_queue);
 
-	/* Cleanup thread object and add it to free threads pool */
-	thread->list_node.next = NULL;
-
 	/* When we end current thread, the re-schedule is mandatory, in other case just remove the thread from
-	 * ready threads pool.
+	 * a queue it is in.
 	 */
 	if (thread == g_current_thread) {
+		thread->list_node.next = NULL;
+
 		bool swap = schedule(true);
+		assert(swap);
 
-		if (swap) {
-			swap_threads();
-		}
+		swap_threads();
+
+		/* The thread object is in use until PendSV stores the thread context. It is put into zombie threads list
+		 * by sched_switch_hook() and reclaimed later.
+		 */
 	} else {
-		sched_ready_remove(thread);
+		sched_thread_dequeue(thread);
+		thread_free_put(thread);
 	}
 
-	/* TODO: this is wrong. There is a release of a thread that is still current thread.
-	 * It could be ended and alive at once if the thread is current thread. It works because contents of context
-	 * are not cleaned up before swap happens.
-	 */
-	thread_free_put(thread);
-	thread->ctx_ptr.status |= THREAD_STATUS_ENDED;
-
 	/* Unlock the IRQ to take pending thread swap. There is no point of return to this function after
-	 * we unlock IRQs and PendSV is taken.
+	 * we unlock IRQs and PendSV is taken, if current thread has ended.
 	 */
-	spin_unlock_irq(&m_sched_lock);
+	sched_unlock(flags);
 }
 
-static void sched_threads_waiting_resume(slist_t *wait_queue)
+int sched_thread_suspend(thread_t *thread)
+{
+	uint32_t flags = sched_lock();
+
+	if ((thread->ctx_ptr.status & (THREAD_STATUS_NONE | THREAD_STATUS_ENDED)) != 0) {
+		sched_unlock(flags);
+
+		return -EINVAL;
+	}
+
+	if ((thread->ctx_ptr.status & THREAD_STATUS_SUSPENDED) == 0) {
+		thread->ctx_ptr.status |= THREAD_STATUS_SUSPENDED;
+
+		TRACE_EVENT(TRACE_EVENT_BLOCK, THREAD_STATUS_SUSPENDED, thread->id);
+
+		if (thread == g_current_thread) {
+			/* Suspended thread isn't put back into ready threads pool, the same as ending one */
+			bool swap = schedule(true);
+			assert(swap);
+
+			swap_threads();
+		} else if (thread->pend_queue == NULL) {
+			/* Pending thread stays in its wait queue, it isn't made ready when woken up */
+			sched_ready_remove(thread);
+			thread->list_node.next = NULL;
+		}
+	}
+
+	/* If current thread was suspended, it is swapped here and execution continues when it is resumed */
+	sched_unlock(flags);
+
+	return 0;
+}
+
+int sched_thread_resume(thread_t *thread)
+{
+	uint32_t flags = sched_lock();
+
+	if ((thread->ctx_ptr.status & THREAD_STATUS_SUSPENDED) == 0) {
+		sched_unlock(flags);
+
+		return -EINVAL;
+	}
+
+	thread->ctx_ptr.status &= ~THREAD_STATUS_SUSPENDED;
+
+	/* Thread that still pends is made ready when it is woken up */
+	if (thread->pend_queue == NULL) {
+		TRACE_EVENT(TRACE_EVENT_WAKE, 0, thread->id);
+
+		sched_ready_enqueu(thread);
+	}
+
+	sched_unlock(flags);
+
+	return 0;
+}
+
+void sched_threads_waiting_resume(slist_t *wait_queue)
 {
 	assert(wait_queue);
 
 	slist_node_t *waiting_thread_node = slist_head_get(wait_queue);
-	thread_t *waiting_thread;
 
 	while (waiting_thread_node != NULL) {
-		waiting_thread = THREAD_OBJECT_GET(waiting_thread_node);
-		waiting_thread->ctx_ptr.status &= (~THREAD_STATUS_WAITING);
+		sched_thread_unpend(THREAD_OBJECT_GET(waiting_thread_node), 0);
+		waiting_thread_node = slist_head_get(wait_queue);
+	}
+}
 
-		waiting_thread_node->next = NULL;
+uint32_t sched_threads_wake_match(slist_t *wait_queue, sched_wake_match_t match, void *arg)
+{
+	assert(wait_queue);
+	assert(match);
+
+	uint32_t woken = 0;
+	slist_node_t *prev = NULL;
+	slist_node_t *node = slist_head_peek(wait_queue);
+
+	while (node != NULL) {
+		slist_node_t *next = slist_next_peek(node);
+		thread_t *thread = THREAD_OBJECT_GET(node);
+
+		if (match(thread, arg)) {
+			if (prev == NULL) {
+				slist_head_remove(wait_queue);
+			} else {
+				slist_next_remove(wait_queue, prev);
+			}
+
+			sched_thread_unpend(thread, 0);
+			woken++;
+		} else {
+			prev = node;
+		}
 
-		sched_ready_enqueu(waiting_thread);
-		waiting_thread_node = slist_head_get(wait_queue);
+		node = next;
+	}
+
+	return woken;
+}
+
+void sched_threads_requeue(slist_t *from, slist_t *to)
+{
+	assert(from);
+	assert(to);
+
+	slist_node_t *node = slist_head_get(from);
+
+	while (node != NULL) {
+		thread_t *thread = THREAD_OBJECT_GET(node);
+
+		timeout_abort(&thread->pend_timeout);
+
+		node->next = NULL;
+		slist_tail_put(to, node);
+		thread->pend_queue = to;
+
+		node = slist_head_get(from);
 	}
 }
 
@@ -278,22 +441,204 @@ void sched_thread_join(thread_t *thread)
 	/* Lock it to avoid race when other irq happens */
 	spin_lock_irq(&m_sched_lock);
 
-	/* Put current thread into wait queue of thread to join */
-	slist_tail_put(&thread->wait_queue, &g_current_thread->list_node);
-
-	bool swap = schedule(false);
-
-	/* It would be wired that swap is false here. It would mean there is no other ready thread and we join theread
-	 * that is waiting for other thread or event and there is no idle thread. May not happen!
+	/* The thread may have ended after caller checked its status but before the lock was taken. Its wait queue was
+	 * already resumed, so there is nothing to wait for.
 	 */
-	if (swap == true) {
-		swap_threads();
+	if ((thread->ctx_ptr.status & (THREAD_STATUS_NONE | THREAD_STATUS_ENDED)) == 0) {
+		/* Put current thread into wait queue of thread to join */
+		sched_current_pend(&thread->wait_queue, THREAD_STATUS_WAITING);
 	}
 
-	thread->ctx_ptr.status |= THREAD_STATUS_WAITING;
-
 	/* Unlock irqs to take PendingSV to swap threads. If returns here the thread has been woken up from wait and
 	 * thread to join has ended.
 	 */
 	spin_unlock_irq(&m_sched_lock);
 }
+
+uint32_t sched_lock()
+{
+	return spin_lock_irq_store(&m_sched_lock);
+}
+
+void sched_unlock(uint32_t flags)
+{
+	spin_unlock_irq_restore(&m_sched_lock, flags);
+}
+
+/* @brief Put current thread into a wait queue and request swap to next thread
+ *
+ * Must be called with scheduler lock held. The swap happens when the lock is released.
+ */
+static void sched_current_pend(slist_t *wait_queue, THREAD_STATUS_T reason)
+{
+	assert(g_current_thread != m_idle_thread);
+
+	g_current_thread->list_node.next = NULL;
+	slist_tail_put(wait_queue, &g_current_thread->list_node);
+	g_current_thread->pend_queue = wait_queue;
+	g_current_thread->ctx_ptr.status |= reason;
+
+	TRACE_EVENT(TRACE_EVENT_BLOCK, reason, g_current_thread->id);
+
+	/* Pending thread leaves the CPU the same way as ending one: it may not be put back into ready threads pool
+	 * because its list node is already used by the wait queue. If there is no ready thread, the idle thread is
+	 * taken, so the swap always happens.
+	 */
+	bool swap = schedule(true);
+	assert(swap);
+
+	swap_threads();
+}
+
+/* @brief Remove a thread from its wait queue when pend timeout expires
+ *
+ * Called from SysTick context without the timeout queue lock held, so the scheduler lock may be taken here.
+ */
+static void sched_pend_timeout_handler(timeout_t *timeout)
+{
+	thread_t *thread = CONTAINER_OF(timeout, thread_t, pend_timeout);
+	uint32_t flags = sched_lock();
+
+	/* The thread may have been woken up after the timeout expired, but before the lock was taken */
+	if (thread->pend_queue != NULL &&
+	    slist_find_remove(thread->pend_queue, &thread->list_node)) {
+		sched_thread_unpend(thread, -EAGAIN);
+	}
+
+	sched_unlock(flags);
+}
+
+/* @brief Make ready a thread that was removed from its wait queue
+ *
+ * Must be called with scheduler lock held.
+ */
+static void sched_thread_unpend(thread_t *thread, int result)
+{
+	thread->list_node.next = NULL;
+	thread->pend_queue = NULL;
+	thread->pend_result = result;
+	thread->ctx_ptr.status &= ~(THREAD_STATUS_WAITING | THREAD_STATUS_PENDING);
+
+	/* Lock order is scheduler lock first, then timeout lock */
+	timeout_abort(&thread->pend_timeout);
+
+	TRACE_EVENT(TRACE_EVENT_WAKE, 0, thread->id);
+
+	/* Suspended thread is made ready when it is resumed */
+	if ((thread->ctx_ptr.status & THREAD_STATUS_SUSPENDED) == 0) {
+		sched_ready_enqueu(thread);
+	}
+}
+
+void sched_thread_pend(slist_t *wait_queue, uint32_t flags)
+{
+	(void)sched_thread_pend_timeout(wait_queue, flags, SCHED_TIMEOUT_FOREVER);
+}
+
+int sched_thread_pend_timeout(slist_t *wait_queue, uint32_t flags, uint32_t ticks)
+{
+	assert(wait_queue);
+
+	if (ticks == SCHED_TIMEOUT_NO_WAIT) {
+		spin_unlock_irq_restore(&m_sched_lock, flags);
+
+		return -EAGAIN;
+	}
+
+	thread_t *thread = g_current_thread;
+
+	thread->pend_result = 0;
+
+	if (ticks != SCHED_TIMEOUT_FOREVER) {
+		timeout_init(&thread->pend_timeout, sched_pend_timeout_handler);
+		timeout_add(&thread->pend_timeout, ticks);
+	}
+
+	sched_current_pend(wait_queue, THREAD_STATUS_PENDING);
+
+	/* Releasing the lock restores interrupts and PendSV swaps the thread. Execution continues here when the thread
+	 * is woken up or the timeout expires.
+	 */
+	spin_unlock_irq_restore(&m_sched_lock, flags);
+
+	return thread->pend_result;
+}
+
+thread_t *sched_thread_wake_one(slist_t *wait_queue)
+{
+	assert(wait_queue);
+
+	slist_node_t *thread_node = slist_head_get(wait_queue);
+	if (thread_node == NULL) {
+		return NULL;
+	}
+
+	thread_t *thread = THREAD_OBJECT_GET(thread_node);
+
+	sched_thread_unpend(thread, 0);
+
+	return thread;
+}
+
+RAMFUNC void sched_switch_hook(thread_t *prev, thread_t *next)
+{
+	TRACE_EVENT(TRACE_EVENT_SWITCH, 0, next->id);
+
+#ifdef THREAD_STATS_ENABLED
+	uint32_t now = DWT->CYCCNT;
+	/* Unsigned arithmetic handles cycle counter wrap, as long as a slice is shorter than the counter period */
+	uint32_t slice = now - m_slice_start;
+
+	prev->stats.runtime_cycles += slice;
+	if (slice > prev->stats.max_slice_cycles) {
+		prev->stats.max_slice_cycles = slice;
+	}
+
+	if (m_switch_voluntary) {
+		prev->stats.switches_voluntary++;
+	} else {
+		prev->stats.switches_preempted++;
+	}
+
+	next->stats.switches_in++;
+
+	m_total_cycles += slice;
+	m_slice_start = now;
+#endif /* THREAD_STATS_ENABLED */
+
+#ifdef THREAD_REENT_ENABLED
+	/* Newlib functions use reentrancy structure of current thread. Thread pointer is switched by PendSV handler. */
+	_impure_ptr = &next->reent;
+#endif /* THREAD_REENT_ENABLED */
+
+	/* Context of ended thread has been stored already, nothing refers to the thread object anymore. Its list node
+	 * isn't used by any queue since the thread ended.
+	 */
+	if ((prev->ctx_ptr.status & THREAD_STATUS_ENDED) != 0) {
+		slist_tail_put(&m_zombie_threads, &prev->list_node);
+	}
+}
+
+void sched_zombies_reclaim()
+{
+	slist_node_t *thread_node = slist_head_get(&m_zombie_threads);
+
+	while (thread_node != NULL) {
+		thread_node->next = NULL;
+		thread_free_put(THREAD_OBJECT_GET(thread_node));
+
+		thread_node = slist_head_get(&m_zombie_threads);
+	}
+}
+
+#ifdef THREAD_STATS_ENABLED
+uint32_t sched_current_slice_cycles_get()
+{
+	return DWT->CYCCNT - m_slice_start;
+}
+
+uint64_t sched_total_cycles_get()
+{
+	return m_total_cycles + sched_current_slice_cycles_get();
+}
+#endif /* THREAD_STATS_ENABLED */
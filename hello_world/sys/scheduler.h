@@ -7,10 +7,29 @@
 #ifndef __SYS_SCHEDULER_H__
 #define __SYS_SCHEDULER_H__
 
+#include <stdint.h>
+#include <stdbool.h>
+
 #include "../tools/slist.h"
 
+/* Pend without a timeout */
+#define SCHED_TIMEOUT_FOREVER UINT32_MAX
+/* Do not pend at all, return immediately */
+#define SCHED_TIMEOUT_NO_WAIT 0
+
 struct thread_t;
 
+/* @brief Function that decides if a pending thread is woken up
+ *
+ * Called with scheduler lock held, it may not block.
+ *
+ * @param thread Pointer to a thread that pends
+ * @param arg Argument passed to sched_threads_wake_match()
+ *
+ * @return true if the thread should be woken up, false otherwise
+ */
+typedef bool (*sched_wake_match_t)(thread_t *thread, void *arg);
+
 /* @brief Initialize scheduler
  *
  * The function is responsible for scheduler initialization. It expectst to get pointes to main thread and idle thread.
@@ -24,13 +43,36 @@ void scheduler_init(thread_t *main_thread, thread_t *idle_thread);
 /* @brief Cleanup of an ending thread in scheduler
  * 
  * The function does end of a thread processing in scheudler. If ending thread is current thread it will swap it to next
- * ready thread.
+ * ready thread. Other thread is removed from a queue it is in: ready threads pool or a wait queue. Threads that joined
+ * the ending thread are woken up. If the thread has already ended, the function does nothing.
  * 
  * @param thread Pointer to ending thread
  * 
  */
 void sched_thread_end(thread_t *thread);
 
+/* @brief Suspend a thread
+ *
+ * If the thread is current thread it is swapped to next ready thread.
+ *
+ * @param thread Pointer to thread to suspend
+ *
+ * @return 0 Thread suspended or it was already suspended
+ *         -EINVAL Thread has ended
+ */
+int sched_thread_suspend(thread_t *thread);
+
+/* @brief Resume a suspended thread
+ *
+ * The thread is added to ready threads pool unless it still pends on a wait queue.
+ *
+ * @param thread Pointer to thread to resume
+ *
+ * @return 0 Thread resumed
+ *         -EINVAL Thread is not suspended
+ */
+int sched_thread_resume(thread_t *thread);
+
 /* @brief Join a particular thread 
  *
  * The function executes join operation to a thread. The calling thread that is current thread, will be put into wait
@@ -54,4 +96,117 @@ void sched_ready_enqueu(thread_t *thread);
  */
 thread_t *sched_current_thread_get();
 
+/* @brief Acquire scheduler lock
+ *
+ * The scheduler lock guards ready threads pool and all wait queues used by kernel objects. It disables interrupts, so
+ * it may be used from ISR. The lock is not recursive.
+ *
+ * @return State of interrupts mask to be passed to sched_unlock()
+ */
+uint32_t sched_lock();
+
+/* @brief Release scheduler lock
+ *
+ * @param flags State of interrupts mask returned by sched_lock()
+ */
+void sched_unlock(uint32_t flags);
+
+/* @brief Put current thread into a wait queue and swap it
+ *
+ * Must be called with scheduler lock held, the lock is released by the function. The function returns when the
+ * thread is woken up by sched_thread_wake_one() or sched_threads_waiting_resume(). May not be called from ISR.
+ *
+ * @param wait_queue Pointer to wait queue the current thread pends on
+ * @param flags State of interrupts mask returned by sched_lock()
+ */
+void sched_thread_pend(slist_t *wait_queue, uint32_t flags);
+
+/* @brief Put current thread into a wait queue for limited time and swap it
+ *
+ * Must be called with scheduler lock held, the lock is released by the function. The function returns when the
+ * thread is woken up or the timeout expires. If timeout expires the thread is removed from the wait queue. May not
+ * be called from ISR.
+ *
+ * @param wait_queue Pointer to wait queue the current thread pends on
+ * @param flags State of interrupts mask returned by sched_lock()
+ * @param ticks Number of system ticks to wait, SCHED_TIMEOUT_FOREVER or SCHED_TIMEOUT_NO_WAIT
+ *
+ * @return 0 The thread was woken up
+ *         -EAGAIN Timeout expired
+ */
+int sched_thread_pend_timeout(slist_t *wait_queue, uint32_t flags, uint32_t ticks);
+
+/* @brief Wake up first thread waiting in a wait queue
+ *
+ * Must be called with scheduler lock held. The woken up thread is added to ready threads pool.
+ *
+ * @param wait_queue Pointer to wait queue
+ *
+ * @return Pointer to woken up thread, NULL if the wait queue was empty
+ */
+thread_t *sched_thread_wake_one(slist_t *wait_queue);
+
+/* @brief Wake up all threads waiting in a wait queue
+ *
+ * Must be called with scheduler lock held. Woken up threads are added to ready threads pool.
+ *
+ * @param wait_queue Pointer to wait queue
+ */
+void sched_threads_waiting_resume(slist_t *wait_queue);
+
+/* @brief Wake up all threads waiting in a wait queue that match a condition
+ *
+ * Must be called with scheduler lock held. The wait queue is traversed once, in order of pending. Woken up threads
+ * are added to ready threads pool.
+ *
+ * @param wait_queue Pointer to wait queue
+ * @param match Function called for each waiting thread
+ * @param arg Argument passed to the match function
+ *
+ * @return Number of woken up threads
+ */
+uint32_t sched_threads_wake_match(slist_t *wait_queue, sched_wake_match_t match, void *arg);
+
+/* @brief Move all threads waiting in a wait queue to end of other wait queue
+ *
+ * Must be called with scheduler lock held. Threads keep pending, in the same order. Their pend timeouts are
+ * cancelled, the wait they were given timeout for is considered to be satisfied.
+ *
+ * @param from Pointer to wait queue threads are taken from
+ * @param to Pointer to wait queue threads are moved to
+ */
+void sched_threads_requeue(slist_t *from, slist_t *to);
+
+/* @brief Account a context switch
+ *
+ * Called by PendSV handler with interrupts disabled, just before the stack of next thread is restored. Must not be
+ * called from any other place.
+ *
+ * @param prev Pointer to thread that is switched out
+ * @param next Pointer to thread that is switched in
+ */
+void sched_switch_hook(thread_t *prev, thread_t *next);
+
+/* @brief Put ended threads that were switched out into free threads pool
+ *
+ * Ending thread can't release its thread object by itself, because the object is used by the context switch. The
+ * context switch puts it on zombie threads list instead. The function must be called with scheduler lock held, from
+ * thread context.
+ */
+void sched_zombies_reclaim();
+
+#ifdef THREAD_STATS_ENABLED
+/* @brief Get number of cycles the current thread is executed since it was switched in
+ *
+ * Must be called with scheduler lock held.
+ */
+uint32_t sched_current_slice_cycles_get();
+
+/* @brief Get total number of cycles accounted to all threads, including ongoing time slice
+ *
+ * Must be called with scheduler lock held.
+ */
+uint64_t sched_total_cycles_get();
+#endif /* THREAD_STATS_ENABLED */
+
 #endif /* __SYS_SCHEDULER_H__ */
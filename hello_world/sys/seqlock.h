@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __SYS_SEQLOCK_H__
+#define __SYS_SEQLOCK_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/** @file Sequence lock for tear-free snapshots of data with a single writer and many readers.
+ *
+ * Readers never block and don't disable interrupts. A reader copies the data and checks if the sequence number
+ * changed meanwhile, if it did the copy is torn and the reader repeats it. The writer never waits for readers.
+ *
+ * Sequence number is odd while the writer updates the data. A reader that preempts the writer in the middle of an
+ * update can't make progress until the writer completes, so the writer must run in a context that readers can't
+ * preempt, e.g. in an ISR with priority not lower than any ISR that reads the data. Readers may run in any
+ * context, also in ISRs.
+ *
+ * Example:
+ *
+ * do {
+ *      seq = seqlock_read_begin(&lock);
+ *      copy = data;
+ * } while (seqlock_read_retry(&lock, seq));
+ */
+
+/* Fences order accesses to the sequence number and the protected data. Those are DMB on Cortex-M. */
+#define SEQLOCK_READ_BARRIER() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#define SEQLOCK_WRITE_BARRIER() __atomic_thread_fence(__ATOMIC_RELEASE)
+
+typedef struct sys_seqlock {
+	volatile uint32_t sequence;
+} seqlock_t;
+
+#define SEQLOCK_INITIALIZER                                                                        \
+	{                                                                                          \
+		.sequence = 0                                                                      \
+	}
+
+/* @brief Initialize a sequence lock
+ *
+ * @param lock Pointer to sequence lock
+ */
+static inline void seqlock_init(seqlock_t *lock)
+{
+	lock->sequence = 0;
+}
+
+/* @brief Begin a read of protected data
+ *
+ * @param lock Pointer to sequence lock
+ *
+ * @return Sequence number to be passed to seqlock_read_retry()
+ */
+static inline uint32_t seqlock_read_begin(const seqlock_t *lock)
+{
+	uint32_t sequence = lock->sequence;
+
+	SEQLOCK_READ_BARRIER();
+
+	return sequence;
+}
+
+/* @brief End a read of protected data and check if it has to be repeated
+ *
+ * @param lock Pointer to sequence lock
+ * @param sequence Sequence number returned by seqlock_read_begin()
+ *
+ * @return true if the data was updated during the read and the read must be repeated, false otherwise
+ */
+static inline bool seqlock_read_retry(const seqlock_t *lock, uint32_t sequence)
+{
+	SEQLOCK_READ_BARRIER();
+
+	return (sequence & 1) != 0 || lock->sequence != sequence;
+}
+
+/* @brief Begin an update of protected data
+ *
+ * @param lock Pointer to sequence lock
+ */
+static inline void seqlock_write_begin(seqlock_t *lock)
+{
+	lock->sequence = lock->sequence + 1;
+
+	SEQLOCK_WRITE_BARRIER();
+}
+
+/* @brief End an update of protected data
+ *
+ * @param lock Pointer to sequence lock
+ */
+static inline void seqlock_write_end(seqlock_t *lock)
+{
+	SEQLOCK_WRITE_BARRIER();
+
+	lock->sequence = lock->sequence + 1;
+}
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __SYS_SEQLOCK_H__ */
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "spin_lock.h"
+#include "soft_timer.h"
+#include "work.h"
+#include "../tools/dlist.h"
+#include "../tools/misc.h"
+#include "../tools/slist.h"
+#include "../tools/timer_wheel.h"
+
+#define SOFT_TIMER_OBJECT_GET(dlist_node_ptr) CONTAINER_OF(dlist_node_ptr, soft_timer_t, wheel_node.node)
+
+static timer_wheel_t m_soft_timer_wheel;
+static spin_lock_t m_soft_timer_lock;
+
+static void soft_timer_work_handler(work_t *work)
+{
+	soft_timer_t *timer = CONTAINER_OF(work, soft_timer_t, work);
+
+	timer->handler(timer);
+}
+
+void soft_timer_init(soft_timer_t *timer, soft_timer_handler_t handler,
+		     SOFT_TIMER_CONTEXT_T context)
+{
+	assert(timer);
+	assert(handler);
+
+	timer->wheel_node.node.next = NULL;
+	timer->wheel_node.node.prev = NULL;
+	timer->period = 0;
+	timer->handler = handler;
+	timer->context = context;
+	timer->expiry_count = 0;
+
+	work_init(&timer->work, soft_timer_work_handler);
+}
+
+void soft_timer_start(soft_timer_t *timer, uint32_t ticks, uint32_t period)
+{
+	assert(timer);
+
+	uint32_t flags = spin_lock_irq_store(&m_soft_timer_lock);
+
+	if (timer_wheel_node_is_active(&timer->wheel_node)) {
+		timer_wheel_remove(&timer->wheel_node);
+	}
+
+	timer->period = period;
+	timer->expiry_count = 0;
+
+	/* Wheel tick is the next tick to be processed, so expiry at it means the next SysTick */
+	timer_wheel_add(&m_soft_timer_wheel, &timer->wheel_node,
+			m_soft_timer_wheel.tick + (ticks != 0 ? ticks - 1 : 0));
+
+	spin_unlock_irq_restore(&m_soft_timer_lock, flags);
+}
+
+bool soft_timer_stop(soft_timer_t *timer)
+{
+	assert(timer);
+
+	bool running = false;
+	uint32_t flags = spin_lock_irq_store(&m_soft_timer_lock);
+
+	if (timer_wheel_node_is_active(&timer->wheel_node)) {
+		timer_wheel_remove(&timer->wheel_node);
+		running = true;
+	}
+
+	timer->period = 0;
+
+	spin_unlock_irq_restore(&m_soft_timer_lock, flags);
+
+	if (timer->context == SOFT_TIMER_CONTEXT_WORK) {
+		work_cancel(&timer->work);
+	}
+
+	return running;
+}
+
+bool soft_timer_is_running(soft_timer_t *timer)
+{
+	assert(timer);
+
+	uint32_t flags = spin_lock_irq_store(&m_soft_timer_lock);
+	bool running = timer_wheel_node_is_active(&timer->wheel_node);
+	spin_unlock_irq_restore(&m_soft_timer_lock, flags);
+
+	return running;
+}
+
+void soft_timer_subsys_init()
+{
+	timer_wheel_init(&m_soft_timer_wheel, 0);
+}
+
+void soft_timer_tick_announce()
+{
+	dlist_t expired;
+	slist_t fired;
+	dlist_node_t *node;
+	slist_node_t *fired_node;
+
+	dlist_init(&expired);
+	slist_init(&fired);
+
+	uint32_t flags = spin_lock_irq_store(&m_soft_timer_lock);
+
+	timer_wheel_advance(&m_soft_timer_wheel, &expired);
+
+	/* Periodic timers are added again before handlers are called, based on expiry instead of current tick, so
+	 * those don't drift. Handlers are called without the lock held, so they may start or stop timers.
+	 */
+	while ((node = dlist_head_get(&expired)) != NULL) {
+		soft_timer_t *timer = SOFT_TIMER_OBJECT_GET(node);
+
+		timer->expiry_count++;
+
+		if (timer->period != 0) {
+			timer_wheel_add(&m_soft_timer_wheel, &timer->wheel_node,
+					timer->wheel_node.expiry + timer->period);
+		}
+
+		if (timer->context == SOFT_TIMER_CONTEXT_WORK) {
+			/* If the previous expiry is still queued the work is submitted once */
+			work_submit(&g_sys_work_queue, &timer->work);
+		} else {
+			/* Periodic timer node is back in the wheel, so ISR handlers are collected through the work
+			 * item node that isn't used in this context.
+			 */
+			slist_tail_put(&fired, &timer->work.node);
+		}
+	}
+
+	spin_unlock_irq_restore(&m_soft_timer_lock, flags);
+
+	while ((fired_node = slist_head_get(&fired)) != NULL) {
+		soft_timer_t *timer = CONTAINER_OF(fired_node, soft_timer_t, work.node);
+
+		timer->handler(timer);
+	}
+}
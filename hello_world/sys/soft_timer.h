@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __SYS_SOFT_TIMER_H__
+#define __SYS_SOFT_TIMER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "work.h"
+#include "../tools/timer_wheel.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/** @file Software timers with one-shot and periodic mode.
+ *
+ * A timer costs a small object instead of a thread. Timers are kept on a hierarchical timing wheel advanced from
+ * SysTick handler, so start and stop are O(1) and the cost of a tick doesn't depend on number of running timers.
+ *
+ * Timer handler is called from SysTick context or from the system work queue thread, depending on the timer
+ * configuration. A handler called from SysTick context must be short and must not block.
+ *
+ * The name soft_timer_t avoids a clash with POSIX timer_t provided by the C library headers.
+ */
+
+typedef enum SOFT_TIMER_CONTEXT {
+	/* Handler is called from SysTick handler */
+	SOFT_TIMER_CONTEXT_ISR,
+	/* Handler is called from system work queue thread */
+	SOFT_TIMER_CONTEXT_WORK,
+} SOFT_TIMER_CONTEXT_T;
+
+struct sys_soft_timer;
+
+typedef void (*soft_timer_handler_t)(struct sys_soft_timer *timer);
+
+typedef struct sys_soft_timer {
+	timer_wheel_node_t wheel_node;
+	/* Number of ticks between expiries of periodic timer, zero for one-shot timer */
+	uint32_t period;
+	soft_timer_handler_t handler;
+	SOFT_TIMER_CONTEXT_T context;
+	/* Used to call the handler in system work queue */
+	work_t work;
+	/* Number of expiries since the timer was started */
+	uint32_t expiry_count;
+} soft_timer_t;
+
+/* @brief Initialize a timer
+ *
+ * @param timer Pointer to timer object
+ * @param handler Function called when the timer expires
+ * @param context Context the handler is called from
+ */
+void soft_timer_init(soft_timer_t *timer, soft_timer_handler_t handler,
+		     SOFT_TIMER_CONTEXT_T context);
+
+/* @brief Start a timer, a running timer is restarted
+ *
+ * The function may be called from any context, including the timer handler.
+ *
+ * @param timer Pointer to timer object
+ * @param ticks Number of system ticks to first expiry, minimum is one tick
+ * @param period Number of system ticks between next expiries, zero for one-shot timer
+ */
+void soft_timer_start(soft_timer_t *timer, uint32_t ticks, uint32_t period);
+
+/* @brief Stop a timer
+ *
+ * The function may be called from any context. A handler that is already queued to the system work queue is
+ * cancelled, but a handler that is being executed completes.
+ *
+ * @param timer Pointer to timer object
+ *
+ * @return true if the timer was running, false otherwise
+ */
+bool soft_timer_stop(soft_timer_t *timer);
+
+/* @brief Check if a timer is running */
+bool soft_timer_is_running(soft_timer_t *timer);
+
+/* @brief Initialize software timers subsystem
+ *
+ * Must be called during system initialization, before SysTick is started. Timers with SOFT_TIMER_CONTEXT_WORK
+ * require the system work queue to be initialized too.
+ */
+void soft_timer_subsys_init();
+
+/* @brief Announce a system tick to software timers
+ *
+ * Must be called from SysTick handler only.
+ */
+void soft_timer_tick_announce();
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __SYS_SOFT_TIMER_H__ */
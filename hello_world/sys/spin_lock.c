@@ -5,14 +5,31 @@
  */
 #include "irq.h"
 #include "spin_lock.h"
+#include "trace.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
 
+#ifdef TRACE_ENABLED
+/* Check before acquire if the lock is held. It is not atomic with the acquire, so it is a hint for tracing only. */
+#define SPIN_LOCK_CONTEND_TRACE(lock)                                                              \
+	do {                                                                                       \
+		if ((lock)->lock == SPIN_LOCK_LOCKED) {                                            \
+			TRACE_EVENT(TRACE_EVENT_LOCK_CONTEND, 0, (lock));                          \
+		}                                                                                  \
+	} while (0)
+#else
+#define SPIN_LOCK_CONTEND_TRACE(lock)                                                              \
+	do {                                                                                       \
+	} while (0)
+#endif /* TRACE_ENABLED */
+
 /** This spin lock can't be used by interrupts because it can hang indefinitely */
 void spin_lock(spin_lock_t *lock)
 {
+	SPIN_LOCK_CONTEND_TRACE(lock);
+
 	asm("1:     movs    r2, %[sp_locked]\n\t"
 	    "       ldrex   r1, [%[lock]]\n\t" /* Load sinlock value */
 	    "       teq     r1, r2\n\t" /* Check if it is locked */
@@ -27,6 +44,8 @@ void spin_lock(spin_lock_t *lock)
 	    :
 	    : [lock] "r"(&lock->lock), [sp_locked] "i"(SPIN_LOCK_LOCKED)
 	    : "cc", "r1", "r2", "r3", "memory");
+
+	TRACE_EVENT(TRACE_EVENT_LOCK_ACQUIRE, 0, lock);
 }
 
 void spin_unlock(spin_lock_t *lock)
@@ -50,6 +69,8 @@ void spin_unlock(spin_lock_t *lock)
  */
 static void spin_lock_no_wfe(spin_lock_t *lock)
 {
+	SPIN_LOCK_CONTEND_TRACE(lock);
+
 	asm("1:     movs    r2, %[sp_locked]\n\t"
 	    "       ldrex   r1, [%[lock]]\n\t" /* Load sinlock value */
 	    "       teq     r1, r2\n\t" /* Check if it is locked */
@@ -63,6 +84,8 @@ static void spin_lock_no_wfe(spin_lock_t *lock)
 	    :
 	    : [lock] "r"(&lock->lock), [sp_locked] "i"(SPIN_LOCK_LOCKED)
 	    : "cc", "r1", "r2", "r3", "memory");
+
+	TRACE_EVENT(TRACE_EVENT_LOCK_ACQUIRE, 0, lock);
 }
 
 void spin_lock_irq(spin_lock_t *lock)
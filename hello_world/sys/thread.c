@@ -11,14 +11,26 @@
 
 #include <drivers/nrfx_common.h>
 
+#include "heap.h"
+#include "ramfunc.h"
 #include "thread.h"
 #include "scheduler.h"
 #include "spin_lock.h"
+#include "tls.h"
+#include "../tools/hashmap.h"
 #include "../tools/misc.h"
 #include "../tools/slist.h"
 
+/* Number of thread objects for threads created at runtime. Threads defined with THREAD_DEFINE() are not counted. */
+#ifndef THREAD_MAX_NUM
 #define THREAD_MAX_NUM 4
-#define THREAD_MAX_TOTAL THREAD_MAX_NUM + 2 /* Add main and Idle threads to total count */
+#endif /* THREAD_MAX_NUM */
+#define THREAD_MAX_TOTAL (THREAD_MAX_NUM + 2) /* Add main and Idle threads to total count */
+
+/* Number of slots in thread ID map, power of two. It has to fit all live threads, including THREAD_DEFINE() ones. */
+#ifndef THREAD_ID_MAP_SIZE
+#define THREAD_ID_MAP_SIZE 16
+#endif /* THREAD_ID_MAP_SIZE */
 
 #define THREAD_DEBUG_ENABLED 1 /* TODO move into KConfig in future */
 
@@ -37,6 +49,11 @@ static thread_t m_thread[THREAD_MAX_TOTAL];
  */
 static slist_t m_free_thread_pool;
 
+/* Live threads by ID. Guarded by scheduler lock, like the free thread objects pool. */
+static hashmap_entry_t m_thread_id_entries[THREAD_ID_MAP_SIZE];
+static hashmap_t m_thread_ids;
+static sys_thread_id_t m_thread_id_next;
+
 static thread_t *m_idle_thread;
 #define IDLE_STACK_SIZE                                                                            \
 	(FUNCTION_FRAME_SIZE_TOTAL +                                                               \
@@ -49,12 +66,19 @@ static thread_t *m_main_thread;
 static uint32_t m_thread_end_count;
 #endif /* THREAD_DEBUG_ENABLED */
 
+/* Bounds of thread_static section are provided by linker. Those are weak because the section doesn't exist if there
+ * is no THREAD_DEFINE() in an application.
+ */
+extern const thread_static_t __start_thread_static[] __attribute__((weak));
+extern const thread_static_t __stop_thread_static[] __attribute__((weak));
+
 static void m_thread_cleanup();
 static thread_t *main_thread_init();
-static void thread_ctx_init(thread_ctx_t *ctx, thread_handler_t handler, stack_ptr_t stack_ptr,
-			    uint32_t stack_size);
+static void thread_ctx_init(thread_ctx_t *ctx, thread_entry_t entry, void *arg,
+			    stack_ptr_t stack_ptr, uint32_t stack_size);
 static void idle_thread();
 static int idle_thread_init();
+static void thread_static_start();
 
 /* @brief this functiun should not be calle anywhere. It is just a place holder for asm inline.
  *
@@ -63,11 +87,57 @@ static int idle_thread_init();
  * 
  * This is a workaround to make generation of offets to be done on build time and make possible
  * to use those from assembler code. For "C" code use offsetof() instead.
+ *
+ * The function is marked as used, otherwise link time optimization drops it together with the symbols.
  */
-void __thread_symbols_offsets()
+__attribute__((used)) void __thread_symbols_offsets()
 {
 	GEN_ASM_OFFSET_SYM(thread_t, ctx_ptr);
 	GEN_ASM_OFFSET_NESTED_SYM(thread_t, ctx_ptr, stack_ptr);
+	GEN_ASM_OFFSET_SYM(thread_t, tls_ptr);
+}
+
+/* @brief Assign an ID to a thread and add it to thread ID map
+ *
+ * Must be called with scheduler lock held or from system initialization code. IDs are not reused until the counter
+ * wraps around, then IDs of threads that are still alive are skipped.
+ *
+ * @return 0 ID assigned
+ *         -ENOMEM Thread ID map is full
+ */
+static int thread_id_assign(thread_t *thread)
+{
+	while (m_thread_id_next == THREAD_ID_INVALID || hashmap_get(&m_thread_ids, m_thread_id_next) != NULL) {
+		m_thread_id_next++;
+	}
+
+	sys_thread_id_t id = m_thread_id_next++;
+	int err = hashmap_put(&m_thread_ids, id, thread);
+
+	thread->id = (err == 0) ? id : THREAD_ID_INVALID;
+
+	return err;
+}
+
+/* @brief Set up thread-local data of a thread
+ *
+ * TLS area is taken from top of the thread stack.
+ *
+ * @return Size of the stack left for the thread
+ */
+static uint32_t thread_local_init(thread_t *thread, stack_ptr_t stack_ptr, uint32_t stack_size)
+{
+	uint32_t tls_size = tls_area_size();
+
+	assert(stack_size > tls_size + FUNCTION_FRAME_SIZE_TOTAL);
+
+	thread->tls_ptr = tls_area_init(stack_ptr + stack_size - tls_size);
+
+#ifdef THREAD_REENT_ENABLED
+	_REENT_INIT_PTR(&thread->reent);
+#endif /* THREAD_REENT_ENABLED */
+
+	return stack_size - tls_size;
 }
 
 static void m_thread_cleanup()
@@ -83,8 +153,7 @@ static void m_thread_cleanup()
 		return;
 	}
 
-	current->ctx_ptr.status |= THREAD_STATUS_ENDED;
-
+	/* Scheduler marks the thread as ended */
 	sched_thread_end(current);
 
 	/* We can't get back here. In such case there were no thread swap done. */
@@ -114,16 +183,31 @@ static thread_t *main_thread_init()
 	ctx->stack_ptr = NULL;
 	ctx->status = THREAD_STATUS_ACTIVE;
 
+	/* TLS area of main thread is static, the main thread may already use it */
+	thread->tls_ptr = tls_main_init();
+#ifdef THREAD_REENT_ENABLED
+	_REENT_INIT_PTR(&thread->reent);
+	_impure_ptr = &thread->reent;
+#endif /* THREAD_REENT_ENABLED */
+
 	/* Setup firts executing thread */
 	thread_node->next = NULL;
+	(void)thread_id_assign(thread);
 
 	return thread;
 }
 
 static void idle_thread()
 {
-	/* Currently does nothing except busy looping until interrupted and switched to other thread */
+	uint32_t flags;
+
+	/* Currently does nothing except reclaim of ended threads and busy looping until interrupted and switched to
+	 * other thread.
+	 */
 	while (1) {
+		flags = sched_lock();
+		sched_zombies_reclaim();
+		sched_unlock(flags);
 	};
 }
 
@@ -138,17 +222,25 @@ static int idle_thread_init()
 	thread_ctx_t *idle_ctx = &m_idle_thread->ctx_ptr;
 	assert(idle_ctx != NULL);
 
-	thread_ctx_init(idle_ctx, idle_thread, stack_idle_thread, sizeof(stack_idle_thread));
+	thread_ctx_init(idle_ctx, (thread_entry_t)idle_thread, NULL, stack_idle_thread,
+			sizeof(stack_idle_thread));
+
+	/* Idle thread stack is too small for TLS area, it doesn't use thread-local variables */
+	m_idle_thread->tls_ptr = NULL;
+#ifdef THREAD_REENT_ENABLED
+	_REENT_INIT_PTR(&m_idle_thread->reent);
+#endif /* THREAD_REENT_ENABLED */
 
 	idle_thread_node->next = NULL;
+	(void)thread_id_assign(m_idle_thread);
 
 	idle_ctx->status &= (~THREAD_STATUS_STARTING);
 	/* What flad to use for idle stack that is ready but not in a ready threads pool? */
 	return 0;
 }
 
-static void thread_ctx_init(thread_ctx_t *ctx, thread_handler_t handler, stack_ptr_t stack_ptr,
-			    uint32_t stack_size)
+static void thread_ctx_init(thread_ctx_t *ctx, thread_entry_t entry, void *arg,
+			    stack_ptr_t stack_ptr, uint32_t stack_size)
 {
 	/* Stack if filled bottom-up. On create there is stored initail function frame so
 	 * adjust actual pointer to avoid overwrite it. The function frame is expected by 
@@ -162,15 +254,16 @@ static void thread_ctx_init(thread_ctx_t *ctx, thread_handler_t handler, stack_p
 		(hw_function_frame_t *)(stack_ptr + stack_size - FUNCTION_FRAME_HW_STORED_SIZE);
 
 	hw_frame->xpsr = 0x01000000;
-	hw_frame->pc = (uint32_t)handler;
+	hw_frame->pc = (uint32_t)entry;
 	hw_frame->lr = (uint32_t)m_thread_cleanup; /* Return to thread mode with PSP */
 #if defined(THREAD_DEBUG_ENABLED)
 	hw_frame->r12 = 0xFF0C;
 	hw_frame->r3 = 0xFF03;
 	hw_frame->r2 = 0xFF02;
 	hw_frame->r1 = 0xFF01;
-	hw_frame->r0 = 0xFF00;
 #endif /* THREAD_DEBUG_ENABLED */
+	/* R0 is the first argument of the entry function (AAPCS) */
+	hw_frame->r0 = (uint32_t)arg;
 
 	/* SW function frame is at top of the stack */
 	sw_function_frame_t *sw_frame = (sw_function_frame_t *)ctx->stack_ptr;
@@ -197,11 +290,17 @@ int thread_init()
 	/* Lock is not needed here because this must be called from system initialization code,
 	 * hence no thread switching may happen.
 	 */
+	/* Kernel functions linked to RAM are executed once the scheduler runs */
+	ramfunc_init();
+
 	slist_init(&m_free_thread_pool);
+	hashmap_init(&m_thread_ids, m_thread_id_entries, THREAD_ID_MAP_SIZE);
+	m_thread_id_next = THREAD_ID_INVALID + 1;
 
 	/* Put all contexts into a free context pool*/
 	for (int idx = 0; idx < THREAD_MAX_TOTAL; idx++) {
 		m_thread[idx].ctx_ptr.status = THREAD_STATUS_NONE;
+		m_thread[idx].id = THREAD_ID_INVALID;
 		slist_init(&m_thread[idx].wait_queue);
 		slist_tail_put(&m_free_thread_pool, &m_thread[idx].list_node);
 	}
@@ -217,37 +316,129 @@ int thread_init()
 
 	idle_thread_init();
 
+	/* Malloc lock is a kernel mutex, it has to be ready before the scheduler runs other threads */
+	heap_init();
+
 	scheduler_init(main_thread, m_idle_thread);
+
+	thread_static_start();
+
 	return 0;
 }
 
+static void thread_static_init(const thread_static_t *thread_def)
+{
+	thread_t *thread = thread_def->thread;
+	thread_ctx_t *ctx = &thread->ctx_ptr;
+
+	slist_init(&thread->wait_queue);
+
+	int err = thread_id_assign(thread);
+	assert(err == 0);
+	(void)err;
+
+	uint32_t stack_size = thread_local_init(thread, thread_def->stack_ptr, thread_def->stack_size);
+
+	thread_ctx_init(ctx, thread_def->entry, NULL, thread_def->stack_ptr, stack_size);
+
+	thread->list_node.next = NULL;
+	thread->pend_queue = NULL;
+	ctx->status &= (~THREAD_STATUS_STARTING);
+
+	sched_ready_enqueu(thread);
+}
+
+/* @brief Start all threads defined by THREAD_DEFINE()
+ *
+ * Lock is not needed here because this must be called from system initialization code, hence no thread switching
+ * may happen. Threads are put into ready threads pool in order of prio value, threads with equal prio in link order.
+ */
+static void thread_static_start()
+{
+	const thread_static_t *thread_def;
+	int32_t prio = -1;
+
+	while (1) {
+		int32_t next_prio = INT32_MAX;
+
+		/* Find lowest prio value that wasn't started yet */
+		for (thread_def = __start_thread_static; thread_def < __stop_thread_static; thread_def++) {
+			if (thread_def->prio > prio && thread_def->prio < next_prio) {
+				next_prio = thread_def->prio;
+			}
+		}
+
+		if (next_prio == INT32_MAX) {
+			break;
+		}
+
+		for (thread_def = __start_thread_static; thread_def < __stop_thread_static; thread_def++) {
+			if (thread_def->prio == next_prio) {
+				thread_static_init(thread_def);
+			}
+		}
+
+		prio = next_prio;
+	}
+}
+
 int thread_create(thread_t **thread, thread_handler_t handler, stack_ptr_t stack_ptr,
 		  uint32_t stack_size)
 {
-	assert(handler);
+	/* Handler without arguments ignores R0, so it can share the entry path with other threads */
+	return thread_create_arg(thread, (thread_entry_t)handler, NULL, stack_ptr, stack_size);
+}
+
+int thread_create_arg(thread_t **thread, thread_entry_t entry, void *arg, stack_ptr_t stack_ptr,
+		      uint32_t stack_size)
+{
+	assert(entry);
 	assert(stack_ptr);
 	assert(stack_size != 0);
 
-	/* TODO: Add lock here, there is possible race while getting context from multiple execution contexts */
+	/* Free threads pool is released to by scheduler with its lock held, use the same lock here. Ended threads are
+	 * reclaimed first, so a thread that has just ended may be reused.
+	 */
+	uint32_t flags = sched_lock();
+	sched_zombies_reclaim();
 	slist_node_t *thread_node = slist_head_get(&m_free_thread_pool);
 
 	if (thread_node == NULL) {
+		sched_unlock(flags);
 		return -ENOMEM;
 	}
 
 	thread_t *new_thread = THREAD_OBJECT_GET(thread_node);
+
+	if (thread_id_assign(new_thread) != 0) {
+		slist_head_put(&m_free_thread_pool, thread_node);
+		sched_unlock(flags);
+		return -ENOMEM;
+	}
+	sched_unlock(flags);
+
 	thread_ctx_t *ctx = &new_thread->ctx_ptr;
 	assert(ctx->status == THREAD_STATUS_NONE);
 
-	thread_ctx_init(ctx, handler, stack_ptr, stack_size);
+	stack_size = thread_local_init(new_thread, stack_ptr, stack_size);
 
-	thread_node->next = NULL;
-	sched_ready_enqueu(new_thread);
+	thread_ctx_init(ctx, entry, arg, stack_ptr, stack_size);
 
+#ifdef THREAD_STATS_ENABLED
+	/* Thread object may be re-used after other thread ended */
+	memset(&new_thread->stats, 0, sizeof(new_thread->stats));
+#endif /* THREAD_STATS_ENABLED */
+
+	thread_node->next = NULL;
+	new_thread->pend_queue = NULL;
 	*thread = new_thread;
 
 	ctx->status &= (~THREAD_STATUS_STARTING);
 
+	flags = sched_lock();
+	sched_ready_enqueu(new_thread);
+	sched_unlock(flags);
+
 	return 0;
 }
 
@@ -268,7 +459,141 @@ int thread_join(thread_t *thread)
 	/* TODO: in future add timeout: sleeping queue for wakeups and system clock to keep passing time. */
 }
 
+int thread_suspend(thread_t *thread)
+{
+	assert(thread);
+
+	if (thread == m_idle_thread) {
+		return -EINVAL;
+	}
+
+	/* Suspend may need a thread switch that can't be done from ISR */
+	if (__get_IPSR() != 0) {
+		return -EPERM;
+	}
+
+	return sched_thread_suspend(thread);
+}
+
+int thread_resume(thread_t *thread)
+{
+	assert(thread);
+
+	return sched_thread_resume(thread);
+}
+
+int thread_abort(thread_t *thread)
+{
+	assert(thread);
+
+	if (thread == m_idle_thread) {
+		return -EINVAL;
+	}
+
+	/* Abort may need a thread switch that can't be done from ISR */
+	if (__get_IPSR() != 0) {
+		return -EPERM;
+	}
+
+	sched_thread_end(thread);
+
+	return 0;
+}
+
 void thread_free_put(thread_t *thread)
 {
+	/* ID of an ended thread is not valid any more, no matter where the thread object comes from */
+	(void)hashmap_remove(&m_thread_ids, thread->id);
+	thread->id = THREAD_ID_INVALID;
+
+	/* Threads defined with THREAD_DEFINE() do not come from the pool, so they are not returned to it */
+	if (thread < &m_thread[0] || thread >= &m_thread[THREAD_MAX_TOTAL]) {
+		return;
+	}
+
+	/* Thread object is going to be reused by thread_create() */
+	thread->ctx_ptr.status = THREAD_STATUS_NONE;
+
+	/* Put at tail, so the object that has just ended is reused as late as possible */
 	slist_tail_put(&m_free_thread_pool, &thread->list_node);
 }
+
+thread_t *thread_get_by_id(sys_thread_id_t id)
+{
+	uint32_t flags = sched_lock();
+	thread_t *thread = hashmap_get(&m_thread_ids, id);
+	sched_unlock(flags);
+
+	return thread;
+}
+
+#ifdef THREAD_STATS_ENABLED
+static bool thread_is_alive(const thread_t *thread)
+{
+	return (thread->ctx_ptr.status & (THREAD_STATUS_NONE | THREAD_STATUS_ENDED)) == 0;
+}
+
+/* @brief Store statistics of a thread in a snapshot entry, must be called with scheduler lock held */
+static void thread_stats_entry_store(thread_stats_entry_t *entry, const thread_t *thread)
+{
+	entry->thread = thread;
+	entry->stats = thread->stats;
+
+	if (thread == sched_current_thread_get()) {
+		uint32_t slice = sched_current_slice_cycles_get();
+
+		entry->stats.runtime_cycles += slice;
+		if (slice > entry->stats.max_slice_cycles) {
+			entry->stats.max_slice_cycles = slice;
+		}
+	}
+}
+
+uint32_t thread_stats_snapshot(thread_stats_entry_t *entries, uint32_t max_entries,
+			       uint64_t *total_cycles)
+{
+	assert(entries);
+
+	const thread_static_t *thread_def;
+	uint32_t count = 0;
+	uint32_t flags = sched_lock();
+
+	for (int idx = 0; idx < THREAD_MAX_TOTAL && count < max_entries; idx++) {
+		if (thread_is_alive(&m_thread[idx])) {
+			thread_stats_entry_store(&entries[count++], &m_thread[idx]);
+		}
+	}
+
+	for (thread_def = __start_thread_static;
+	     thread_def < __stop_thread_static && count < max_entries; thread_def++) {
+		if (thread_is_alive(thread_def->thread)) {
+			thread_stats_entry_store(&entries[count++], thread_def->thread);
+		}
+	}
+
+	if (total_cycles != NULL) {
+		*total_cycles = sched_total_cycles_get();
+	}
+
+	sched_unlock(flags);
+
+	return count;
+}
+
+uint32_t thread_stats_idle_percent()
+{
+	thread_stats_entry_t idle;
+	uint32_t flags = sched_lock();
+
+	thread_stats_entry_store(&idle, m_idle_thread);
+	uint64_t total_cycles = sched_total_cycles_get();
+
+	sched_unlock(flags);
+
+	if (total_cycles == 0) {
+		return 0;
+	}
+
+	return (uint32_t)((idle.stats.runtime_cycles * 100) / total_cycles);
+}
+#endif /* THREAD_STATS_ENABLED */
@@ -9,10 +9,20 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <sys/reent.h>
 
 #include "../tools/to_string.h"
 #include "../tools/slist.h"
 #include "../tools/misc.h"
+#include "timeout.h"
+
+#define THREAD_STATS_ENABLED 1 /* TODO move into KConfig in future */
+
+/* Give each thread its own newlib reentrancy structure, it costs about 1 kB of RAM per thread. Newlib keeps errno and
+ * state of non-reentrant functions, e.g. strtok, in the structure. If disabled, threads share global reentrancy
+ * structure, including errno.
+ */
+#define THREAD_REENT_ENABLED 1 /* TODO move into KConfig in future */
 
 /* Defult value of stack size for new threads */
 #define THREAD_STACK_SIZE 1024
@@ -90,6 +100,7 @@ typedef struct {
 } sw_function_frame_t;
 
 typedef void (*thread_handler_t)(void);
+typedef void (*thread_entry_t)(void *arg);
 typedef uint8_t *stack_ptr_t;
 
 typedef enum {
@@ -107,6 +118,8 @@ typedef enum {
 	THREAD_STATUS_WAITING = BIT(4),
 	/* Thread had ended */
 	THREAD_STATUS_ENDED = BIT(5),
+	/* Thread is suspended, it isn't scheduled until resumed */
+	THREAD_STATUS_SUSPENDED = BIT(6),
 	THREAD_STATUS_MAX
 } THREAD_STATUS_T;
 
@@ -116,17 +129,101 @@ typedef struct sys_thread_ctx {
 	slist_node_t list_node;
 } thread_ctx_t;
 
+/* Runtime statistics of a thread. Cycles are counted by DWT CYCCNT at each context switch. */
+typedef struct sys_thread_stats {
+	/* Total number of cycles the thread was executed */
+	uint64_t runtime_cycles;
+	/* Number of times the thread was switched in */
+	uint32_t switches_in;
+	/* Number of times the thread gave up CPU: pended, joined or ended */
+	uint32_t switches_voluntary;
+	/* Number of times the thread was preempted by scheduler */
+	uint32_t switches_preempted;
+	/* Longest continuous execution of the thread in cycles */
+	uint32_t max_slice_cycles;
+} thread_stats_t;
+
+/* Thread IDs are unique among live threads. Those are not reused until 32 bit counter wraps around. */
 typedef uint32_t sys_thread_id_t;
+
+/* ID that is never assigned to a thread */
+#define THREAD_ID_INVALID 0
+
 typedef struct sys_thread {
 	/* Thread context data, these are internal information that can change without API version update. */
 	thread_ctx_t ctx_ptr;
 	/* Wait queue for threads that can called thread_join() */
 	slist_t wait_queue;
+	/* Assigned when the thread is created, THREAD_ID_INVALID when the thread object isn't used */
 	sys_thread_id_t id;
 	slist_node_t list_node;
+	/* Wait queue the thread pends on, NULL if it doesn't pend */
+	slist_t *pend_queue;
+	/* Result of last pend, set by scheduler when the thread is woken up */
+	int pend_result;
+	/* Data of a kernel object the thread pends on, valid as long as the thread pends */
+	void *pend_data;
+	/* Timeout of a pend operation */
+	timeout_t pend_timeout;
+	/* Thread pointer of thread-local storage area, NULL if the thread has no TLS */
+	void *tls_ptr;
+#ifdef THREAD_REENT_ENABLED
+	/* Newlib reentrancy structure, _impure_ptr points to it when the thread is executed */
+	struct _reent reent;
+#endif /* THREAD_REENT_ENABLED */
+#ifdef THREAD_STATS_ENABLED
+	thread_stats_t stats;
+#endif /* THREAD_STATS_ENABLED */
 } thread_t;
 
+/* Snapshot of statistics of a single thread */
+typedef struct sys_thread_stats_entry {
+	const thread_t *thread;
+	thread_stats_t stats;
+} thread_stats_entry_t;
+
+/* Descriptor of a thread defined at build time with THREAD_DEFINE(). Descriptors are collected by linker in
+ * thread_static section and are read-only.
+ */
+typedef struct sys_thread_static {
+	thread_t *thread;
+	thread_entry_t entry;
+	stack_ptr_t stack_ptr;
+	uint32_t stack_size;
+	/* Start order of static threads, lower value is started first */
+	uint8_t prio;
+} thread_static_t;
+
+/** @brief Define a thread at build time.
+ *
+ * The macro defines a thread object, its stack and a thread descriptor placed in thread_static linker section.
+ * All threads defined that way are started by thread_init(). They don't use thread objects from free threads pool,
+ * so number of such threads is limited by available memory only.
+ *
+ * Use THREAD_DECLARE() to access the thread object from other files, e.g. to join the thread.
+ *
+ * @param name Name of the thread object
+ * @param _entry Thread function, thread_handler_t or thread_entry_t that gets NULL argument
+ * @param _stack_size Size of the thread stack
+ * @param _prio Start order of the thread, threads with lower value are put into ready pool first
+ */
+#define THREAD_DEFINE(name, _entry, _stack_size, _prio)                                            \
+	THREAD_STACK_STATIC(name, _stack_size);                                                    \
+	thread_t name;                                                                             \
+	static const thread_static_t thread_static_##name                                          \
+		__attribute__((section("thread_static"), used, aligned(4))) = {                    \
+			.thread = &name,                                                           \
+			.entry = (thread_entry_t)(_entry),                                         \
+			.stack_ptr = stack_##name,                                                 \
+			.stack_size = (_stack_size),                                               \
+			.prio = (_prio),                                                           \
+		}
+
+/* @brief Declare a thread defined by THREAD_DEFINE() in other file */
+#define THREAD_DECLARE(name) extern thread_t name
+
 #define THREAD_T_CTX_PTR_OFFSET offsetof(thread_t, ctx_ptr)
+#define THREAD_T_TLS_PTR_OFFSET offsetof(thread_t, tls_ptr)
 #define THREAD_CTX_T_STACK_PTR_OFFSET offsetof(thread_ctx_t, stack_ptr)
 
 /** @brief Get thread context that is container for list_node, slist_node_t pointer.
@@ -145,6 +242,8 @@ typedef struct sys_thread {
 int thread_init();
 
 /* @brief Ceate a new thread
+ *
+ * Thread-local storage area of the thread is placed at top of its stack, see tls.h.
  *
  * @param [out] thread Pointer to store a pointer to created thread object
  * @param handler Thread function
@@ -157,6 +256,20 @@ int thread_init();
 int thread_create(thread_t **thread, thread_handler_t handler, stack_ptr_t stack_ptr,
 		  uint32_t stack_size);
 
+/* @brief Ceate a new thread that gets an argument in its entry function
+ *
+ * @param [out] thread Pointer to store a pointer to created thread object
+ * @param entry Thread function
+ * @param arg Argument passed to the thread function
+ * @param stack_ptr Pointer to thread stack
+ * @param stack_size Size of the thread stack
+ *
+ * @return 0 Thread created
+ *         -ENOMEM Not enough memory to allocate new thread object
+ */
+int thread_create_arg(thread_t **thread, thread_entry_t entry, void *arg, stack_ptr_t stack_ptr,
+		      uint32_t stack_size);
+
 /* @brief Join thread 
  * 
  * Function returns when the thread ends. In case it is still running the current thread is put into waiting queue and
@@ -166,10 +279,88 @@ int thread_create(thread_t **thread, thread_handler_t handler, stack_ptr_t stack
  */
 int thread_join(thread_t *thread);
 
+/* @brief Suspend a thread
+ *
+ * Suspended thread is not scheduled until thread_resume() is called. A thread that pends on a kernel object keeps
+ * pending; if it is woken up while suspended, it becomes ready when resumed. A thread may suspend itself, then the
+ * function returns after other thread resumes it. May not be called from ISR.
+ *
+ * @param thread Pointer to thread to suspend
+ *
+ * @return 0 Thread suspended or it was already suspended
+ *         -EINVAL Thread has ended or it is the idle thread
+ *         -EPERM Called from ISR
+ */
+int thread_suspend(thread_t *thread);
+
+/* @brief Resume a suspended thread
+ *
+ * The function may be called from ISR.
+ *
+ * @param thread Pointer to thread to resume
+ *
+ * @return 0 Thread resumed
+ *         -EINVAL Thread is not suspended
+ */
+int thread_resume(thread_t *thread);
+
+/* @brief Abort a thread
+ *
+ * The thread is ended no matter if it is ready, pends on a kernel object, waits for a timeout or is suspended.
+ * Threads that joined it are woken up. Kernel objects the thread holds, e.g. a locked mutex, are not released. A
+ * thread may abort itself, then the function doesn't return. May not be called from ISR.
+ *
+ * @param thread Pointer to thread to abort
+ *
+ * @return 0 Thread aborted or it has already ended
+ *         -EINVAL Thread is the idle thread
+ *         -EPERM Called from ISR
+ */
+int thread_abort(thread_t *thread);
+
 /* @brief Put a thread into free thread objects pool 
+ *
+ * Must be called with scheduler lock held. Status of the thread is set to THREAD_STATUS_NONE.
  *
  * @param thread Pointer to thread to store in free thread objects pool
  */
 void thread_free_put(thread_t *thread);
 
+/* @brief Find a live thread by its ID
+ *
+ * Thread ID map is a hash map, so the lookup time doesn't depend on number of threads. A thread that ends releases
+ * its ID when its object is reclaimed. The returned pointer may be used as long as the caller knows the thread is
+ * still alive. The function may be called from ISR.
+ *
+ * The kernel itself keeps thread pointers and doesn't need the lookup. It is meant for debug tools that get thread
+ * IDs from outside, e.g. from a trace dump.
+ *
+ * @param id Thread ID
+ *
+ * @return Pointer to the thread, NULL if there is no live thread with the ID
+ */
+thread_t *thread_get_by_id(sys_thread_id_t id);
+
+#ifdef THREAD_STATS_ENABLED
+/* @brief Take a snapshot of statistics of all live threads
+ *
+ * Statistics of all threads are copied at once with scheduler lock held, so they are consistent with each other.
+ * Runtime of current thread includes its ongoing time slice.
+ *
+ * @param [out] entries Array to store statistics in
+ * @param max_entries Number of elements in entries array
+ * @param [out] total_cycles Optional pointer to store total number of cycles accounted to all threads
+ *
+ * @return Number of entries stored
+ */
+uint32_t thread_stats_snapshot(thread_stats_entry_t *entries, uint32_t max_entries,
+			       uint64_t *total_cycles);
+
+/* @brief Get percentage of CPU time spent in idle thread since system start
+ *
+ * @return Idle time in percents, 0 - 100
+ */
+uint32_t thread_stats_idle_percent();
+#endif /* THREAD_STATS_ENABLED */
+
 #endif /* __SYS_THREAD_H__ */
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "spin_lock.h"
+#include "timeout.h"
+#include "../tools/misc.h"
+#include "../tools/rbtree.h"
+
+#define TIMEOUT_OBJECT_GET(timeout_node_ptr) CONTAINER_OF(timeout_node_ptr, timeout_t, node)
+
+static bool timeout_expires_before(const rbtree_node_t *a, const rbtree_node_t *b);
+
+/* Timeouts sorted by expiry tick, closest expiry is the first node of the tree */
+static rbtree_t m_timeout_queue = { .root = NULL, .first = NULL, .less = timeout_expires_before };
+static spin_lock_t m_timeout_lock;
+
+/* Updated by SysTick handler only, read it with the lock held because the access isn't atomic */
+static uint64_t m_tick;
+
+static bool timeout_expires_before(const rbtree_node_t *a, const rbtree_node_t *b)
+{
+	return TIMEOUT_OBJECT_GET(a)->expiry < TIMEOUT_OBJECT_GET(b)->expiry;
+}
+
+void timeout_init(timeout_t *timeout, timeout_handler_t handler)
+{
+	assert(timeout);
+	assert(handler);
+
+	timeout->node.left = NULL;
+	timeout->node.right = NULL;
+	timeout->node.parent = NULL;
+	timeout->expiry = 0;
+	timeout->handler = handler;
+	timeout->is_active = false;
+}
+
+void timeout_add(timeout_t *timeout, uint32_t ticks)
+{
+	assert(timeout);
+	assert(timeout->is_active == false);
+
+	uint32_t flags = spin_lock_irq_store(&m_timeout_lock);
+
+	/* Zero ticks would mean expiry in the past. Treat it as expiry on the next tick. */
+	timeout->expiry = m_tick + (ticks != 0 ? ticks : 1);
+	timeout->is_active = true;
+
+	/* Timeouts with the same expiry are kept in order of insertion */
+	rbtree_insert(&m_timeout_queue, &timeout->node);
+
+	spin_unlock_irq_restore(&m_timeout_lock, flags);
+}
+
+bool timeout_abort(timeout_t *timeout)
+{
+	assert(timeout);
+
+	bool removed = false;
+	uint32_t flags = spin_lock_irq_store(&m_timeout_lock);
+
+	if (timeout->is_active) {
+		rbtree_remove(&m_timeout_queue, &timeout->node);
+		timeout->is_active = false;
+		removed = true;
+	}
+
+	spin_unlock_irq_restore(&m_timeout_lock, flags);
+
+	return removed;
+}
+
+uint64_t timeout_tick_get()
+{
+	uint32_t flags = spin_lock_irq_store(&m_timeout_lock);
+	uint64_t tick = m_tick;
+	spin_unlock_irq_restore(&m_timeout_lock, flags);
+
+	return tick;
+}
+
+void timeout_tick_announce()
+{
+	rbtree_node_t *node;
+
+	uint32_t flags = spin_lock_irq_store(&m_timeout_lock);
+
+	m_tick++;
+
+	/* Handlers are called without the lock held, because they are allowed to use other kernel objects or add
+	 * the timeout again e.g. for periodic use. A timeout added again expires at the next tick at the earliest,
+	 * so the loop always ends.
+	 */
+	node = rbtree_first(&m_timeout_queue);
+	while (node != NULL && TIMEOUT_OBJECT_GET(node)->expiry <= m_tick) {
+		timeout_t *timeout = TIMEOUT_OBJECT_GET(node);
+
+		rbtree_remove(&m_timeout_queue, node);
+		timeout->is_active = false;
+
+		spin_unlock_irq_restore(&m_timeout_lock, flags);
+
+		timeout->handler(timeout);
+
+		flags = spin_lock_irq_store(&m_timeout_lock);
+
+		node = rbtree_first(&m_timeout_queue);
+	}
+
+	spin_unlock_irq_restore(&m_timeout_lock, flags);
+}
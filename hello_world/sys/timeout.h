@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __SYS_TIMEOUT_H__
+#define __SYS_TIMEOUT_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "../tools/rbtree.h"
+
+/** @file Timeout queue keeps objects that have to be notified after a number of system ticks.
+ *
+ * The queue is a red-black tree ordered by expiry tick, so adding and aborting a timeout is O(log n) and the closest
+ * expiry is always available without a search. It is advanced from SysTick handler. Expired timeout handlers are
+ * called from SysTick context after the timeout queue lock is released, so a handler may add the timeout again.
+ */
+
+struct sys_timeout;
+
+typedef void (*timeout_handler_t)(struct sys_timeout *timeout);
+
+typedef struct sys_timeout {
+	rbtree_node_t node;
+	/* Absolute system tick when the timeout expires */
+	uint64_t expiry;
+	timeout_handler_t handler;
+	bool is_active;
+} timeout_t;
+
+/* @brief Initialize a timeout object
+ *
+ * @param timeout Pointer to timeout object
+ * @param handler Function to be called when the timeout expires
+ */
+void timeout_init(timeout_t *timeout, timeout_handler_t handler);
+
+/* @brief Add a timeout to the timeout queue
+ *
+ * The function may be called from any context.
+ *
+ * @param timeout Pointer to timeout object, it must not be already active
+ * @param ticks Number of system ticks to expiry, minimum is one tick
+ */
+void timeout_add(timeout_t *timeout, uint32_t ticks);
+
+/* @brief Remove a timeout from the timeout queue
+ *
+ * @param timeout Pointer to timeout object
+ *
+ * @return true if the timeout was removed, false if it wasn't active (expired or never added)
+ */
+bool timeout_abort(timeout_t *timeout);
+
+/* @brief Get number of system ticks elapsed since the timeout queue was started */
+uint64_t timeout_tick_get();
+
+/* @brief Announce a system tick to the timeout queue
+ *
+ * Must be called from SysTick handler only.
+ */
+void timeout_tick_announce();
+
+#endif /* __SYS_TIMEOUT_H__ */
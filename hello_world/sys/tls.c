@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "thread.h"
+#include "tls.h"
+
+/* Bounds of TLS template, provided by tls.ld */
+extern const uint8_t __tdata_start[];
+extern const uint8_t __tdata_end[];
+extern const uint8_t __tbss_start[];
+extern const uint8_t __tbss_end[];
+
+void *g_thread_pointer;
+
+static uint8_t m_main_tls_area[TLS_MAIN_AREA_SIZE] __attribute__((aligned(8)));
+
+/* @brief Get thread pointer of current thread, called by code generated by compiler for TLS access
+ *
+ * ARM EABI requires the function to preserve all registers except R0, so it is written in assembly. Calls to the
+ * function are emitted by compiler at code generation, so it is marked as used to survive link time optimization.
+ */
+__attribute__((naked, used)) void *__aeabi_read_tp()
+{
+	__asm volatile("movw	r0, #:lower16:g_thread_pointer\n\t"
+		       "movt	r0, #:upper16:g_thread_pointer\n\t"
+		       "ldr	r0, [r0]\n\t"
+		       "bx	lr\n\t");
+}
+
+uint32_t tls_area_size()
+{
+	/* Template is a single TLS segment, .tbss follows .tdata */
+	uint32_t size = TLS_TCB_SIZE + (uint32_t)(__tbss_end - __tdata_start);
+
+	return (size + 7) & ~7UL;
+}
+
+void *tls_area_init(uint8_t *area)
+{
+	assert(area);
+	assert(((uint32_t)area & 7) == 0);
+
+	uint8_t *tls = area + TLS_TCB_SIZE;
+
+	memset(area, 0, TLS_TCB_SIZE);
+	memcpy(tls, __tdata_start, __tdata_end - __tdata_start);
+	memset(tls + (__tbss_start - __tdata_start), 0, __tbss_end - __tbss_start);
+
+	return area;
+}
+
+void *tls_main_init()
+{
+	/* Template is known at link time only */
+	assert(tls_area_size() <= TLS_MAIN_AREA_SIZE);
+
+	g_thread_pointer = tls_area_init(m_main_tls_area);
+
+	return g_thread_pointer;
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __SYS_TLS_H__
+#define __SYS_TLS_H__
+
+#include <stdint.h>
+
+/** @file Thread-local storage.
+ *
+ * Variables declared with __thread have a copy per thread. Initial values of those are kept by linker in .tdata and
+ * .tbss sections, see tls.ld. Each thread gets a TLS area at top of its stack, that is initialized from the template
+ * when the thread is created. The area layout follows ARM EABI TLS variant 1:
+ * +-----------+
+ * |   .tbss   | zeroed
+ * |   .tdata  | copied from template
+ * |    TCB    | 8 bytes, reserved
+ * +-----------+ <- thread pointer
+ *
+ * The compiler reads thread pointer of current thread with __aeabi_read_tp(). It returns g_thread_pointer, that is
+ * switched by PendSV handler together with thread context. Variables are accessed at fixed offsets from the thread
+ * pointer (local-exec model), so TLS is supported in statically linked executable only.
+ *
+ * Idle thread has no TLS area. ISRs access TLS of the thread they interrupted.
+ */
+
+/* Size of thread control block at the beginning of TLS area, defined by ARM EABI */
+#define TLS_TCB_SIZE 8
+
+/* Size of TLS area of main thread. Main thread stack is set up by startup code, so its TLS area is static. */
+#define TLS_MAIN_AREA_SIZE 128
+
+/* Thread pointer of current thread, NULL if current thread has no TLS area */
+extern void *g_thread_pointer;
+
+/* @brief Get size of TLS area required by a thread
+ *
+ * @return Size of TLS area, multiple of 8 to keep the stack aligned
+ */
+uint32_t tls_area_size();
+
+/* @brief Initialize a TLS area from the template
+ *
+ * @param area Pointer to TLS area of size returned by tls_area_size(), aligned to 8
+ *
+ * @return Thread pointer of the area
+ */
+void *tls_area_init(uint8_t *area);
+
+/* @brief Initialize TLS of main thread and make it current thread pointer
+ *
+ * Must be called during system initialization, before any thread-local variable is used.
+ *
+ * @return Thread pointer of main thread
+ */
+void *tls_main_init();
+
+#endif /* __SYS_TLS_H__ */
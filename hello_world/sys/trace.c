@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <drivers/nrfx_common.h>
+
+#include "trace.h"
+
+#ifdef TRACE_ENABLED
+
+#define TRACE_BUFFER_MASK (TRACE_BUFFER_SIZE - 1)
+
+#if (TRACE_BUFFER_SIZE & TRACE_BUFFER_MASK) != 0
+#error "TRACE_BUFFER_SIZE must be power of two"
+#endif
+
+/* Global to be easily accessible by a debugger */
+trace_record_t g_trace_buffer[TRACE_BUFFER_SIZE];
+
+/* Total number of reserved records. Slot index is the counter value modulo buffer size. */
+static volatile uint32_t m_trace_head;
+static volatile bool m_trace_enabled;
+
+/* @brief Reserve a slot in the ring buffer
+ *
+ * Exclusive access makes the reservation atomic in respect to any interrupt. If an interrupt records an event
+ * between LDREX and STREX, the STREX fails and reservation is repeated.
+ */
+static uint32_t trace_slot_reserve()
+{
+	uint32_t head;
+
+	do {
+		head = __LDREXW(&m_trace_head);
+	} while (__STREXW(head + 1, &m_trace_head) != 0);
+
+	return head;
+}
+
+void trace_init()
+{
+	/* Cycle counter is used for timestamps */
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	m_trace_head = 0;
+	m_trace_enabled = true;
+}
+
+void trace_enable(bool enable)
+{
+	m_trace_enabled = enable;
+}
+
+void trace_record(TRACE_EVENT_T event, uint16_t data, uint32_t arg)
+{
+	if (!m_trace_enabled) {
+		return;
+	}
+
+	trace_record_t *record = &g_trace_buffer[trace_slot_reserve() & TRACE_BUFFER_MASK];
+
+	record->timestamp = DWT->CYCCNT;
+	record->event = (uint8_t)event;
+	record->reserved = 0;
+	record->data = data;
+	record->arg = arg;
+}
+
+void trace_marker(uint16_t id, uint32_t value)
+{
+	trace_record(TRACE_EVENT_MARKER, id, value);
+}
+
+void trace_isr_enter()
+{
+	trace_record(TRACE_EVENT_ISR_ENTER, (uint16_t)__get_IPSR(), 0);
+}
+
+void trace_isr_exit()
+{
+	trace_record(TRACE_EVENT_ISR_EXIT, (uint16_t)__get_IPSR(), 0);
+}
+
+void trace_dump(trace_output_t output)
+{
+	assert(output);
+
+	bool enabled = m_trace_enabled;
+	m_trace_enabled = false;
+
+	/* A record reserved just before recording was stopped may be written by an interrupted context. It isn't
+	 * possible to know that, so such record may be incomplete in the dump.
+	 */
+	uint32_t head = m_trace_head;
+	uint32_t count = (head < TRACE_BUFFER_SIZE) ? head : TRACE_BUFFER_SIZE;
+
+	trace_dump_header_t header = {
+		.magic = TRACE_DUMP_MAGIC,
+		.version = TRACE_DUMP_VERSION,
+		.record_size = sizeof(trace_record_t),
+		.record_count = count,
+		.lost_count = head - count,
+		.timestamp_hz = SystemCoreClock,
+	};
+
+	output((const uint8_t *)&header, sizeof(header));
+
+	/* Oldest record is the next one to be overwritten if the buffer has wrapped */
+	for (uint32_t idx = head - count; idx != head; idx++) {
+		output((const uint8_t *)&g_trace_buffer[idx & TRACE_BUFFER_MASK], sizeof(trace_record_t));
+	}
+
+	m_trace_enabled = enabled;
+}
+
+#endif /* TRACE_ENABLED */
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __SYS_TRACE_H__
+#define __SYS_TRACE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/** @file Kernel event tracing.
+ *
+ * Events are stored as compact binary records in a RAM ring buffer. When the buffer is full the oldest records are
+ * overwritten. Records are timestamped with DWT CYCCNT. Slots in the ring are reserved with LDREX/STREX, so any
+ * context, including nested ISRs, may record an event without a lock.
+ *
+ * The buffer may be read by a debugger (g_trace_buffer) or sent to a host by trace_dump(). Use
+ * tools/trace_convert.py to convert the dump into a trace that can be opened in Perfetto UI.
+ *
+ * Thread events record thread IDs rather than addresses, because thread objects are reused. Main thread is ID 1, idle
+ * thread is ID 2. Use thread_get_by_id() to get a thread that is still alive.
+ */
+
+/* Uncomment to enable kernel event tracing. TODO move into KConfig in future */
+/* #define TRACE_ENABLED 1 */
+
+/* Number of records in the ring buffer, must be power of two */
+#define TRACE_BUFFER_SIZE 256
+
+#define TRACE_DUMP_MAGIC 0x4352544BUL /* "KTRC" */
+#define TRACE_DUMP_VERSION 2
+
+typedef enum TRACE_EVENT {
+	TRACE_EVENT_NONE,
+	/* Context switch done by PendSV, arg: next thread ID */
+	TRACE_EVENT_SWITCH,
+	/* Scheduler requested a context switch, arg: next thread ID */
+	TRACE_EVENT_SWAP_REQUEST,
+	/* Thread added to ready threads pool, arg: thread ID */
+	TRACE_EVENT_READY,
+	/* Thread put into a wait queue, arg: thread ID, data: THREAD_STATUS_T reason */
+	TRACE_EVENT_BLOCK,
+	/* Thread removed from a wait queue, arg: thread ID */
+	TRACE_EVENT_WAKE,
+	/* ISR entry, data: exception number */
+	TRACE_EVENT_ISR_ENTER,
+	/* ISR exit, data: exception number */
+	TRACE_EVENT_ISR_EXIT,
+	/* Lock acquired, arg: lock address */
+	TRACE_EVENT_LOCK_ACQUIRE,
+	/* Lock was already held when an attempt to acquire it was done, arg: lock address */
+	TRACE_EVENT_LOCK_CONTEND,
+	/* User marker, data: marker id, arg: user value */
+	TRACE_EVENT_MARKER,
+	TRACE_EVENT_MAX
+} TRACE_EVENT_T;
+
+/* Single trace record, 12 bytes */
+typedef struct sys_trace_record {
+	/* DWT CYCCNT value */
+	uint32_t timestamp;
+	/* TRACE_EVENT_T */
+	uint8_t event;
+	uint8_t reserved;
+	/* Event specific small value */
+	uint16_t data;
+	/* Event specific value, usually an object address */
+	uint32_t arg;
+} trace_record_t;
+
+/* Header sent by trace_dump() before the records */
+typedef struct sys_trace_dump_header {
+	uint32_t magic;
+	uint16_t version;
+	uint16_t record_size;
+	/* Number of records that follow the header, oldest first */
+	uint32_t record_count;
+	/* Number of records lost because the ring buffer was overwritten */
+	uint32_t lost_count;
+	/* Frequency of timestamp counter */
+	uint32_t timestamp_hz;
+} trace_dump_header_t;
+
+/* Function used by trace_dump() to send data to a host */
+typedef void (*trace_output_t)(const uint8_t *data, size_t size);
+
+#ifdef TRACE_ENABLED
+#define TRACE_EVENT(event, data, arg) trace_record((event), (uint16_t)(data), (uint32_t)(arg))
+#else
+#define TRACE_EVENT(event, data, arg)                                                              \
+	do {                                                                                       \
+	} while (0)
+#endif /* TRACE_ENABLED */
+
+/* @brief Initialize tracing and start recording
+ *
+ * Enables DWT cycle counter used for timestamps.
+ */
+void trace_init();
+
+/* @brief Enable or disable recording of events
+ *
+ * @param enable true to record events, false to drop those
+ */
+void trace_enable(bool enable);
+
+/* @brief Store an event in trace ring buffer
+ *
+ * Use TRACE_EVENT() macro instead of direct call, so events are compiled out if tracing is disabled.
+ *
+ * @param event Event type, one of TRACE_EVENT_T
+ * @param data Event specific small value
+ * @param arg Event specific value
+ */
+void trace_record(TRACE_EVENT_T event, uint16_t data, uint32_t arg);
+
+/* @brief Record a user marker
+ *
+ * @param id Marker identifier
+ * @param value User value stored with the marker
+ */
+void trace_marker(uint16_t id, uint32_t value);
+
+/* @brief Record an ISR entry, call at beginning of ISR */
+void trace_isr_enter();
+
+/* @brief Record an ISR exit, call at end of ISR */
+void trace_isr_exit();
+
+/* @brief Send content of the trace buffer to a host
+ *
+ * Recording is stopped for time of the dump and restored after, so the dump is consistent.
+ * The output is a trace_dump_header_t followed by records, oldest first.
+ *
+ * @param output Function that sends data to a host
+ */
+void trace_dump(trace_output_t output);
+
+#endif /* __SYS_TRACE_H__ */
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "thread.h"
+#include "scheduler.h"
+#include "timeout.h"
+#include "work.h"
+#include "../tools/misc.h"
+#include "../tools/slist.h"
+
+#define WORK_OBJECT_GET(work_node_ptr) CONTAINER_OF(work_node_ptr, work_t, node)
+
+work_queue_t g_sys_work_queue;
+THREAD_STACK_STATIC(sys_work_queue, WORK_SYS_QUEUE_STACK_SIZE);
+
+static void work_timeout_handler(timeout_t *timeout);
+
+/* @brief Worker thread function
+ *
+ * Work queue state is guarded by scheduler lock. It is the same lock that guards the wait queue, so a worker thread
+ * can check for pending work and go to sleep without a race with submission from ISR.
+ */
+static void work_queue_thread(void *arg)
+{
+	work_queue_t *queue = (work_queue_t *)arg;
+	slist_node_t *work_node;
+	uint32_t flags;
+
+	while (1) {
+		flags = sched_lock();
+
+		work_node = slist_head_get(&queue->pending);
+		if (work_node == NULL) {
+			/* Lock is released by pend, take it again when woken up */
+			sched_thread_pend(&queue->wait_queue, flags);
+			continue;
+		}
+
+		work_node->next = NULL;
+
+		work_t *work = WORK_OBJECT_GET(work_node);
+		work->state &= ~WORK_STATE_PENDING;
+		work->state |= WORK_STATE_RUNNING;
+
+		sched_unlock(flags);
+
+		/* The handler may submit the work item again, hence RUNNING is cleared independently of PENDING */
+		work->handler(work);
+
+		flags = sched_lock();
+		work->state &= ~WORK_STATE_RUNNING;
+		sched_unlock(flags);
+	}
+}
+
+/* @brief Submit a work item, must be called with scheduler lock held */
+static int work_submit_locked(work_queue_t *queue, work_t *work)
+{
+	if (work->state & (WORK_STATE_PENDING | WORK_STATE_DELAYED)) {
+		return -EALREADY;
+	}
+
+	work->queue = queue;
+	work->state |= WORK_STATE_PENDING;
+
+	work->node.next = NULL;
+	slist_tail_put(&queue->pending, &work->node);
+
+	/* Single work item requires single worker. If all workers are busy the item is taken by first one done. */
+	sched_thread_wake_one(&queue->wait_queue);
+
+	return 0;
+}
+
+static void work_timeout_handler(timeout_t *timeout)
+{
+	work_t *work = CONTAINER_OF(timeout, work_t, timeout);
+	uint32_t flags = sched_lock();
+
+	/* The work item may have been cancelled in the meantime */
+	if (work->state & WORK_STATE_DELAYED) {
+		work->state &= ~WORK_STATE_DELAYED;
+		work_submit_locked(work->queue, work);
+	}
+
+	sched_unlock(flags);
+}
+
+void work_init(work_t *work, work_handler_t handler)
+{
+	assert(work);
+	assert(handler);
+
+	work->node.next = NULL;
+	work->handler = handler;
+	work->queue = NULL;
+	work->state = WORK_STATE_IDLE;
+
+	timeout_init(&work->timeout, work_timeout_handler);
+}
+
+void work_queue_init(work_queue_t *queue)
+{
+	assert(queue);
+
+	slist_init(&queue->pending);
+	slist_init(&queue->wait_queue);
+}
+
+int work_queue_thread_add(work_queue_t *queue, stack_ptr_t stack_ptr, uint32_t stack_size)
+{
+	assert(queue);
+
+	thread_t *thread;
+
+	return thread_create_arg(&thread, work_queue_thread, queue, stack_ptr, stack_size);
+}
+
+int work_sys_queue_init()
+{
+	work_queue_init(&g_sys_work_queue);
+
+	return work_queue_thread_add(&g_sys_work_queue, stack_sys_work_queue,
+				     sizeof(stack_sys_work_queue));
+}
+
+int work_submit(work_queue_t *queue, work_t *work)
+{
+	assert(queue);
+	assert(work);
+
+	uint32_t flags = sched_lock();
+	int ret = work_submit_locked(queue, work);
+	sched_unlock(flags);
+
+	return ret;
+}
+
+int work_submit_delayed(work_queue_t *queue, work_t *work, uint32_t ticks)
+{
+	assert(queue);
+	assert(work);
+
+	if (ticks == 0) {
+		return work_submit(queue, work);
+	}
+
+	int ret = 0;
+	uint32_t flags = sched_lock();
+
+	if (work->state & (WORK_STATE_PENDING | WORK_STATE_DELAYED)) {
+		ret = -EALREADY;
+	} else {
+		work->queue = queue;
+		work->state |= WORK_STATE_DELAYED;
+		timeout_add(&work->timeout, ticks);
+	}
+
+	sched_unlock(flags);
+
+	return ret;
+}
+
+int work_cancel(work_t *work)
+{
+	assert(work);
+
+	uint32_t flags = sched_lock();
+
+	if (work->state & WORK_STATE_DELAYED) {
+		timeout_abort(&work->timeout);
+		work->state &= ~WORK_STATE_DELAYED;
+	} else if (work->state & WORK_STATE_PENDING) {
+		slist_find_remove(&work->queue->pending, &work->node);
+		work->state &= ~WORK_STATE_PENDING;
+	}
+
+	int ret = (work->state & WORK_STATE_RUNNING) ? -EBUSY : 0;
+
+	sched_unlock(flags);
+
+	return ret;
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __SYS_WORK_H__
+#define __SYS_WORK_H__
+
+#include <stdint.h>
+
+#include "thread.h"
+#include "timeout.h"
+#include "../tools/slist.h"
+
+/** @file Work queues allow to defer work from ISR or other thread to a worker thread context.
+ *
+ * A work queue is drained by one or more worker threads. Work items are not copied, a work item is an intrusive
+ * list node, so it must stay valid until its handler is called. Many subsystems may share one work queue and its
+ * stack instead of each having a dedicated thread.
+ */
+
+/* Default value of stack size for system work queue thread */
+#define WORK_SYS_QUEUE_STACK_SIZE THREAD_STACK_SIZE
+
+typedef enum WORK_STATE {
+	/* Work item is not queued, it may be submitted */
+	WORK_STATE_IDLE = 0,
+	/* Work item is queued in a work queue, waiting for a worker thread */
+	WORK_STATE_PENDING = BIT(0),
+	/* Work item is waiting in timeout queue to be submitted */
+	WORK_STATE_DELAYED = BIT(1),
+	/* Work item handler is executed by a worker thread */
+	WORK_STATE_RUNNING = BIT(2),
+} WORK_STATE_T;
+
+struct sys_work;
+
+typedef void (*work_handler_t)(struct sys_work *work);
+
+typedef struct sys_work_queue {
+	/* Submitted work items in order of submission */
+	slist_t pending;
+	/* Worker threads that wait for work items */
+	slist_t wait_queue;
+} work_queue_t;
+
+typedef struct sys_work {
+	slist_node_t node;
+	work_handler_t handler;
+	/* Queue the work item was submitted to */
+	work_queue_t *queue;
+	/* Used by delayed submission only */
+	timeout_t timeout;
+	uint32_t state;
+} work_t;
+
+/* System work queue, it is available after call to work_sys_queue_init() */
+extern work_queue_t g_sys_work_queue;
+
+/* @brief Initialize a work item
+ *
+ * @param work Pointer to work item
+ * @param handler Function to be called by a worker thread
+ */
+void work_init(work_t *work, work_handler_t handler);
+
+/* @brief Initialize a work queue
+ *
+ * The work queue has no worker threads after initialization. Use work_queue_thread_add() to add those.
+ *
+ * @param queue Pointer to work queue
+ */
+void work_queue_init(work_queue_t *queue);
+
+/* @brief Add a worker thread to a work queue
+ *
+ * @param queue Pointer to work queue
+ * @param stack_ptr Pointer to worker thread stack
+ * @param stack_size Size of the worker thread stack
+ *
+ * @return 0 Worker thread created
+ *         -ENOMEM Not enough memory to allocate new thread object
+ */
+int work_queue_thread_add(work_queue_t *queue, stack_ptr_t stack_ptr, uint32_t stack_size);
+
+/* @brief Initialize system work queue and start its worker thread
+ *
+ * @return 0 System work queue started
+ *         -ENOMEM Not enough memory to allocate new thread object
+ */
+int work_sys_queue_init();
+
+/* @brief Submit a work item to a work queue
+ *
+ * The function may be called from ISR.
+ *
+ * @param queue Pointer to work queue
+ * @param work Pointer to work item
+ *
+ * @return 0 Work item submitted
+ *         -EALREADY Work item is already pending or delayed, it was not submitted again
+ */
+int work_submit(work_queue_t *queue, work_t *work);
+
+/* @brief Submit a work item to a work queue after a number of system ticks
+ *
+ * The function may be called from ISR.
+ *
+ * @param queue Pointer to work queue
+ * @param work Pointer to work item
+ * @param ticks Number of system ticks to wait before submission, if 0 the work item is submitted immediately
+ *
+ * @return 0 Work item scheduled for submission
+ *         -EALREADY Work item is already pending or delayed, it was not submitted again
+ */
+int work_submit_delayed(work_queue_t *queue, work_t *work, uint32_t ticks);
+
+/* @brief Cancel a pending or delayed work item
+ *
+ * @param work Pointer to work item
+ *
+ * @return 0 Work item is not queued anymore
+ *         -EBUSY Work item handler is executed at the moment, it can't be stopped
+ */
+int work_cancel(work_t *work);
+
+#endif /* __SYS_WORK_H__ */
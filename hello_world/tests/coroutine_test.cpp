@@ -0,0 +1,150 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <CppUTest/TestHarness.h>
+
+#include "coroutine.h"
+#include "tools/misc.h"
+
+typedef struct {
+	coro_t coro;
+	int step;
+	int loops;
+	bool flag;
+} test_coro_t;
+
+static int test_coro_steps(coro_t *coro)
+{
+	test_coro_t *test = CONTAINER_OF(coro, test_coro_t, coro);
+
+	CORO_BEGIN(coro);
+	test->step = 1;
+	CORO_YIELD(coro);
+	test->step = 2;
+	CORO_YIELD(coro);
+	test->step = 3;
+	CORO_END(coro);
+}
+
+static int test_coro_loop(coro_t *coro)
+{
+	test_coro_t *test = CONTAINER_OF(coro, test_coro_t, coro);
+
+	CORO_BEGIN(coro);
+	for (test->step = 0; test->step < test->loops; test->step++) {
+		CORO_YIELD(coro);
+	}
+	CORO_END(coro);
+}
+
+static int test_coro_wait_until(coro_t *coro)
+{
+	test_coro_t *test = CONTAINER_OF(coro, test_coro_t, coro);
+
+	CORO_BEGIN(coro);
+	test->step = 1;
+	CORO_WAIT_UNTIL(coro, test->flag);
+	test->step = 2;
+	CORO_END(coro);
+}
+
+static int test_coro_await(coro_t *coro)
+{
+	test_coro_t *test = CONTAINER_OF(coro, test_coro_t, coro);
+
+	CORO_BEGIN(coro);
+	CORO_AWAIT(coro, test->flag);
+	test->step = 1;
+	CORO_EXIT(coro);
+	test->step = 2;
+	CORO_END(coro);
+}
+
+TEST_GROUP(coroutine_tests)
+{
+	test_coro_t m_test;
+
+	void setup()
+	{
+		m_test.step = 0;
+		m_test.loops = 0;
+		m_test.flag = false;
+	}
+};
+
+TEST(coroutine_tests, coroutine_init_test)
+{
+	CORO_INIT(&m_test.coro, test_coro_steps);
+
+	CHECK_TRUE(m_test.coro.func == test_coro_steps);
+	CHECK_EQUAL(0, m_test.coro.lc);
+	CHECK_TRUE(m_test.coro.node.next == NULL);
+}
+
+TEST(coroutine_tests, coroutine_yield_resumes_after_yield_test)
+{
+	CORO_INIT(&m_test.coro, test_coro_steps);
+
+	CHECK_EQUAL(CORO_YIELDED, m_test.coro.func(&m_test.coro));
+	CHECK_EQUAL(1, m_test.step);
+	CHECK_EQUAL(CORO_YIELDED, m_test.coro.func(&m_test.coro));
+	CHECK_EQUAL(2, m_test.step);
+	CHECK_EQUAL(CORO_ENDED, m_test.coro.func(&m_test.coro));
+	CHECK_EQUAL(3, m_test.step);
+}
+
+TEST(coroutine_tests, coroutine_restarts_after_end_test)
+{
+	CORO_INIT(&m_test.coro, test_coro_steps);
+
+	while (m_test.coro.func(&m_test.coro) != CORO_ENDED) {
+	}
+
+	CHECK_EQUAL(0, m_test.coro.lc);
+	CHECK_EQUAL(CORO_YIELDED, m_test.coro.func(&m_test.coro));
+	CHECK_EQUAL(1, m_test.step);
+}
+
+TEST(coroutine_tests, coroutine_yield_in_loop_test)
+{
+	int resumes = 0;
+
+	m_test.loops = 10;
+	CORO_INIT(&m_test.coro, test_coro_loop);
+
+	while (m_test.coro.func(&m_test.coro) != CORO_ENDED) {
+		resumes++;
+	}
+
+	CHECK_EQUAL(m_test.loops, resumes);
+	CHECK_EQUAL(m_test.loops, m_test.step);
+}
+
+TEST(coroutine_tests, coroutine_wait_until_test)
+{
+	CORO_INIT(&m_test.coro, test_coro_wait_until);
+
+	CHECK_EQUAL(CORO_YIELDED, m_test.coro.func(&m_test.coro));
+	CHECK_EQUAL(CORO_YIELDED, m_test.coro.func(&m_test.coro));
+	CHECK_EQUAL(1, m_test.step);
+
+	m_test.flag = true;
+
+	CHECK_EQUAL(CORO_ENDED, m_test.coro.func(&m_test.coro));
+	CHECK_EQUAL(2, m_test.step);
+}
+
+TEST(coroutine_tests, coroutine_await_and_exit_test)
+{
+	CORO_INIT(&m_test.coro, test_coro_await);
+
+	CHECK_EQUAL(CORO_WAITING, m_test.coro.func(&m_test.coro));
+	CHECK_EQUAL(0, m_test.step);
+
+	m_test.flag = true;
+
+	CHECK_EQUAL(CORO_ENDED, m_test.coro.func(&m_test.coro));
+	CHECK_EQUAL(1, m_test.step);
+	CHECK_EQUAL(0, m_test.coro.lc);
+}
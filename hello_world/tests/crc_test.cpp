@@ -0,0 +1,131 @@
+#include <stdint.h>
+#include <string.h>
+
+#include <random>
+#include <vector>
+
+#include <CppUTest/TestHarness.h>
+
+#include "crc.h"
+
+static const char test_crc_check_string[] = "123456789";
+
+/* Bitwise references, independent of the tables */
+static uint32_t test_crc32_bitwise(const uint8_t *data, size_t size)
+{
+	uint32_t crc = 0xFFFFFFFF;
+
+	for (size_t idx = 0; idx < size; idx++) {
+		crc ^= data[idx];
+		for (int bit = 0; bit < 8; bit++) {
+			crc = (crc & 1) ? ((crc >> 1) ^ 0xEDB88320) : (crc >> 1);
+		}
+	}
+
+	return ~crc;
+}
+
+static uint16_t test_crc16_bitwise(const uint8_t *data, size_t size)
+{
+	uint16_t crc = 0xFFFF;
+
+	for (size_t idx = 0; idx < size; idx++) {
+		crc ^= (uint16_t)(data[idx] << 8);
+		for (int bit = 0; bit < 8; bit++) {
+			crc = (uint16_t)((crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1));
+		}
+	}
+
+	return crc;
+}
+
+static uint8_t test_crc8_bitwise(const uint8_t *data, size_t size)
+{
+	uint8_t crc = 0;
+
+	for (size_t idx = 0; idx < size; idx++) {
+		crc ^= data[idx];
+		for (int bit = 0; bit < 8; bit++) {
+			crc = (uint8_t)((crc & 0x80) ? ((crc << 1) ^ 0x07) : (crc << 1));
+		}
+	}
+
+	return crc;
+}
+
+TEST_GROUP(crc_tests)
+{
+	std::vector<uint8_t> m_data;
+
+	void setup()
+	{
+		std::mt19937 rng(17);
+
+		m_data.resize(300);
+		for (size_t idx = 0; idx < m_data.size(); idx++) {
+			m_data[idx] = (uint8_t)rng();
+		}
+	}
+};
+
+TEST(crc_tests, test_check_values)
+{
+	size_t size = strlen(test_crc_check_string);
+
+	CHECK_EQUAL(0xCBF43926, crc32_update(CRC32_INIT, test_crc_check_string, size));
+	CHECK_EQUAL(0x29B1, crc16_ccitt_update(CRC16_CCITT_INIT, test_crc_check_string, size));
+	CHECK_EQUAL(0xF4, crc8_update(CRC8_INIT, test_crc_check_string, size));
+}
+
+TEST(crc_tests, test_empty_data_keeps_crc)
+{
+	CHECK_EQUAL(CRC32_INIT, crc32_update(CRC32_INIT, NULL, 0));
+	CHECK_EQUAL(0x1234, crc16_ccitt_update(0x1234, NULL, 0));
+	CHECK_EQUAL(0x56, crc8_update(0x56, NULL, 0));
+}
+
+TEST(crc_tests, test_all_alignments_and_sizes_match_bitwise)
+{
+	/* Offsets and sizes cover aligned heads, slice loops and byte tails */
+	for (size_t offset = 0; offset < 8; offset++) {
+		for (size_t size = 0; size <= 70; size++) {
+			const uint8_t *data = &m_data[offset];
+
+			CHECK_EQUAL(test_crc32_bitwise(data, size), crc32_update(CRC32_INIT, data, size));
+			CHECK_EQUAL(test_crc16_bitwise(data, size), crc16_ccitt_update(CRC16_CCITT_INIT, data, size));
+			CHECK_EQUAL(test_crc8_bitwise(data, size), crc8_update(CRC8_INIT, data, size));
+		}
+	}
+}
+
+TEST(crc_tests, test_streaming_matches_single_call)
+{
+	uint32_t expected32 = crc32_update(CRC32_INIT, m_data.data(), m_data.size());
+	uint16_t expected16 = crc16_ccitt_update(CRC16_CCITT_INIT, m_data.data(), m_data.size());
+	uint8_t expected8 = crc8_update(CRC8_INIT, m_data.data(), m_data.size());
+
+	/* Split data at every position into two chunks, and into chunks of every size */
+	for (size_t split = 0; split <= m_data.size(); split += 7) {
+		uint32_t crc32 = crc32_update(CRC32_INIT, m_data.data(), split);
+		crc32 = crc32_update(crc32, &m_data[split], m_data.size() - split);
+		CHECK_EQUAL(expected32, crc32);
+	}
+
+	for (size_t chunk = 1; chunk <= 13; chunk++) {
+		uint32_t crc32 = CRC32_INIT;
+		uint16_t crc16 = CRC16_CCITT_INIT;
+		uint8_t crc8 = CRC8_INIT;
+
+		for (size_t pos = 0; pos < m_data.size(); pos += chunk) {
+			size_t size = (m_data.size() - pos < chunk) ? m_data.size() - pos : chunk;
+
+			crc32 = crc32_update(crc32, &m_data[pos], size);
+			crc16 = crc16_ccitt_update(crc16, &m_data[pos], size);
+			crc8 = crc8_update(crc8, &m_data[pos], size);
+		}
+
+		CHECK_EQUAL(expected32, crc32);
+		CHECK_EQUAL(expected16, crc16);
+		CHECK_EQUAL(expected8, crc8);
+	}
+}
@@ -0,0 +1,114 @@
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <CppUTest/TestHarness.h>
+
+#include "dlist.h"
+
+TEST_GROUP(dlist_tests)
+{
+	static const int NODES_NUMBER = 5;
+	dlist_t m_list;
+	dlist_node_t m_node[NODES_NUMBER];
+
+	void setup()
+	{
+		dlist_init(&m_list);
+
+		for (int idx = 0; idx < NODES_NUMBER; idx++) {
+			m_node[idx].next = NULL;
+			m_node[idx].prev = NULL;
+		}
+	}
+
+	void check_list_order(dlist_t * list, dlist_node_t * *expected, int count)
+	{
+		dlist_node_t *node = dlist_head_peek(list);
+
+		for (int idx = 0; idx < count; idx++) {
+			POINTERS_EQUAL(expected[idx], node);
+			node = dlist_next_peek(list, node);
+		}
+
+		POINTERS_EQUAL(NULL, node);
+	}
+};
+
+TEST(dlist_tests, dlist_init_empty_test)
+{
+	CHECK_TRUE(dlist_is_empty(&m_list));
+	POINTERS_EQUAL(NULL, dlist_head_peek(&m_list));
+	POINTERS_EQUAL(NULL, dlist_head_get(&m_list));
+}
+
+TEST(dlist_tests, dlist_tail_put_keeps_order_test)
+{
+	dlist_node_t *expected[NODES_NUMBER];
+
+	for (int idx = 0; idx < NODES_NUMBER; idx++) {
+		dlist_tail_put(&m_list, &m_node[idx]);
+		expected[idx] = &m_node[idx];
+	}
+
+	check_list_order(&m_list, expected, NODES_NUMBER);
+}
+
+TEST(dlist_tests, dlist_head_put_reverses_order_test)
+{
+	dlist_node_t *expected[NODES_NUMBER];
+
+	for (int idx = 0; idx < NODES_NUMBER; idx++) {
+		dlist_head_put(&m_list, &m_node[idx]);
+		expected[NODES_NUMBER - 1 - idx] = &m_node[idx];
+	}
+
+	check_list_order(&m_list, expected, NODES_NUMBER);
+}
+
+TEST(dlist_tests, dlist_remove_middle_head_tail_test)
+{
+	for (int idx = 0; idx < NODES_NUMBER; idx++) {
+		dlist_tail_put(&m_list, &m_node[idx]);
+	}
+
+	dlist_remove(&m_node[2]);
+	dlist_remove(&m_node[0]);
+	dlist_remove(&m_node[4]);
+
+	dlist_node_t *expected[] = { &m_node[1], &m_node[3] };
+	check_list_order(&m_list, expected, 2);
+
+	CHECK_FALSE(dlist_node_is_linked(&m_node[2]));
+	CHECK_TRUE(dlist_node_is_linked(&m_node[1]));
+}
+
+TEST(dlist_tests, dlist_head_get_empties_list_test)
+{
+	dlist_tail_put(&m_list, &m_node[0]);
+	dlist_tail_put(&m_list, &m_node[1]);
+
+	POINTERS_EQUAL(&m_node[0], dlist_head_get(&m_list));
+	POINTERS_EQUAL(&m_node[1], dlist_head_get(&m_list));
+	CHECK_TRUE(dlist_is_empty(&m_list));
+	CHECK_FALSE(dlist_node_is_linked(&m_node[0]));
+}
+
+TEST(dlist_tests, dlist_tail_join_test)
+{
+	dlist_t other;
+	dlist_init(&other);
+
+	dlist_tail_put(&m_list, &m_node[0]);
+	dlist_tail_put(&other, &m_node[1]);
+	dlist_tail_put(&other, &m_node[2]);
+
+	dlist_tail_join(&m_list, &other);
+
+	dlist_node_t *expected[] = { &m_node[0], &m_node[1], &m_node[2] };
+	check_list_order(&m_list, expected, 3);
+	CHECK_TRUE(dlist_is_empty(&other));
+
+	/* Join of empty list doesn't change the list */
+	dlist_tail_join(&m_list, &other);
+	check_list_order(&m_list, expected, 3);
+}
@@ -0,0 +1,238 @@
+#include <stdint.h>
+#include <string.h>
+
+#include <random>
+#include <vector>
+
+#include <CppUTest/TestHarness.h>
+
+#include "dsp/dsp.h"
+
+/* Kernels are compared bit by bit against their scalar reference implementations. Odd start offsets check that
+ * sample pairs are loaded correctly from addresses that are not word aligned.
+ */
+TEST_GROUP(dsp_tests)
+{
+	std::mt19937 m_rng;
+
+	void setup()
+	{
+		m_rng.seed(5);
+	}
+
+	/* Random samples, every eighth one is an extreme value to hit saturation */
+	std::vector<q15_t> random_q15(size_t size)
+	{
+		std::vector<q15_t> samples(size);
+
+		for (size_t idx = 0; idx < size; idx++) {
+			uint32_t value = m_rng();
+
+			if (idx % 8 == 7) {
+				samples[idx] = (value & 1) ? INT16_MAX : INT16_MIN;
+			} else {
+				samples[idx] = (q15_t)value;
+			}
+		}
+
+		return samples;
+	}
+};
+
+TEST(dsp_tests, test_dot_matches_scalar)
+{
+	std::vector<q15_t> a = random_q15(80);
+	std::vector<q15_t> b = random_q15(80);
+
+	for (size_t offset = 0; offset < 2; offset++) {
+		for (uint32_t size = 0; size <= 70; size++) {
+			CHECK_EQUAL(dsp_dot_q15_scalar(&a[offset], &b[offset], size),
+				    dsp_dot_q15(&a[offset], &b[offset], size));
+		}
+	}
+
+	/* Sum of -1 * -1 products doesn't fit 32 bits */
+	std::vector<q15_t> min(64, INT16_MIN);
+
+	CHECK_EQUAL(64LL << 30, dsp_dot_q15(min.data(), min.data(), 64));
+}
+
+TEST(dsp_tests, test_add_saturates_and_matches_scalar)
+{
+	std::vector<q15_t> a = random_q15(40);
+	std::vector<q15_t> b = random_q15(40);
+
+	for (size_t offset = 0; offset < 2; offset++) {
+		for (uint32_t size = 0; size <= 37; size++) {
+			std::vector<q15_t> expected(40, 0);
+			std::vector<q15_t> result(40, 0);
+
+			dsp_add_q15_scalar(&a[offset], &b[offset], &expected[offset], size);
+			dsp_add_q15(&a[offset], &b[offset], &result[offset], size);
+
+			MEMCMP_EQUAL(expected.data(), result.data(), 40 * sizeof(q15_t));
+		}
+	}
+
+	q15_t high[] = { 30000, -30000, 100 };
+	q15_t sum[3];
+
+	dsp_add_q15(high, high, sum, 3);
+	CHECK_EQUAL(INT16_MAX, sum[0]);
+	CHECK_EQUAL(INT16_MIN, sum[1]);
+	CHECK_EQUAL(200, sum[2]);
+}
+
+TEST(dsp_tests, test_conversions)
+{
+	q15_t q15[] = { 0, 1, -1, INT16_MAX, INT16_MIN, 12345 };
+	q31_t q31[6];
+	q15_t back[6];
+	float f32[6];
+
+	dsp_q15_to_q31(q15, q31, 6);
+	CHECK_EQUAL(-65536, q31[2]);
+	CHECK_EQUAL(INT32_MIN, q31[4]);
+
+	dsp_q31_to_q15(q31, back, 6);
+	MEMCMP_EQUAL(q15, back, sizeof(q15));
+
+	/* Lower bits are dropped, so negative values are rounded toward minus infinity */
+	q31_t fraction[] = { 0x00018000, -0x00018000 };
+	dsp_q31_to_q15(fraction, back, 2);
+	CHECK_EQUAL(1, back[0]);
+	CHECK_EQUAL(-2, back[1]);
+
+	dsp_q15_to_f32(q15, f32, 6);
+	dsp_f32_to_q15(f32, back, 6);
+	MEMCMP_EQUAL(q15, back, sizeof(q15));
+
+	float values[] = { 1.0f, -1.5f, 0.5f, 1.6e-5f, -1.6e-5f, 1.4e-5f };
+	q15_t expected[] = { INT16_MAX, INT16_MIN, 16384, 1, -1, 0 };
+	dsp_f32_to_q15(values, back, 6);
+	MEMCMP_EQUAL(expected, back, sizeof(expected));
+}
+
+TEST(dsp_tests, test_fir_impulse_response)
+{
+	q15_t coeffs[] = { 100, 200, 300, 400, 500 };
+	q15_t state[5 - 1 + 8];
+	q15_t impulse[8] = { INT16_MAX };
+	q15_t output[8];
+	dsp_fir_q15_t fir;
+
+	dsp_fir_q15_init(&fir, coeffs, 5, state, 8);
+	dsp_fir_q15(&fir, impulse, output, 8);
+
+	/* Coefficients are time-reversed, so the response is the reversed coefficients, scaled by 32767/32768 */
+	for (int idx = 0; idx < 5; idx++) {
+		CHECK_EQUAL(((int32_t)coeffs[4 - idx] * INT16_MAX) >> 15, output[idx]);
+	}
+	CHECK_EQUAL(0, output[5]);
+}
+
+TEST(dsp_tests, test_fir_matches_scalar_across_blocks)
+{
+	const uint32_t BLOCK_SIZE_MAX = 24;
+
+	for (uint16_t taps = 1; taps <= 33; taps += 4) {
+		std::vector<q15_t> coeffs = random_q15(taps);
+		std::vector<q15_t> state(taps - 1 + BLOCK_SIZE_MAX);
+		std::vector<q15_t> scalar_state(taps - 1 + BLOCK_SIZE_MAX);
+		dsp_fir_q15_t fir;
+		dsp_fir_q15_t scalar_fir;
+
+		dsp_fir_q15_init(&fir, coeffs.data(), taps, state.data(), BLOCK_SIZE_MAX);
+		dsp_fir_q15_init(&scalar_fir, coeffs.data(), taps, scalar_state.data(), BLOCK_SIZE_MAX);
+
+		/* Blocks of different size check the delay line carries history between calls */
+		for (uint32_t block_size = 1; block_size <= BLOCK_SIZE_MAX; block_size += 5) {
+			std::vector<q15_t> input = random_q15(block_size);
+			std::vector<q15_t> output(block_size);
+			std::vector<q15_t> expected(block_size);
+
+			dsp_fir_q15(&fir, input.data(), output.data(), block_size);
+			dsp_fir_q15_scalar(&scalar_fir, input.data(), expected.data(), block_size);
+
+			MEMCMP_EQUAL(expected.data(), output.data(), block_size * sizeof(q15_t));
+		}
+	}
+}
+
+TEST(dsp_tests, test_biquad_matches_scalar)
+{
+	/* Two low-pass stages */
+	const float coeffs[] = {
+		0.0675f, 0.1349f, 0.0675f, -1.1430f, 0.4128f,
+		0.0940f, 0.1880f, 0.0940f, -0.9985f, 0.3745f,
+	};
+	float state[4];
+	float scalar_state[4];
+	dsp_biquad_f32_t biquad;
+	dsp_biquad_f32_t scalar_biquad;
+
+	dsp_biquad_f32_init(&biquad, coeffs, state, 2);
+	dsp_biquad_f32_init(&scalar_biquad, coeffs, scalar_state, 2);
+
+	for (int block = 0; block < 4; block++) {
+		float input[32];
+		float output[32];
+		float expected[32];
+
+		for (int idx = 0; idx < 32; idx++) {
+			input[idx] = (float)(int32_t)m_rng() / 2147483648.0f;
+		}
+
+		dsp_biquad_f32_scalar(&scalar_biquad, input, expected, 32);
+
+		/* In place filtering */
+		memcpy(output, input, sizeof(input));
+		dsp_biquad_f32(&biquad, output, output, 32);
+
+		MEMCMP_EQUAL(expected, output, sizeof(expected));
+	}
+
+	/* DC gain of each stage is one, so a constant input settles at the same value */
+	float dc[32];
+
+	for (int block = 0; block < 8; block++) {
+		for (int idx = 0; idx < 32; idx++) {
+			dc[idx] = 0.5f;
+		}
+		dsp_biquad_f32(&biquad, dc, dc, 32);
+	}
+	DOUBLES_EQUAL(0.5, dc[31], 0.001);
+}
+
+TEST(dsp_tests, test_stats)
+{
+	for (size_t offset = 0; offset < 2; offset++) {
+		for (uint32_t size = 1; size <= 67; size += 3) {
+			std::vector<q15_t> samples = random_q15(size + offset);
+			dsp_stats_q15_t stats;
+			dsp_stats_q15_t expected;
+
+			dsp_stats_q15(&samples[offset], size, &stats);
+			dsp_stats_q15_scalar(&samples[offset], size, &expected);
+
+			CHECK_EQUAL(expected.min, stats.min);
+			CHECK_EQUAL(expected.max, stats.max);
+			CHECK_EQUAL(expected.mean, stats.mean);
+			CHECK_EQUAL(expected.rms, stats.rms);
+		}
+	}
+
+	q15_t values[] = { 3000, -4000, 3000, -4000 };
+	dsp_stats_q15_t stats;
+
+	dsp_stats_q15(values, 4, &stats);
+	CHECK_EQUAL(-4000, stats.min);
+	CHECK_EQUAL(3000, stats.max);
+	CHECK_EQUAL(-500, stats.mean);
+	CHECK_EQUAL(3535, stats.rms);
+
+	/* RMS of full scale negative samples saturates */
+	q15_t min[] = { INT16_MIN, INT16_MIN, INT16_MIN };
+	dsp_stats_q15(min, 3, &stats);
+	CHECK_EQUAL(INT16_MAX, stats.rms);
+}
@@ -0,0 +1,149 @@
+#include <errno.h>
+#include <stdint.h>
+
+#include <map>
+#include <random>
+
+#include <CppUTest/TestHarness.h>
+
+#include "hashmap.h"
+
+HASHMAP_DEFINE(test_defined_map, 8);
+
+TEST_GROUP(hashmap_tests)
+{
+	static const uint32_t CAPACITY = 64;
+	hashmap_t m_map;
+	hashmap_entry_t m_entries[CAPACITY];
+	int m_values[CAPACITY * 4];
+
+	void setup()
+	{
+		hashmap_init(&m_map, m_entries, CAPACITY);
+	}
+
+	/* Check every stored entry is reachable from its home slot with the recorded distance */
+	void check_distances()
+	{
+		uint32_t count = 0;
+
+		for (uint32_t slot = 0; slot < CAPACITY; slot++) {
+			if (m_entries[slot].distance != 0) {
+				POINTERS_EQUAL(m_entries[slot].value, hashmap_get(&m_map, m_entries[slot].key));
+				count++;
+			}
+		}
+
+		CHECK_EQUAL(hashmap_count(&m_map), count);
+	}
+};
+
+TEST(hashmap_tests, test_empty_map)
+{
+	CHECK_EQUAL(0, hashmap_count(&m_map));
+	POINTERS_EQUAL(NULL, hashmap_get(&m_map, 0));
+	POINTERS_EQUAL(NULL, hashmap_get(&m_map, 1));
+	POINTERS_EQUAL(NULL, hashmap_remove(&m_map, 1));
+}
+
+TEST(hashmap_tests, test_defined_map_is_ready)
+{
+	CHECK_EQUAL(8, test_defined_map.capacity);
+	CHECK_EQUAL(0, hashmap_count(&test_defined_map));
+	CHECK_EQUAL(0, hashmap_put(&test_defined_map, 5, &m_values[0]));
+	POINTERS_EQUAL(&m_values[0], hashmap_get(&test_defined_map, 5));
+	POINTERS_EQUAL(&m_values[0], hashmap_remove(&test_defined_map, 5));
+}
+
+TEST(hashmap_tests, test_put_get_remove)
+{
+	CHECK_EQUAL(0, hashmap_put(&m_map, 0, &m_values[0]));
+	CHECK_EQUAL(0, hashmap_put(&m_map, 42, &m_values[1]));
+	CHECK_EQUAL(-EEXIST, hashmap_put(&m_map, 42, &m_values[2]));
+	CHECK_EQUAL(2, hashmap_count(&m_map));
+
+	POINTERS_EQUAL(&m_values[0], hashmap_get(&m_map, 0));
+	POINTERS_EQUAL(&m_values[1], hashmap_get(&m_map, 42));
+	POINTERS_EQUAL(NULL, hashmap_get(&m_map, 43));
+
+	POINTERS_EQUAL(&m_values[1], hashmap_remove(&m_map, 42));
+	POINTERS_EQUAL(NULL, hashmap_get(&m_map, 42));
+	POINTERS_EQUAL(NULL, hashmap_remove(&m_map, 42));
+	CHECK_EQUAL(1, hashmap_count(&m_map));
+}
+
+TEST(hashmap_tests, test_pointer_keys)
+{
+	for (uint32_t idx = 0; idx < CAPACITY / 2; idx++) {
+		CHECK_EQUAL(0, hashmap_put(&m_map, (hashmap_key_t)&m_values[idx], &m_values[idx + 1]));
+	}
+
+	for (uint32_t idx = 0; idx < CAPACITY / 2; idx++) {
+		POINTERS_EQUAL(&m_values[idx + 1], hashmap_get(&m_map, (hashmap_key_t)&m_values[idx]));
+	}
+
+	check_distances();
+}
+
+TEST(hashmap_tests, test_full_map)
+{
+	for (uint32_t idx = 0; idx < CAPACITY; idx++) {
+		CHECK_EQUAL(0, hashmap_put(&m_map, idx * 7, &m_values[idx]));
+	}
+
+	CHECK_EQUAL(-ENOMEM, hashmap_put(&m_map, 1, &m_values[0]));
+	CHECK_EQUAL(-EEXIST, hashmap_put(&m_map, 7, &m_values[0]));
+	check_distances();
+
+	/* Missing keys are not found in a full map, there is no empty slot to stop the probe */
+	POINTERS_EQUAL(NULL, hashmap_get(&m_map, 1));
+
+	for (uint32_t idx = 0; idx < CAPACITY; idx++) {
+		POINTERS_EQUAL(&m_values[idx], hashmap_remove(&m_map, idx * 7));
+		check_distances();
+	}
+
+	CHECK_EQUAL(0, hashmap_count(&m_map));
+}
+
+TEST(hashmap_tests, test_random_against_std_map)
+{
+	std::mt19937 rng(11);
+	std::map<hashmap_key_t, void *> reference;
+
+	for (int iteration = 0; iteration < 50000; iteration++) {
+		/* Small key range, so puts of existing keys and removals hit often */
+		hashmap_key_t key = rng() % (CAPACITY * 2);
+		void *value = &m_values[rng() % (CAPACITY * 4)];
+
+		if (rng() % 2 == 0) {
+			int err = hashmap_put(&m_map, key, value);
+
+			if (reference.count(key) != 0) {
+				CHECK_EQUAL(-EEXIST, err);
+			} else if (reference.size() == CAPACITY) {
+				CHECK_EQUAL(-ENOMEM, err);
+			} else {
+				CHECK_EQUAL(0, err);
+				reference[key] = value;
+			}
+		} else {
+			void *expected = (reference.count(key) != 0) ? reference[key] : NULL;
+
+			POINTERS_EQUAL(expected, hashmap_remove(&m_map, key));
+			reference.erase(key);
+		}
+
+		CHECK_EQUAL(reference.size(), hashmap_count(&m_map));
+
+		if (iteration % 500 == 0) {
+			check_distances();
+
+			for (hashmap_key_t probe = 0; probe < CAPACITY * 2; probe++) {
+				void *expected = (reference.count(probe) != 0) ? reference[probe] : NULL;
+
+				POINTERS_EQUAL(expected, hashmap_get(&m_map, probe));
+			}
+		}
+	}
+}
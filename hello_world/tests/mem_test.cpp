@@ -0,0 +1,131 @@
+#include <stdint.h>
+#include <string.h>
+
+#include <CppUTest/TestHarness.h>
+
+#include "mem.h"
+
+static int test_mem_sign(int value)
+{
+	return (value > 0) - (value < 0);
+}
+
+/* Results are compared against C library functions for all alignment combinations and sizes around block sizes */
+TEST_GROUP(mem_tests)
+{
+	static const size_t AREA_SIZE = 192;
+	static const size_t MAX_OFFSET = 8;
+	uint8_t m_src[AREA_SIZE];
+	uint8_t m_dst[AREA_SIZE];
+	uint8_t m_expected[AREA_SIZE];
+
+	void setup()
+	{
+		for (size_t idx = 0; idx < AREA_SIZE; idx++) {
+			m_src[idx] = (uint8_t)(idx * 7 + 1);
+		}
+	}
+
+	void reset_dst()
+	{
+		memset(m_dst, 0xA5, AREA_SIZE);
+		memset(m_expected, 0xA5, AREA_SIZE);
+	}
+};
+
+TEST(mem_tests, test_copy_all_alignments)
+{
+	for (size_t dst_offset = 0; dst_offset < MAX_OFFSET; dst_offset++) {
+		for (size_t src_offset = 0; src_offset < MAX_OFFSET; src_offset++) {
+			for (size_t size = 0; size <= AREA_SIZE - MAX_OFFSET; size++) {
+				reset_dst();
+
+				memcpy(&m_expected[dst_offset], &m_src[src_offset], size);
+				POINTERS_EQUAL(&m_dst[dst_offset], mem_copy(&m_dst[dst_offset], &m_src[src_offset], size));
+
+				/* Whole area is compared, so writes out of bounds are caught as well */
+				MEMCMP_EQUAL(m_expected, m_dst, AREA_SIZE);
+			}
+		}
+	}
+}
+
+TEST(mem_tests, test_set_all_alignments)
+{
+	for (size_t offset = 0; offset < MAX_OFFSET; offset++) {
+		for (size_t size = 0; size <= AREA_SIZE - MAX_OFFSET; size++) {
+			reset_dst();
+
+			memset(&m_expected[offset], 0x1C, size);
+			POINTERS_EQUAL(&m_dst[offset], mem_set(&m_dst[offset], 0x1C, size));
+
+			MEMCMP_EQUAL(m_expected, m_dst, AREA_SIZE);
+		}
+	}
+
+	/* Only the low byte of the value is used */
+	mem_set(m_dst, 0x1FF, AREA_SIZE);
+	memset(m_expected, 0xFF, AREA_SIZE);
+	MEMCMP_EQUAL(m_expected, m_dst, AREA_SIZE);
+}
+
+TEST(mem_tests, test_move_overlapping_both_directions)
+{
+	for (size_t dst_offset = 0; dst_offset < 3 * MAX_OFFSET; dst_offset++) {
+		for (size_t src_offset = 0; src_offset < 3 * MAX_OFFSET; src_offset++) {
+			for (size_t size = 0; size <= AREA_SIZE - 3 * MAX_OFFSET; size += 3) {
+				memcpy(m_expected, m_src, AREA_SIZE);
+				memcpy(m_dst, m_src, AREA_SIZE);
+
+				memmove(&m_expected[dst_offset], &m_expected[src_offset], size);
+				POINTERS_EQUAL(&m_dst[dst_offset], mem_move(&m_dst[dst_offset], &m_dst[src_offset], size));
+
+				MEMCMP_EQUAL(m_expected, m_dst, AREA_SIZE);
+			}
+		}
+	}
+}
+
+TEST(mem_tests, test_compare_all_alignments)
+{
+	uint8_t other[AREA_SIZE];
+
+	for (size_t a_offset = 0; a_offset < MAX_OFFSET; a_offset++) {
+		for (size_t b_offset = 0; b_offset < MAX_OFFSET; b_offset++) {
+			for (size_t size = 0; size <= AREA_SIZE - MAX_OFFSET; size += 5) {
+				memcpy(&other[b_offset], &m_src[a_offset], size);
+				CHECK_EQUAL(0, mem_compare(&m_src[a_offset], &other[b_offset], size));
+
+				if (size == 0) {
+					continue;
+				}
+
+				/* Differences at the first, the middle and the last byte, in both directions */
+				size_t diff_positions[] = { 0, size / 2, size - 1 };
+
+				for (size_t pos = 0; pos < 3; pos++) {
+					uint8_t *diff = &other[b_offset + diff_positions[pos]];
+					uint8_t saved = *diff;
+
+					*diff = (uint8_t)(saved + 0x80);
+
+					CHECK_EQUAL(test_mem_sign(memcmp(&m_src[a_offset], &other[b_offset], size)),
+						    test_mem_sign(mem_compare(&m_src[a_offset], &other[b_offset], size)));
+					CHECK_EQUAL(test_mem_sign(memcmp(&other[b_offset], &m_src[a_offset], size)),
+						    test_mem_sign(mem_compare(&other[b_offset], &m_src[a_offset], size)));
+
+					*diff = saved;
+				}
+			}
+		}
+	}
+}
+
+TEST(mem_tests, test_compare_is_unsigned)
+{
+	uint8_t low[] = { 0x01 };
+	uint8_t high[] = { 0xFF };
+
+	CHECK(mem_compare(low, high, 1) < 0);
+	CHECK(mem_compare(high, low, 1) > 0);
+}
@@ -0,0 +1,251 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include <CppUTest/TestHarness.h>
+
+#include "pheap.h"
+#include "slist.h"
+#include "tools/misc.h"
+
+typedef struct {
+	pheap_node_t heap_node;
+	slist_node_t list_node;
+	uint32_t key;
+} test_pheap_item_t;
+
+#define TEST_PHEAP_ITEM_GET(node_ptr) CONTAINER_OF(node_ptr, test_pheap_item_t, heap_node)
+#define TEST_PHEAP_LIST_ITEM_GET(node_ptr) CONTAINER_OF(node_ptr, test_pheap_item_t, list_node)
+
+static bool test_pheap_less(const pheap_node_t *a, const pheap_node_t *b)
+{
+	return TEST_PHEAP_ITEM_GET(a)->key < TEST_PHEAP_ITEM_GET(b)->key;
+}
+
+TEST_GROUP(pheap_tests)
+{
+	static const int ITEMS_NUMBER = 512;
+	pheap_t m_heap;
+	test_pheap_item_t m_item[ITEMS_NUMBER];
+
+	void setup()
+	{
+		pheap_init(&m_heap, test_pheap_less);
+
+		for (int idx = 0; idx < ITEMS_NUMBER; idx++) {
+			m_item[idx].heap_node.child = NULL;
+			m_item[idx].heap_node.next = NULL;
+			m_item[idx].heap_node.prev = NULL;
+			m_item[idx].key = 0;
+		}
+	}
+
+	/* Pop all items and check those come in order, returns number of popped items */
+	int pop_all_ordered()
+	{
+		uint32_t prev_key = 0;
+		int count = 0;
+		pheap_node_t *node;
+
+		while ((node = pheap_pop(&m_heap)) != NULL) {
+			CHECK(TEST_PHEAP_ITEM_GET(node)->key >= prev_key);
+			prev_key = TEST_PHEAP_ITEM_GET(node)->key;
+			count++;
+		}
+
+		return count;
+	}
+};
+
+TEST(pheap_tests, test_empty_heap)
+{
+	CHECK(pheap_is_empty(&m_heap));
+	POINTERS_EQUAL(NULL, pheap_peek(&m_heap));
+	POINTERS_EQUAL(NULL, pheap_pop(&m_heap));
+}
+
+TEST(pheap_tests, test_insert_peek_min)
+{
+	uint32_t keys[] = { 50, 20, 70, 10, 30 };
+	uint32_t min_keys[] = { 50, 20, 20, 10, 10 };
+
+	for (int idx = 0; idx < 5; idx++) {
+		m_item[idx].key = keys[idx];
+		pheap_insert(&m_heap, &m_item[idx].heap_node);
+
+		CHECK_EQUAL(min_keys[idx], TEST_PHEAP_ITEM_GET(pheap_peek(&m_heap))->key);
+	}
+
+	CHECK_FALSE(pheap_is_empty(&m_heap));
+	CHECK_EQUAL(5, pop_all_ordered());
+	CHECK(pheap_is_empty(&m_heap));
+}
+
+TEST(pheap_tests, test_random_order_sorted)
+{
+	std::mt19937 rng(7);
+
+	for (int idx = 0; idx < ITEMS_NUMBER; idx++) {
+		m_item[idx].key = rng() % 1000;
+		pheap_insert(&m_heap, &m_item[idx].heap_node);
+	}
+
+	CHECK_EQUAL(ITEMS_NUMBER, pop_all_ordered());
+}
+
+TEST(pheap_tests, test_remove_root_inner_and_leaf)
+{
+	for (int idx = 0; idx < 16; idx++) {
+		m_item[idx].key = idx;
+		pheap_insert(&m_heap, &m_item[idx].heap_node);
+	}
+
+	/* Pop makes a multi-level tree, then remove nodes at different positions */
+	POINTERS_EQUAL(&m_item[0].heap_node, pheap_pop(&m_heap));
+
+	pheap_remove(&m_heap, &m_item[1].heap_node);
+	pheap_remove(&m_heap, &m_item[8].heap_node);
+	pheap_remove(&m_heap, &m_item[15].heap_node);
+
+	CHECK_FALSE(pheap_node_is_linked(&m_heap, &m_item[8].heap_node));
+	CHECK(pheap_node_is_linked(&m_heap, &m_item[9].heap_node));
+
+	for (int idx = 2; idx < 15; idx++) {
+		if (idx == 8) {
+			continue;
+		}
+
+		POINTERS_EQUAL(&m_item[idx].heap_node, pheap_pop(&m_heap));
+	}
+
+	CHECK(pheap_is_empty(&m_heap));
+}
+
+TEST(pheap_tests, test_random_insert_remove_pop)
+{
+	std::mt19937 rng(99);
+	std::vector<int> linked;
+
+	for (int iteration = 0; iteration < 20000; iteration++) {
+		uint32_t op = rng() % 4;
+
+		if (linked.size() < ITEMS_NUMBER && (linked.empty() || op < 2)) {
+			/* Find an item that isn't in the heap */
+			int idx = rng() % ITEMS_NUMBER;
+
+			while (pheap_node_is_linked(&m_heap, &m_item[idx].heap_node)) {
+				idx = (idx + 1) % ITEMS_NUMBER;
+			}
+
+			m_item[idx].key = rng() % 10000;
+			pheap_insert(&m_heap, &m_item[idx].heap_node);
+			linked.push_back(idx);
+		} else if (op == 2) {
+			size_t pos = rng() % linked.size();
+
+			pheap_remove(&m_heap, &m_item[linked[pos]].heap_node);
+			linked[pos] = linked.back();
+			linked.pop_back();
+		} else {
+			uint32_t min_key = UINT32_MAX;
+
+			for (size_t pos = 0; pos < linked.size(); pos++) {
+				min_key = std::min(min_key, m_item[linked[pos]].key);
+			}
+
+			pheap_node_t *node = pheap_pop(&m_heap);
+
+			CHECK_EQUAL(min_key, TEST_PHEAP_ITEM_GET(node)->key);
+
+			int idx = TEST_PHEAP_ITEM_GET(node) - m_item;
+
+			linked.erase(std::find(linked.begin(), linked.end(), idx));
+		}
+	}
+
+	CHECK_EQUAL((int)linked.size(), pop_all_ordered());
+}
+
+/* Benchmarks on host against ordered insertion into slist, that is how kernel queues are sorted now */
+TEST_GROUP(pheap_bench)
+{
+	static const int ITEMS_NUMBER = 2000;
+	test_pheap_item_t m_item[ITEMS_NUMBER];
+	std::vector<uint32_t> m_keys;
+
+	void setup()
+	{
+		std::mt19937 rng(3);
+
+		for (int idx = 0; idx < ITEMS_NUMBER; idx++) {
+			m_keys.push_back(rng());
+		}
+	}
+
+	void slist_sorted_insert(slist_t * list, test_pheap_item_t * item)
+	{
+		slist_node_t *prev = NULL;
+		slist_node_t *node = slist_head_peek(list);
+
+		while (node != NULL && TEST_PHEAP_LIST_ITEM_GET(node)->key <= item->key) {
+			prev = node;
+			node = slist_next_peek(node);
+		}
+
+		item->list_node.next = NULL;
+		if (prev == NULL) {
+			slist_head_put(list, &item->list_node);
+		} else {
+			slist_next_put(list, prev, &item->list_node);
+		}
+	}
+};
+
+TEST(pheap_bench, bench_insert_pop_vs_sorted_slist)
+{
+	typedef std::chrono::steady_clock clock;
+	pheap_t heap;
+	slist_t list;
+
+	for (int size = 10; size <= ITEMS_NUMBER; size *= 10) {
+		pheap_init(&heap, test_pheap_less);
+		slist_init(&list);
+
+		for (int idx = 0; idx < size; idx++) {
+			m_item[idx].key = m_keys[idx];
+		}
+
+		clock::time_point start = clock::now();
+		for (int idx = 0; idx < size; idx++) {
+			pheap_insert(&heap, &m_item[idx].heap_node);
+		}
+		clock::time_point inserted = clock::now();
+		for (int idx = 0; idx < size; idx++) {
+			CHECK(pheap_pop(&heap) != NULL);
+		}
+		clock::time_point popped = clock::now();
+
+		for (int idx = 0; idx < size; idx++) {
+			slist_sorted_insert(&list, &m_item[idx]);
+		}
+		clock::time_point list_inserted = clock::now();
+		for (int idx = 0; idx < size; idx++) {
+			CHECK(slist_head_get(&list) != NULL);
+		}
+		clock::time_point list_popped = clock::now();
+
+		printf("\n%d items, ns/op: pheap insert %.1f pop %.1f, sorted slist insert %.1f pop %.1f", size,
+		       std::chrono::duration<double, std::nano>(inserted - start).count() / size,
+		       std::chrono::duration<double, std::nano>(popped - inserted).count() / size,
+		       std::chrono::duration<double, std::nano>(list_inserted - popped).count() / size,
+		       std::chrono::duration<double, std::nano>(list_popped - list_inserted).count() / size);
+	}
+
+	printf("\n");
+}
@@ -0,0 +1,208 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <CppUTest/TestHarness.h>
+
+#include "rbtree.h"
+#include "tools/misc.h"
+
+typedef struct {
+	rbtree_node_t node;
+	uint32_t key;
+	bool is_linked;
+} test_rbtree_item_t;
+
+#define TEST_RBTREE_ITEM_GET(node_ptr) CONTAINER_OF(node_ptr, test_rbtree_item_t, node)
+
+static bool test_rbtree_less(const rbtree_node_t *a, const rbtree_node_t *b)
+{
+	return TEST_RBTREE_ITEM_GET(a)->key < TEST_RBTREE_ITEM_GET(b)->key;
+}
+
+TEST_GROUP(rbtree_tests)
+{
+	static const int ITEMS_NUMBER = 512;
+	rbtree_t m_tree;
+	test_rbtree_item_t m_item[ITEMS_NUMBER];
+
+	void setup()
+	{
+		rbtree_init(&m_tree, test_rbtree_less);
+
+		for (int idx = 0; idx < ITEMS_NUMBER; idx++) {
+			m_item[idx].key = 0;
+			m_item[idx].is_linked = false;
+		}
+	}
+
+	/* Check red-black properties of a subtree, returns its black height */
+	int check_subtree(rbtree_node_t * node, rbtree_node_t * parent)
+	{
+		if (node == NULL) {
+			return 1;
+		}
+
+		POINTERS_EQUAL(parent, node->parent);
+
+		if (node->color == RBTREE_RED) {
+			CHECK(node->left == NULL || node->left->color == RBTREE_BLACK);
+			CHECK(node->right == NULL || node->right->color == RBTREE_BLACK);
+		}
+
+		int left_height = check_subtree(node->left, node);
+		int right_height = check_subtree(node->right, node);
+
+		CHECK_EQUAL(left_height, right_height);
+
+		return left_height + ((node->color == RBTREE_BLACK) ? 1 : 0);
+	}
+
+	/* Check the tree is valid and walk it in order, returns number of nodes */
+	int check_tree()
+	{
+		rbtree_node_t *node;
+		uint32_t prev_key = 0;
+		int count = 0;
+
+		if (m_tree.root != NULL) {
+			CHECK_EQUAL(RBTREE_BLACK, m_tree.root->color);
+		}
+		check_subtree(m_tree.root, NULL);
+
+		for (node = rbtree_first(&m_tree); node != NULL; node = rbtree_next(node)) {
+			CHECK(TEST_RBTREE_ITEM_GET(node)->key >= prev_key);
+			prev_key = TEST_RBTREE_ITEM_GET(node)->key;
+			count++;
+		}
+
+		return count;
+	}
+};
+
+TEST(rbtree_tests, test_empty_tree)
+{
+	CHECK(rbtree_is_empty(&m_tree));
+	POINTERS_EQUAL(NULL, rbtree_first(&m_tree));
+	CHECK_EQUAL(0, check_tree());
+}
+
+TEST(rbtree_tests, test_insert_first_cached)
+{
+	uint32_t keys[] = { 50, 20, 70, 10, 30 };
+	uint32_t first_keys[] = { 50, 20, 20, 10, 10 };
+
+	for (int idx = 0; idx < 5; idx++) {
+		m_item[idx].key = keys[idx];
+		rbtree_insert(&m_tree, &m_item[idx].node);
+
+		CHECK_FALSE(rbtree_is_empty(&m_tree));
+		CHECK_EQUAL(first_keys[idx], TEST_RBTREE_ITEM_GET(rbtree_first(&m_tree))->key);
+	}
+
+	CHECK_EQUAL(5, check_tree());
+}
+
+TEST(rbtree_tests, test_ascending_and_descending_inserts_balanced)
+{
+	for (int idx = 0; idx < ITEMS_NUMBER / 2; idx++) {
+		m_item[idx].key = idx;
+		rbtree_insert(&m_tree, &m_item[idx].node);
+	}
+	for (int idx = ITEMS_NUMBER / 2; idx < ITEMS_NUMBER; idx++) {
+		m_item[idx].key = ITEMS_NUMBER * 2 - idx;
+		rbtree_insert(&m_tree, &m_item[idx].node);
+	}
+
+	CHECK_EQUAL(ITEMS_NUMBER, check_tree());
+	POINTERS_EQUAL(&m_item[0].node, rbtree_first(&m_tree));
+}
+
+TEST(rbtree_tests, test_equal_keys_keep_insertion_order)
+{
+	for (int idx = 0; idx < 64; idx++) {
+		m_item[idx].key = idx % 4;
+		rbtree_insert(&m_tree, &m_item[idx].node);
+	}
+
+	CHECK_EQUAL(64, check_tree());
+
+	/* Items with the same key are walked in the order those were inserted */
+	rbtree_node_t *node = rbtree_first(&m_tree);
+
+	for (int key = 0; key < 4; key++) {
+		for (int idx = key; idx < 64; idx += 4) {
+			POINTERS_EQUAL(&m_item[idx].node, node);
+			node = rbtree_next(node);
+		}
+	}
+	POINTERS_EQUAL(NULL, node);
+}
+
+TEST(rbtree_tests, test_remove_first_updates_cache)
+{
+	for (int idx = 0; idx < 16; idx++) {
+		m_item[idx].key = 15 - idx;
+		rbtree_insert(&m_tree, &m_item[idx].node);
+	}
+
+	for (int idx = 15; idx >= 0; idx--) {
+		POINTERS_EQUAL(&m_item[idx].node, rbtree_first(&m_tree));
+		rbtree_remove(&m_tree, rbtree_first(&m_tree));
+		CHECK_EQUAL(idx, check_tree());
+	}
+
+	CHECK(rbtree_is_empty(&m_tree));
+	POINTERS_EQUAL(NULL, rbtree_first(&m_tree));
+}
+
+TEST(rbtree_tests, test_random_insert_remove)
+{
+	std::mt19937 rng(7);
+	std::vector<int> linked;
+
+	for (int iteration = 0; iteration < 20000; iteration++) {
+		if (linked.size() < ITEMS_NUMBER && (linked.empty() || rng() % 2 == 0)) {
+			/* Find an item that isn't in the tree */
+			int idx = rng() % ITEMS_NUMBER;
+
+			while (m_item[idx].is_linked) {
+				idx = (idx + 1) % ITEMS_NUMBER;
+			}
+
+			m_item[idx].key = rng() % 1000;
+			m_item[idx].is_linked = true;
+			rbtree_insert(&m_tree, &m_item[idx].node);
+			linked.push_back(idx);
+		} else {
+			size_t pos = rng() % linked.size();
+
+			m_item[linked[pos]].is_linked = false;
+			rbtree_remove(&m_tree, &m_item[linked[pos]].node);
+			linked[pos] = linked.back();
+			linked.pop_back();
+		}
+
+		if (iteration % 100 == 0) {
+			CHECK_EQUAL((int)linked.size(), check_tree());
+		}
+
+		if (!linked.empty()) {
+			uint32_t min_key = UINT32_MAX;
+
+			for (size_t pos = 0; pos < linked.size(); pos++) {
+				min_key = std::min(min_key, m_item[linked[pos]].key);
+			}
+
+			CHECK_EQUAL(min_key, TEST_RBTREE_ITEM_GET(rbtree_first(&m_tree))->key);
+		} else {
+			POINTERS_EQUAL(NULL, rbtree_first(&m_tree));
+		}
+	}
+
+	CHECK_EQUAL((int)linked.size(), check_tree());
+}
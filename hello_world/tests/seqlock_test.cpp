@@ -0,0 +1,160 @@
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <CppUTest/TestHarness.h>
+
+#include "sys/seqlock.h"
+
+#define TEST_SEQLOCK_WRITES 200000
+#define TEST_SEQLOCK_READERS 3
+
+/* Every field is derived from the same counter, a torn read mixes values of different writes */
+typedef struct {
+	uint64_t timestamp;
+	uint32_t value;
+	uint32_t value_inverted;
+	uint8_t bytes[12];
+} test_sample_t;
+
+static void test_sample_fill(volatile test_sample_t *sample, uint32_t counter)
+{
+	sample->timestamp = ((uint64_t)counter << 32) | counter;
+	sample->value = counter;
+	sample->value_inverted = ~counter;
+	for (int idx = 0; idx < 12; idx++) {
+		sample->bytes[idx] = (uint8_t)(counter + idx);
+	}
+}
+
+static bool test_sample_consistent(const test_sample_t *sample)
+{
+	uint32_t counter = sample->value;
+
+	if (sample->timestamp != (((uint64_t)counter << 32) | counter) ||
+	    sample->value_inverted != ~counter) {
+		return false;
+	}
+
+	for (int idx = 0; idx < 12; idx++) {
+		if (sample->bytes[idx] != (uint8_t)(counter + idx)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void test_sample_copy(test_sample_t *copy, const volatile test_sample_t *sample)
+{
+	copy->timestamp = sample->timestamp;
+	copy->value = sample->value;
+	copy->value_inverted = sample->value_inverted;
+	for (int idx = 0; idx < 12; idx++) {
+		copy->bytes[idx] = sample->bytes[idx];
+	}
+}
+
+TEST_GROUP(seqlock_tests)
+{
+	seqlock_t m_lock;
+	volatile test_sample_t m_sample;
+
+	void setup()
+	{
+		seqlock_init(&m_lock);
+		test_sample_fill(&m_sample, 0);
+	}
+};
+
+TEST(seqlock_tests, seqlock_read_without_writer_test)
+{
+	uint32_t seq = seqlock_read_begin(&m_lock);
+
+	CHECK_FALSE(seqlock_read_retry(&m_lock, seq));
+}
+
+TEST(seqlock_tests, seqlock_read_during_write_retries_test)
+{
+	seqlock_write_begin(&m_lock);
+	uint32_t seq = seqlock_read_begin(&m_lock);
+
+	CHECK_TRUE(seqlock_read_retry(&m_lock, seq));
+
+	seqlock_write_end(&m_lock);
+	CHECK_TRUE(seqlock_read_retry(&m_lock, seq));
+}
+
+TEST(seqlock_tests, seqlock_read_overlapping_write_retries_test)
+{
+	uint32_t seq = seqlock_read_begin(&m_lock);
+
+	seqlock_write_begin(&m_lock);
+	seqlock_write_end(&m_lock);
+
+	CHECK_TRUE(seqlock_read_retry(&m_lock, seq));
+
+	seq = seqlock_read_begin(&m_lock);
+	CHECK_FALSE(seqlock_read_retry(&m_lock, seq));
+}
+
+/* Stress test with a writer and readers in host threads, running in parallel on many cores. Any torn read accepted
+ * by a reader fails the test.
+ */
+TEST(seqlock_tests, seqlock_stress_no_torn_reads_test)
+{
+	std::atomic<bool> done(false);
+	std::atomic<uint32_t> ready(0);
+	std::atomic<uint32_t> torn(0);
+	std::atomic<uint32_t> reads(0);
+	std::vector<std::thread> readers;
+
+	for (int idx = 0; idx < TEST_SEQLOCK_READERS; idx++) {
+		readers.push_back(std::thread([&]() {
+			test_sample_t copy;
+			uint32_t last = 0;
+			uint32_t seq;
+
+			ready++;
+
+			/* At least one read is done even if the writer has already finished */
+			do {
+				do {
+					seq = seqlock_read_begin(&m_lock);
+					test_sample_copy(&copy, &m_sample);
+				} while (seqlock_read_retry(&m_lock, seq));
+
+				/* Single writer stores increasing counter, so it may not go back */
+				if (!test_sample_consistent(&copy) || copy.value < last) {
+					torn++;
+				}
+
+				last = copy.value;
+				reads++;
+			} while (!done.load());
+		}));
+	}
+
+	/* Don't let the writer finish before the readers are scheduled */
+	while (ready.load() < TEST_SEQLOCK_READERS) {
+		std::this_thread::yield();
+	}
+
+	for (uint32_t counter = 1; counter <= TEST_SEQLOCK_WRITES; counter++) {
+		seqlock_write_begin(&m_lock);
+		test_sample_fill(&m_sample, counter);
+		seqlock_write_end(&m_lock);
+	}
+
+	done.store(true);
+	for (std::thread &reader : readers) {
+		reader.join();
+	}
+
+	CHECK_EQUAL(0, torn.load());
+	CHECK_TRUE(reads.load() > 0);
+	CHECK_EQUAL(TEST_SEQLOCK_WRITES, m_sample.value);
+}
@@ -301,4 +301,63 @@ TEST(slist_remove_node_tests, test_slist_remove_next_that_is_one_after_tail)
 	
 	node = slist_next_peek(&m_node[test_idx]);
 	CHECK_TRUE(node == NULL);
-}
\ No newline at end of file
+}
+TEST(slist_remove_node_tests, test_slist_find_remove_head)
+{
+	bool removed;
+
+	removed = slist_find_remove(&m_list, &m_node[0]);
+
+	CHECK_TRUE(removed);
+	CHECK_TRUE(slist_head_peek(&m_list) == &m_node[1]);
+}
+
+TEST(slist_remove_node_tests, test_slist_find_remove_mid)
+{
+	bool removed;
+	int test_idx = 2; /* Middle of the list nodes */
+
+	removed = slist_find_remove(&m_list, &m_node[test_idx]);
+
+	CHECK_TRUE(removed);
+	CHECK_TRUE(slist_next_peek(&m_node[test_idx - 1]) == &m_node[test_idx + 1]);
+	CHECK_TRUE(m_node[test_idx].next == NULL);
+}
+
+TEST(slist_remove_node_tests, test_slist_find_remove_tail)
+{
+	bool removed;
+
+	removed = slist_find_remove(&m_list, &m_node[NODES_NUMBER - 1]);
+
+	CHECK_TRUE(removed);
+	CHECK_TRUE(slist_tail_peek(&m_list) == &m_node[NODES_NUMBER - 2]);
+	CHECK_TRUE(slist_next_peek(&m_node[NODES_NUMBER - 2]) == NULL);
+}
+
+TEST(slist_remove_node_tests, test_slist_find_remove_not_in_list)
+{
+	slist_node_t node = { .next = NULL };
+	bool removed;
+
+	removed = slist_find_remove(&m_list, &node);
+
+	CHECK_FALSE(removed);
+	CHECK_TRUE(slist_head_peek(&m_list) == &m_node[0]);
+	CHECK_TRUE(slist_tail_peek(&m_list) == &m_node[NODES_NUMBER - 1]);
+}
+
+TEST(slist_remove_node_tests, test_slist_find_remove_last_node)
+{
+	slist_node_t node = { .next = NULL };
+	bool removed;
+
+	slist_init(&m_list);
+	slist_tail_put(&m_list, &node);
+
+	removed = slist_find_remove(&m_list, &node);
+
+	CHECK_TRUE(removed);
+	CHECK_TRUE(slist_head_peek(&m_list) == NULL);
+	CHECK_TRUE(slist_tail_peek(&m_list) == NULL);
+}
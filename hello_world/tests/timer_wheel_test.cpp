@@ -0,0 +1,149 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <CppUTest/TestHarness.h>
+
+#include "timer_wheel.h"
+#include "tools/misc.h"
+
+TEST_GROUP(timer_wheel_tests)
+{
+	static const int NODES_NUMBER = 64;
+	timer_wheel_t *m_wheel;
+	timer_wheel_node_t m_node[NODES_NUMBER];
+	dlist_t m_expired;
+
+	void setup()
+	{
+		m_wheel = new timer_wheel_t();
+		timer_wheel_init(m_wheel, 0);
+		dlist_init(&m_expired);
+
+		for (int idx = 0; idx < NODES_NUMBER; idx++) {
+			m_node[idx].node.next = NULL;
+			m_node[idx].node.prev = NULL;
+		}
+	}
+
+	void teardown()
+	{
+		delete m_wheel;
+	}
+
+	/* Advance the wheel until the node expires, returns tick the node expired at or UINT32_MAX */
+	uint32_t advance_until_expired(timer_wheel_node_t * node, uint32_t max_ticks)
+	{
+		for (uint32_t idx = 0; idx < max_ticks; idx++) {
+			uint32_t tick = m_wheel->tick;
+
+			timer_wheel_advance(m_wheel, &m_expired);
+
+			if (dlist_head_peek(&m_expired) != NULL) {
+				POINTERS_EQUAL(&node->node, dlist_head_get(&m_expired));
+				CHECK_TRUE(dlist_is_empty(&m_expired));
+
+				return tick;
+			}
+		}
+
+		return UINT32_MAX;
+	}
+};
+
+TEST(timer_wheel_tests, timer_wheel_expires_at_exact_tick_test)
+{
+	/* Expiries that land in each level and on level boundaries */
+	const uint32_t expiries[] = { 0, 1, 63, 64, 65, 4095, 4096, 4097, 262143, 262144, 300000 };
+
+	for (uint32_t idx = 0; idx < ARRAY_SIZE(expiries); idx++) {
+		timer_wheel_init(m_wheel, 0);
+		timer_wheel_add(m_wheel, &m_node[0], expiries[idx]);
+
+		CHECK_EQUAL(expiries[idx], advance_until_expired(&m_node[0], expiries[idx] + 2));
+		CHECK_FALSE(timer_wheel_node_is_active(&m_node[0]));
+	}
+}
+
+TEST(timer_wheel_tests, timer_wheel_expires_relative_to_current_tick_test)
+{
+	/* Start at odd tick, so slot boundaries are not aligned with the expiry */
+	timer_wheel_init(m_wheel, 1000);
+
+	for (int idx = 0; idx < 5000; idx++) {
+		timer_wheel_advance(m_wheel, &m_expired);
+	}
+
+	uint32_t expiry = m_wheel->tick + 5000;
+	timer_wheel_add(m_wheel, &m_node[0], expiry);
+
+	CHECK_EQUAL(expiry, advance_until_expired(&m_node[0], 5002));
+}
+
+TEST(timer_wheel_tests, timer_wheel_expiry_in_past_expires_next_tick_test)
+{
+	timer_wheel_init(m_wheel, 100);
+	timer_wheel_add(m_wheel, &m_node[0], 50);
+
+	CHECK_EQUAL(100, advance_until_expired(&m_node[0], 2));
+}
+
+TEST(timer_wheel_tests, timer_wheel_expiry_beyond_range_test)
+{
+	uint32_t expiry = TIMER_WHEEL_RANGE + 1000;
+
+	timer_wheel_add(m_wheel, &m_node[0], expiry);
+
+	CHECK_EQUAL(expiry, advance_until_expired(&m_node[0], expiry + 2));
+}
+
+TEST(timer_wheel_tests, timer_wheel_expires_across_tick_wrap_test)
+{
+	timer_wheel_init(m_wheel, UINT32_MAX - 100);
+	timer_wheel_add(m_wheel, &m_node[0], 200);
+
+	CHECK_EQUAL(200, advance_until_expired(&m_node[0], 400));
+}
+
+TEST(timer_wheel_tests, timer_wheel_removed_node_does_not_expire_test)
+{
+	timer_wheel_add(m_wheel, &m_node[0], 100);
+	CHECK_TRUE(timer_wheel_node_is_active(&m_node[0]));
+
+	timer_wheel_remove(&m_node[0]);
+	CHECK_FALSE(timer_wheel_node_is_active(&m_node[0]));
+
+	for (int idx = 0; idx < 200; idx++) {
+		timer_wheel_advance(m_wheel, &m_expired);
+	}
+
+	CHECK_TRUE(dlist_is_empty(&m_expired));
+}
+
+TEST(timer_wheel_tests, timer_wheel_many_nodes_expire_in_order_test)
+{
+	uint32_t expiry[NODES_NUMBER];
+
+	srand(1);
+	for (int idx = 0; idx < NODES_NUMBER; idx++) {
+		expiry[idx] = (uint32_t)(rand() % 20000);
+		timer_wheel_add(m_wheel, &m_node[idx], expiry[idx]);
+	}
+
+	int expired_count = 0;
+
+	for (uint32_t tick = 0; tick <= 20000; tick++) {
+		timer_wheel_advance(m_wheel, &m_expired);
+
+		dlist_node_t *node;
+		while ((node = dlist_head_get(&m_expired)) != NULL) {
+			timer_wheel_node_t *wheel_node = CONTAINER_OF(node, timer_wheel_node_t, node);
+
+			CHECK_EQUAL(tick, wheel_node->expiry);
+			expired_count++;
+		}
+	}
+
+	CHECK_EQUAL(NODES_NUMBER, expired_count);
+}
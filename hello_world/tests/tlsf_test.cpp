@@ -0,0 +1,365 @@
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include <CppUTest/TestHarness.h>
+
+#include "tlsf.h"
+
+#define TEST_TLSF_POOL_SIZE (64 * 1024)
+
+TEST_GROUP(tlsf_tests)
+{
+	tlsf_t m_tlsf;
+	uint8_t *m_pool;
+	size_t m_initial_free;
+
+	void setup()
+	{
+		m_pool = (uint8_t *)malloc(TEST_TLSF_POOL_SIZE);
+
+		tlsf_init(&m_tlsf);
+		CHECK_EQUAL(0, tlsf_pool_add(&m_tlsf, m_pool, TEST_TLSF_POOL_SIZE));
+
+		m_initial_free = largest_free_get();
+	}
+
+	void teardown()
+	{
+		free(m_pool);
+	}
+
+	size_t largest_free_get()
+	{
+		tlsf_stats_t stats;
+
+		tlsf_stats_get(&m_tlsf, &stats);
+
+		return stats.largest_free;
+	}
+
+	bool in_pool(void *ptr, size_t size)
+	{
+		return (uint8_t *)ptr >= m_pool && (uint8_t *)ptr + size <= m_pool + TEST_TLSF_POOL_SIZE;
+	}
+};
+
+TEST(tlsf_tests, test_init_pool_single_free_block)
+{
+	tlsf_stats_t stats;
+
+	tlsf_stats_get(&m_tlsf, &stats);
+
+	CHECK_EQUAL(1, stats.free_blocks);
+	CHECK_EQUAL(stats.largest_free, stats.free_size);
+	CHECK(stats.free_size > TEST_TLSF_POOL_SIZE - 4 * TLSF_ALIGN_SIZE);
+	CHECK_EQUAL(0, stats.used_size);
+	CHECK(tlsf_check(&m_tlsf));
+}
+
+TEST(tlsf_tests, test_pool_add_too_small)
+{
+	tlsf_t tlsf;
+	uint8_t mem[8];
+
+	tlsf_init(&tlsf);
+
+	CHECK_EQUAL(-EINVAL, tlsf_pool_add(&tlsf, mem, sizeof(mem)));
+	POINTERS_EQUAL(NULL, tlsf_malloc(&tlsf, 1));
+}
+
+TEST(tlsf_tests, test_malloc_zero_and_too_large)
+{
+	POINTERS_EQUAL(NULL, tlsf_malloc(&m_tlsf, 0));
+	POINTERS_EQUAL(NULL, tlsf_malloc(&m_tlsf, TEST_TLSF_POOL_SIZE));
+	POINTERS_EQUAL(NULL, tlsf_malloc(&m_tlsf, SIZE_MAX));
+	CHECK(tlsf_check(&m_tlsf));
+}
+
+TEST(tlsf_tests, test_malloc_aligned_in_pool)
+{
+	for (size_t size = 1; size < 300; size += 7) {
+		void *ptr = tlsf_malloc(&m_tlsf, size);
+
+		CHECK(ptr != NULL);
+		CHECK_EQUAL(0, (uintptr_t)ptr % TLSF_ALIGN_SIZE);
+		CHECK(tlsf_block_size(ptr) >= size);
+		CHECK(in_pool(ptr, size));
+	}
+
+	CHECK(tlsf_check(&m_tlsf));
+}
+
+TEST(tlsf_tests, test_free_null)
+{
+	tlsf_free(&m_tlsf, NULL);
+
+	CHECK(tlsf_check(&m_tlsf));
+}
+
+TEST(tlsf_tests, test_free_merges_with_neighbours)
+{
+	void *first = tlsf_malloc(&m_tlsf, 100);
+	void *second = tlsf_malloc(&m_tlsf, 100);
+	void *third = tlsf_malloc(&m_tlsf, 100);
+	void *guard = tlsf_malloc(&m_tlsf, 100);
+	tlsf_stats_t stats;
+
+	/* Free blocks in order that merges with previous, then next, then both */
+	tlsf_free(&m_tlsf, first);
+	tlsf_free(&m_tlsf, third);
+	tlsf_stats_get(&m_tlsf, &stats);
+	CHECK_EQUAL(3, stats.free_blocks);
+	CHECK(tlsf_check(&m_tlsf));
+
+	tlsf_free(&m_tlsf, second);
+	tlsf_stats_get(&m_tlsf, &stats);
+	CHECK_EQUAL(2, stats.free_blocks);
+	CHECK(tlsf_check(&m_tlsf));
+
+	/* The merged block is reused for a request that is larger than any of the original blocks */
+	void *merged = tlsf_malloc(&m_tlsf, 300);
+	POINTERS_EQUAL(first, merged);
+
+	tlsf_free(&m_tlsf, merged);
+	tlsf_free(&m_tlsf, guard);
+
+	tlsf_stats_get(&m_tlsf, &stats);
+	CHECK_EQUAL(1, stats.free_blocks);
+	CHECK_EQUAL(m_initial_free, stats.largest_free);
+	CHECK(tlsf_check(&m_tlsf));
+}
+
+TEST(tlsf_tests, test_exhaust_and_release)
+{
+	std::vector<void *> blocks;
+	void *ptr;
+	tlsf_stats_t stats;
+
+	while ((ptr = tlsf_malloc(&m_tlsf, 64)) != NULL) {
+		blocks.push_back(ptr);
+	}
+
+	tlsf_stats_get(&m_tlsf, &stats);
+	CHECK(blocks.size() > TEST_TLSF_POOL_SIZE / 128);
+	CHECK_EQUAL(1, stats.failures);
+	CHECK(tlsf_check(&m_tlsf));
+
+	/* Release every second block first, to get maximum number of free blocks */
+	for (size_t idx = 0; idx < blocks.size(); idx += 2) {
+		tlsf_free(&m_tlsf, blocks[idx]);
+	}
+	CHECK(tlsf_check(&m_tlsf));
+
+	for (size_t idx = 1; idx < blocks.size(); idx += 2) {
+		tlsf_free(&m_tlsf, blocks[idx]);
+	}
+
+	tlsf_stats_get(&m_tlsf, &stats);
+	CHECK_EQUAL(1, stats.free_blocks);
+	CHECK_EQUAL(m_initial_free, stats.largest_free);
+	CHECK_EQUAL(0, stats.used_size);
+	CHECK(tlsf_check(&m_tlsf));
+}
+
+TEST(tlsf_tests, test_largest_free_block_allocable)
+{
+	void *ptr = tlsf_malloc(&m_tlsf, m_initial_free);
+
+	/* Search rounds the size up to next list, so the whole pool may not be found in its own list */
+	if (ptr == NULL) {
+		ptr = tlsf_malloc(&m_tlsf, m_initial_free - m_initial_free / TLSF_SL_INDEX_COUNT);
+	}
+
+	CHECK(ptr != NULL);
+
+	tlsf_free(&m_tlsf, ptr);
+	CHECK(tlsf_check(&m_tlsf));
+}
+
+TEST(tlsf_tests, test_independent_heaps)
+{
+	tlsf_t other;
+	uint8_t *other_pool = (uint8_t *)malloc(1024);
+	tlsf_stats_t stats;
+
+	tlsf_init(&other);
+	CHECK_EQUAL(0, tlsf_pool_add(&other, other_pool, 1024));
+
+	void *ptr = tlsf_malloc(&other, 512);
+
+	CHECK((uint8_t *)ptr >= other_pool && (uint8_t *)ptr < other_pool + 1024);
+	POINTERS_EQUAL(NULL, tlsf_malloc(&other, 1024));
+
+	tlsf_stats_get(&m_tlsf, &stats);
+	CHECK_EQUAL(0, stats.used_size);
+	CHECK_EQUAL(m_initial_free, stats.largest_free);
+
+	tlsf_free(&other, ptr);
+	CHECK(tlsf_check(&other));
+
+	free(other_pool);
+}
+
+TEST(tlsf_tests, test_multiple_pools)
+{
+	uint8_t *second_pool = (uint8_t *)malloc(TEST_TLSF_POOL_SIZE);
+
+	CHECK_EQUAL(0, tlsf_pool_add(&m_tlsf, second_pool, TEST_TLSF_POOL_SIZE));
+
+	/* Two large blocks fit in separate pools only */
+	void *first = tlsf_malloc(&m_tlsf, TEST_TLSF_POOL_SIZE / 2 + 1024);
+	void *second = tlsf_malloc(&m_tlsf, TEST_TLSF_POOL_SIZE / 2 + 1024);
+
+	CHECK(first != NULL);
+	CHECK(second != NULL);
+	CHECK(in_pool(first, 1) != in_pool(second, 1));
+
+	tlsf_free(&m_tlsf, first);
+	tlsf_free(&m_tlsf, second);
+
+	tlsf_stats_t stats;
+
+	tlsf_stats_get(&m_tlsf, &stats);
+	CHECK_EQUAL(2, stats.free_blocks);
+	CHECK(tlsf_check(&m_tlsf));
+
+	free(second_pool);
+}
+
+TEST(tlsf_tests, test_random_churn_keeps_data)
+{
+	std::mt19937 rng(1234);
+	std::vector<std::pair<uint8_t *, size_t> > blocks;
+
+	for (int iteration = 0; iteration < 20000; iteration++) {
+		if (blocks.empty() || (rng() % 3) != 0) {
+			size_t size = 1 + rng() % 700;
+			uint8_t *ptr = (uint8_t *)tlsf_malloc(&m_tlsf, size);
+
+			if (ptr != NULL) {
+				memset(ptr, (uint8_t)(uintptr_t)ptr, size);
+				blocks.push_back(std::make_pair(ptr, size));
+			}
+		} else {
+			size_t idx = rng() % blocks.size();
+			uint8_t *ptr = blocks[idx].first;
+
+			/* Data isn't overwritten by other allocations or by allocator metadata */
+			for (size_t byte = 0; byte < blocks[idx].second; byte++) {
+				CHECK_EQUAL((uint8_t)(uintptr_t)ptr, ptr[byte]);
+			}
+
+			tlsf_free(&m_tlsf, ptr);
+			blocks[idx] = blocks.back();
+			blocks.pop_back();
+		}
+
+		if ((iteration % 1000) == 0) {
+			CHECK(tlsf_check(&m_tlsf));
+		}
+	}
+
+	for (size_t idx = 0; idx < blocks.size(); idx++) {
+		tlsf_free(&m_tlsf, blocks[idx].first);
+	}
+
+	CHECK_EQUAL(m_initial_free, largest_free_get());
+	CHECK(tlsf_check(&m_tlsf));
+}
+
+/* Benchmarks on host. Those print results and check only what doesn't depend on the host speed. */
+TEST_GROUP(tlsf_bench)
+{
+	static const int OPERATIONS = 200000;
+	static const size_t POOL_SIZE = 256 * 1024;
+	tlsf_t m_tlsf;
+	uint8_t *m_pool;
+
+	void setup()
+	{
+		m_pool = (uint8_t *)malloc(POOL_SIZE);
+
+		tlsf_init(&m_tlsf);
+		tlsf_pool_add(&m_tlsf, m_pool, POOL_SIZE);
+	}
+
+	void teardown()
+	{
+		free(m_pool);
+	}
+};
+
+/* Packet-like workload: mixed small and large sizes, random lifetime, heap kept at about half of its size */
+TEST(tlsf_bench, bench_latency_and_fragmentation)
+{
+	typedef std::chrono::steady_clock clock;
+	std::mt19937 rng(42);
+	std::vector<void *> blocks;
+	uint64_t malloc_total_ns = 0;
+	uint64_t malloc_max_ns = 0;
+	uint64_t free_total_ns = 0;
+	uint64_t free_max_ns = 0;
+	uint32_t mallocs = 0;
+	uint32_t frees = 0;
+	size_t worst_largest_free = SIZE_MAX;
+	tlsf_stats_t stats;
+
+	for (int iteration = 0; iteration < OPERATIONS; iteration++) {
+		tlsf_stats_get(&m_tlsf, &stats);
+
+		if (blocks.empty() || (stats.used_size < POOL_SIZE / 2 && (rng() % 2) == 0)) {
+			size_t size = ((rng() % 8) == 0) ? 1024 + rng() % 3072 : 16 + rng() % 240;
+
+			clock::time_point start = clock::now();
+			void *ptr = tlsf_malloc(&m_tlsf, size);
+			uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+
+			malloc_total_ns += ns;
+			malloc_max_ns = std::max(malloc_max_ns, ns);
+			mallocs++;
+
+			CHECK(ptr != NULL);
+			blocks.push_back(ptr);
+		} else {
+			size_t idx = rng() % blocks.size();
+
+			clock::time_point start = clock::now();
+			tlsf_free(&m_tlsf, blocks[idx]);
+			uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+
+			free_total_ns += ns;
+			free_max_ns = std::max(free_max_ns, ns);
+			frees++;
+
+			blocks[idx] = blocks.back();
+			blocks.pop_back();
+
+			tlsf_stats_get(&m_tlsf, &stats);
+			worst_largest_free = std::min(worst_largest_free, stats.largest_free);
+		}
+	}
+
+	tlsf_stats_get(&m_tlsf, &stats);
+
+	printf("\ntlsf malloc: %u ops, avg %llu ns, max %llu ns\n", mallocs,
+	       (unsigned long long)(malloc_total_ns / mallocs), (unsigned long long)malloc_max_ns);
+	printf("tlsf free: %u ops, avg %llu ns, max %llu ns\n", frees,
+	       (unsigned long long)(free_total_ns / frees), (unsigned long long)free_max_ns);
+	printf("tlsf fragmentation: %u free blocks, largest free %zu of %zu free bytes, worst largest free %zu\n",
+	       stats.free_blocks, stats.largest_free, stats.free_size, worst_largest_free);
+
+	/* Half of the heap is free all the time, so the largest packet fits even with fragmentation */
+	CHECK_EQUAL(0, stats.failures);
+	CHECK(worst_largest_free >= 4096);
+	CHECK(tlsf_check(&m_tlsf));
+}
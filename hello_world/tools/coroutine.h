@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2023 Piotr Pryga
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __TOOLS_COROUTINE_H__
+#define __TOOLS_COROUTINE_H__
+
+/** @file This is a stackless coroutine implementation based on Duff's device.
+ *
+ * A coroutine is a function that is called again and again. Each call resumes execution at the place where previous
+ * call returned, that place is stored in coroutine local continuation. Coroutines don't have own stacks, hence
+ * local variables of a coroutine function are not preserved between calls. Keep the state in a structure that
+ * embeds coro_t and get it with CONTAINER_OF().
+ *
+ * Mind that the implementation uses switch statement, so a coroutine function may not use switch statement that
+ * has a CORO_ macro inside of its case.
+ *
+ * Example:
+ *
+ * struct blinky {
+ *      coro_t coro;
+ *      int count;
+ * };
+ *
+ * int blinky_coro(coro_t *coro)
+ * {
+ *      struct blinky *blinky = CONTAINER_OF(coro, struct blinky, coro);
+ *
+ *      CORO_BEGIN(coro);
+ *      for (blinky->count = 0; blinky->count < 10; blinky->count++) {
+ *              led_toggle();
+ *              CORO_YIELD(coro);
+ *      }
+ *      CORO_END(coro);
+ * }
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "slist.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* Values returned by a coroutine function to its runner */
+typedef enum CORO_RESULT {
+	/* Coroutine gave up the CPU but is ready to be resumed */
+	CORO_YIELDED,
+	/* Coroutine waits for an object, it is resumed when the object is signalled */
+	CORO_WAITING,
+	/* Coroutine reached CORO_END */
+	CORO_ENDED,
+} CORO_RESULT_T;
+
+struct coro;
+
+typedef int (*coro_func_t)(struct coro *coro);
+
+/** @brief The structure holds a coroutine state.
+ *
+ * List node is used by a runner ready list or by a wait list of an object the coroutine waits for.
+ */
+typedef struct coro {
+	slist_node_t node;
+	coro_func_t func;
+	/* Runner the coroutine is executed by, opaque for coroutine macros */
+	void *runner;
+	/* Local continuation, line number where the coroutine is resumed. Zero means beginning. */
+	uint16_t lc;
+	uint16_t state;
+} coro_t;
+
+/* @brief Initialize a coroutine, next call to its function starts from the beginning.
+ *
+ * @param coro Pointer to coroutine
+ * @param coro_func Coroutine function
+ */
+#define CORO_INIT(coro, coro_func)                                                                 \
+	do {                                                                                       \
+		(coro)->node.next = NULL;                                                          \
+		(coro)->func = (coro_func);                                                        \
+		(coro)->runner = NULL;                                                             \
+		(coro)->lc = 0;                                                                    \
+		(coro)->state = 0;                                                                 \
+	} while (0)
+
+/* @brief Start of a coroutine body, must be the first statement of coroutine function that uses CORO_ macros */
+#define CORO_BEGIN(coro)                                                                           \
+	switch ((coro)->lc) {                                                                      \
+	case 0:
+
+/* @brief End of a coroutine body. Coroutine is restarted from beginning if it is called again. */
+#define CORO_END(coro)                                                                             \
+	}                                                                                          \
+	(coro)->lc = 0;                                                                            \
+	return CORO_ENDED
+
+/* @brief Store a place of resume and return given result to a runner */
+#define CORO_SUSPEND_(coro, result)                                                                \
+	do {                                                                                       \
+		(coro)->lc = __LINE__;                                                             \
+		return (result);                                                                   \
+	case __LINE__:;                                                                            \
+	} while (0)
+
+/* @brief Give up the CPU, coroutine is resumed after other ready coroutines */
+#define CORO_YIELD(coro) CORO_SUSPEND_(coro, CORO_YIELDED)
+
+/* @brief Yield until condition is true. The condition is evaluated every time the coroutine is resumed. */
+#define CORO_WAIT_UNTIL(coro, cond)                                                                \
+	do {                                                                                       \
+		(coro)->lc = __LINE__;                                                             \
+	case __LINE__:                                                                             \
+		if (!(cond)) {                                                                     \
+			return CORO_YIELDED;                                                       \
+		}                                                                                  \
+	} while (0)
+
+/* @brief Wait for an object.
+ *
+ * The try_wait expression must return non zero if the object is acquired. If it returns zero it is responsible for
+ * putting the coroutine into wait list of the object, the coroutine is resumed when the object is signalled and
+ * try_wait is evaluated again.
+ */
+#define CORO_AWAIT(coro, try_wait)                                                                 \
+	do {                                                                                       \
+		(coro)->lc = __LINE__;                                                             \
+	case __LINE__:                                                                             \
+		if (!(try_wait)) {                                                                 \
+			return CORO_WAITING;                                                       \
+		}                                                                                  \
+	} while (0)
+
+/* @brief Restart the coroutine from beginning on next resume */
+#define CORO_RESTART(coro)                                                                         \
+	do {                                                                                       \
+		(coro)->lc = 0;                                                                    \
+		return CORO_YIELDED;                                                               \
+	} while (0)
+
+/* @brief Exit the coroutine */
+#define CORO_EXIT(coro)                                                                            \
+	do {                                                                                       \
+		(coro)->lc = 0;                                                                    \
+		return CORO_ENDED;                                                                 \
+	} while (0)
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __TOOLS_COROUTINE_H__ */
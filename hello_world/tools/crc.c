@@ -0,0 +1,147 @@
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "crc.h"
+
+/* Number of 256-entry CRC-32 tables, each takes 1 KB of flash:
+ * 0 - no table, bitwise computation,
+ * 1 - byte at a time,
+ * 4 - slice-by-4, four bytes at a time,
+ * 8 - slice-by-8, eight bytes at a time.
+ */
+#ifndef CRC32_TABLE_SLICES
+#define CRC32_TABLE_SLICES 8
+#endif /* CRC32_TABLE_SLICES */
+
+/* CRC-16-CCITT uses a 512 B table if enabled, bitwise computation otherwise */
+#ifndef CRC16_TABLE_ENABLED
+#define CRC16_TABLE_ENABLED 1
+#endif /* CRC16_TABLE_ENABLED */
+
+/* CRC-8 uses a 256 B table if enabled, bitwise computation otherwise */
+#ifndef CRC8_TABLE_ENABLED
+#define CRC8_TABLE_ENABLED 1
+#endif /* CRC8_TABLE_ENABLED */
+
+#if CRC32_TABLE_SLICES != 0 && CRC32_TABLE_SLICES != 1 && CRC32_TABLE_SLICES != 4 && CRC32_TABLE_SLICES != 8
+#error "CRC32_TABLE_SLICES must be 0, 1, 4 or 8"
+#endif
+
+#if CRC32_TABLE_SLICES >= 4 && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "Slice-by-N CRC-32 supports little-endian CPUs only"
+#endif
+
+#define CRC32_POLY_REFLECTED 0xEDB88320UL
+#define CRC16_CCITT_POLY 0x1021
+#define CRC8_POLY 0x07
+
+#include "crc_table.h"
+
+#if CRC32_TABLE_SLICES > 0
+static inline uint32_t crc32_byte(uint32_t crc, uint8_t byte)
+{
+	return (crc >> 8) ^ crc32_table[0][(crc ^ byte) & 0xFF];
+}
+#else
+static inline uint32_t crc32_byte(uint32_t crc, uint8_t byte)
+{
+	crc ^= byte;
+
+	for (int bit = 0; bit < 8; bit++) {
+		crc = (crc >> 1) ^ (CRC32_POLY_REFLECTED & (0UL - (crc & 1)));
+	}
+
+	return crc;
+}
+#endif /* CRC32_TABLE_SLICES */
+
+uint32_t crc32_update(uint32_t crc, const void *data, size_t size)
+{
+	const uint8_t *byte = data;
+
+	/* CRC register is kept inverted between calls, so the result of a call is a final CRC */
+	crc = ~crc;
+
+#if CRC32_TABLE_SLICES >= 4
+	/* Words are read through aligned pointers, LDRD and LDM the compiler may use need aligned addresses */
+	while (size != 0 && ((uintptr_t)byte & (sizeof(uint32_t) - 1)) != 0) {
+		crc = crc32_byte(crc, *byte++);
+		size--;
+	}
+
+	const uint32_t *word = (const uint32_t *)byte;
+
+#if CRC32_TABLE_SLICES == 8
+	while (size >= 8) {
+		uint32_t low = *word++ ^ crc;
+		uint32_t high = *word++;
+
+		crc = crc32_table[7][low & 0xFF] ^ crc32_table[6][(low >> 8) & 0xFF] ^
+		      crc32_table[5][(low >> 16) & 0xFF] ^ crc32_table[4][low >> 24] ^
+		      crc32_table[3][high & 0xFF] ^ crc32_table[2][(high >> 8) & 0xFF] ^
+		      crc32_table[1][(high >> 16) & 0xFF] ^ crc32_table[0][high >> 24];
+		size -= 8;
+	}
+#endif /* CRC32_TABLE_SLICES == 8 */
+
+	while (size >= 4) {
+		uint32_t low = *word++ ^ crc;
+
+		crc = crc32_table[3][low & 0xFF] ^ crc32_table[2][(low >> 8) & 0xFF] ^
+		      crc32_table[1][(low >> 16) & 0xFF] ^ crc32_table[0][low >> 24];
+		size -= 4;
+	}
+
+	byte = (const uint8_t *)word;
+#endif /* CRC32_TABLE_SLICES >= 4 */
+
+	while (size != 0) {
+		crc = crc32_byte(crc, *byte++);
+		size--;
+	}
+
+	return ~crc;
+}
+
+uint16_t crc16_ccitt_update(uint16_t crc, const void *data, size_t size)
+{
+	const uint8_t *byte = data;
+
+	while (size != 0) {
+#if CRC16_TABLE_ENABLED
+		crc = (uint16_t)((crc << 8) ^ crc16_ccitt_table[((crc >> 8) ^ *byte) & 0xFF]);
+#else
+		crc ^= (uint16_t)(*byte << 8);
+
+		for (int bit = 0; bit < 8; bit++) {
+			crc = (uint16_t)((crc & 0x8000) ? ((crc << 1) ^ CRC16_CCITT_POLY) : (crc << 1));
+		}
+#endif /* CRC16_TABLE_ENABLED */
+		byte++;
+		size--;
+	}
+
+	return crc;
+}
+
+uint8_t crc8_update(uint8_t crc, const void *data, size_t size)
+{
+	const uint8_t *byte = data;
+
+	while (size != 0) {
+#if CRC8_TABLE_ENABLED
+		crc = crc8_table[crc ^ *byte];
+#else
+		crc ^= *byte;
+
+		for (int bit = 0; bit < 8; bit++) {
+			crc = (uint8_t)((crc & 0x80) ? ((crc << 1) ^ CRC8_POLY) : (crc << 1));
+		}
+#endif /* CRC8_TABLE_ENABLED */
+		byte++;
+		size--;
+	}
+
+	return crc;
+}
@@ -0,0 +1,66 @@
+#ifndef __TOOLS_CRC_H__
+#define __TOOLS_CRC_H__
+
+/** @file Table driven CRC functions.
+ *
+ * Supported CRCs:
+ * - CRC-32 (IEEE 802.3, zlib, PNG), check value of "123456789" is 0xCBF43926,
+ * - CRC-16-CCITT (CCITT-FALSE: polynomial 0x1021, initial value 0xFFFF, not reflected), check value 0x29B1,
+ * - CRC-8 (polynomial 0x07, initial value 0), check value 0xF4.
+ *
+ * Each CRC is computed incrementally: pass the initial value to the first update call, then the result of previous
+ * call to the next one. The result of the last call is the final CRC, e.g. for a frame received in chunks:
+ *
+ *     uint32_t crc = CRC32_INIT;
+ *     crc = crc32_update(crc, header, sizeof(header));
+ *     crc = crc32_update(crc, payload, payload_size);
+ *
+ * Tables are constants in flash. Their size is selected at build time with CRC32_TABLE_SLICES, CRC16_TABLE_ENABLED
+ * and CRC8_TABLE_ENABLED, see crc.c. A CRC without table is computed bit by bit.
+ */
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define CRC32_INIT 0x00000000UL
+#define CRC16_CCITT_INIT 0xFFFF
+#define CRC8_INIT 0x00
+
+/* @brief Update CRC-32 with a block of data
+ *
+ * @param crc CRC32_INIT or result of previous call
+ * @param data Pointer to data
+ * @param size Number of bytes
+ *
+ * @return CRC-32 of all data passed so far
+ */
+uint32_t crc32_update(uint32_t crc, const void *data, size_t size);
+
+/* @brief Update CRC-16-CCITT with a block of data
+ *
+ * @param crc CRC16_CCITT_INIT or result of previous call
+ * @param data Pointer to data
+ * @param size Number of bytes
+ *
+ * @return CRC-16-CCITT of all data passed so far
+ */
+uint16_t crc16_ccitt_update(uint16_t crc, const void *data, size_t size);
+
+/* @brief Update CRC-8 with a block of data
+ *
+ * @param crc CRC8_INIT or result of previous call
+ * @param data Pointer to data
+ * @param size Number of bytes
+ *
+ * @return CRC-8 of all data passed so far
+ */
+uint8_t crc8_update(uint8_t crc, const void *data, size_t size);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __TOOLS_CRC_H__ */
@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2023 Piotr Pryga
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+
+"""Generate lookup tables of tools/crc.c.
+
+Tables are constants, so those are placed in flash. Run the script after a change of polynomials:
+    crc_table_gen.py -o crc_table.h
+"""
+
+import argparse
+import sys
+
+CRC32_POLY_REFLECTED = 0xEDB88320
+CRC32_SLICES = 8
+CRC16_CCITT_POLY = 0x1021
+CRC8_POLY = 0x07
+
+
+def crc32_tables():
+    tables = [[0] * 256 for _ in range(CRC32_SLICES)]
+    for byte in range(256):
+        crc = byte
+        for _ in range(8):
+            crc = (crc >> 1) ^ (CRC32_POLY_REFLECTED if crc & 1 else 0)
+        tables[0][byte] = crc
+    # Table k gives CRC of a byte followed by k zero bytes
+    for slice_idx in range(1, CRC32_SLICES):
+        for byte in range(256):
+            previous = tables[slice_idx - 1][byte]
+            tables[slice_idx][byte] = (previous >> 8) ^ tables[0][previous & 0xFF]
+    return tables
+
+
+def crc16_ccitt_table():
+    table = []
+    for byte in range(256):
+        crc = byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ (CRC16_CCITT_POLY if crc & 0x8000 else 0)) & 0xFFFF
+        table.append(crc)
+    return table
+
+
+def crc8_table():
+    table = []
+    for byte in range(256):
+        crc = byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ (CRC8_POLY if crc & 0x80 else 0)) & 0xFF
+        table.append(crc)
+    return table
+
+
+def format_values(values, width, per_line):
+    lines = []
+    for start in range(0, len(values), per_line):
+        chunk = values[start:start + per_line]
+        lines.append("\t" + " ".join("0x%0*X," % (width, value) for value in chunk))
+    return "\n".join(lines)
+
+
+def generate():
+    out = []
+    out.append("/* Generated by tools/crc_table_gen.py, do not edit. Included by tools/crc.c only. */")
+    out.append("")
+    out.append("#if CRC32_TABLE_SLICES > 0")
+    out.append("static const uint32_t crc32_table[CRC32_TABLE_SLICES][256] = {")
+    for slice_idx, table in enumerate(crc32_tables()):
+        guard = None
+        if slice_idx == 1:
+            guard = "#if CRC32_TABLE_SLICES >= 4"
+        elif slice_idx == 4:
+            guard = "#if CRC32_TABLE_SLICES == 8"
+        if guard:
+            out.append(guard)
+        out.append("\t{")
+        out.append("\t" + format_values(table, 8, 6).replace("\n", "\n\t"))
+        out.append("\t},")
+        if slice_idx == 3 or slice_idx == 7:
+            out.append("#endif")
+    out.append("};")
+    out.append("#endif /* CRC32_TABLE_SLICES */")
+    out.append("")
+    out.append("#if CRC16_TABLE_ENABLED")
+    out.append("static const uint16_t crc16_ccitt_table[256] = {")
+    out.append(format_values(crc16_ccitt_table(), 4, 8))
+    out.append("};")
+    out.append("#endif /* CRC16_TABLE_ENABLED */")
+    out.append("")
+    out.append("#if CRC8_TABLE_ENABLED")
+    out.append("static const uint8_t crc8_table[256] = {")
+    out.append(format_values(crc8_table(), 2, 12))
+    out.append("};")
+    out.append("#endif /* CRC8_TABLE_ENABLED */")
+    return "\n".join(out) + "\n"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("-o", "--output", help="output header file, stdout if not given")
+    args = parser.parse_args()
+
+    text = generate()
+
+    if args.output:
+        with open(args.output, "w") as output:
+            output.write(text)
+    else:
+        sys.stdout.write(text)
+
+
+if __name__ == "__main__":
+    main()
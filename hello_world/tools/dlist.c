@@ -0,0 +1,115 @@
+
+#include <assert.h>
+#include <stddef.h>
+#include "dlist.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+void dlist_init(dlist_t *list)
+{
+	assert(list);
+
+	list->next = list;
+	list->prev = list;
+}
+
+bool dlist_is_empty(dlist_t *list)
+{
+	assert(list);
+
+	return list->next == list;
+}
+
+dlist_node_t *dlist_head_peek(dlist_t *list)
+{
+	assert(list);
+
+	return (list->next != list) ? list->next : NULL;
+}
+
+dlist_node_t *dlist_head_get(dlist_t *list)
+{
+	dlist_node_t *head = dlist_head_peek(list);
+
+	if (head != NULL) {
+		dlist_remove(head);
+	}
+
+	return head;
+}
+
+/* Insert new node between two adjacent nodes */
+static void dlist_insert(dlist_node_t *prev, dlist_node_t *next, dlist_node_t *new_node)
+{
+	assert(new_node);
+	assert(!dlist_node_is_linked(new_node));
+
+	new_node->prev = prev;
+	new_node->next = next;
+	prev->next = new_node;
+	next->prev = new_node;
+}
+
+void dlist_head_put(dlist_t *list, dlist_node_t *new_node)
+{
+	assert(list);
+
+	dlist_insert(list, list->next, new_node);
+}
+
+void dlist_tail_put(dlist_t *list, dlist_node_t *new_node)
+{
+	assert(list);
+
+	dlist_insert(list->prev, list, new_node);
+}
+
+dlist_node_t *dlist_next_peek(dlist_t *list, dlist_node_t *node)
+{
+	assert(list);
+	assert(node);
+
+	return (node->next != list) ? node->next : NULL;
+}
+
+void dlist_remove(dlist_node_t *node)
+{
+	assert(node);
+	assert(dlist_node_is_linked(node));
+
+	node->prev->next = node->next;
+	node->next->prev = node->prev;
+
+	node->next = NULL;
+	node->prev = NULL;
+}
+
+bool dlist_node_is_linked(dlist_node_t *node)
+{
+	assert(node);
+
+	return node->next != NULL;
+}
+
+void dlist_tail_join(dlist_t *list, dlist_t *other)
+{
+	assert(list);
+	assert(other);
+
+	if (dlist_is_empty(other)) {
+		return;
+	}
+
+	other->next->prev = list->prev;
+	list->prev->next = other->next;
+	other->prev->next = list;
+	list->prev = other->prev;
+
+	dlist_init(other);
+}
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
@@ -0,0 +1,62 @@
+#ifndef __TOOLS_DLIST_H__
+#define __TOOLS_DLIST_H__
+
+/** @file This is a simple implementation of circular double linked list.
+ *
+ * A list is a sentinel node, empty list points to itself. All operations, including removal of any node
+ * in the list, are O(1). The list doesn't need to be known to remove a node from it.
+ */
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/** @brief The structure is an internal type used to form a double linked list.
+ *
+ * This structure may be a member of other structure that stored actual list node data. A node that
+ * isn't in any list has NULL pointers.
+ */
+typedef struct _dlist_node {
+	struct _dlist_node *next;
+	struct _dlist_node *prev;
+} dlist_node_t;
+
+/** @brief The stucture holds a list, it is a sentinel node */
+typedef dlist_node_t dlist_t;
+
+void dlist_init(dlist_t *list);
+bool dlist_is_empty(dlist_t *list);
+
+dlist_node_t *dlist_head_peek(dlist_t *list);
+dlist_node_t *dlist_head_get(dlist_t *list);
+void dlist_head_put(dlist_t *list, dlist_node_t *new_node);
+void dlist_tail_put(dlist_t *list, dlist_node_t *new_node);
+
+/** @brief Get next node of a list
+ *
+ * @return Pointer to next node, NULL if the node is tail of the list
+ */
+dlist_node_t *dlist_next_peek(dlist_t *list, dlist_node_t *node);
+
+/** @brief Remove a node from a list it is linked in
+ *
+ * @param node Pointer to a node to be removed, it must be linked in a list
+ */
+void dlist_remove(dlist_node_t *node);
+
+/** @brief Check if a node is linked in any list */
+bool dlist_node_is_linked(dlist_node_t *node);
+
+/** @brief Move all nodes of a list to end of other list, source list becomes empty
+ *
+ * @param list Pointer to a list the nodes are appended to
+ * @param other Pointer to a list the nodes are taken from
+ */
+void dlist_tail_join(dlist_t *list, dlist_t *other);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __TOOLS_DLIST_H__ */
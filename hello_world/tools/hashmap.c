@@ -0,0 +1,147 @@
+
+#include <assert.h>
+#include <errno.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "hashmap.h"
+
+/* 2^32 divided by golden ratio, multiplication by it spreads sequential keys evenly (Fibonacci hashing) */
+#define HASHMAP_HASH_MULTIPLIER 0x9E3779B1UL
+
+static inline uint32_t hashmap_home_slot(const hashmap_t *map, hashmap_key_t key)
+{
+	uint32_t hash = (uint32_t)key;
+
+#if UINTPTR_MAX > 0xFFFFFFFFUL
+	hash ^= (uint32_t)(key >> 32);
+#endif
+
+	/* Top bits of the product are the best mixed ones, but the shift would need log2 of capacity. The product is
+	 * folded instead, so lower bits depend on all bits of the key too.
+	 */
+	hash *= HASHMAP_HASH_MULTIPLIER;
+	hash ^= hash >> 16;
+
+	return hash & (map->capacity - 1);
+}
+
+/* @brief Find a slot that holds a key
+ *
+ * @return Index of the slot, capacity if the key isn't in the map
+ */
+static uint32_t hashmap_find(const hashmap_t *map, hashmap_key_t key)
+{
+	uint32_t mask = map->capacity - 1;
+	uint32_t slot = hashmap_home_slot(map, key);
+
+	/* Entries on the way are never closer to their home slot than the key would be, otherwise the key would have
+	 * taken the slot when it was added.
+	 */
+	for (uint32_t distance = 1; distance <= map->entries[slot].distance; distance++) {
+		if (map->entries[slot].key == key) {
+			return slot;
+		}
+
+		slot = (slot + 1) & mask;
+	}
+
+	return map->capacity;
+}
+
+void hashmap_init(hashmap_t *map, hashmap_entry_t *entries, uint32_t capacity)
+{
+	assert(map);
+	assert(entries);
+	assert(capacity != 0 && (capacity & (capacity - 1)) == 0);
+
+	memset(entries, 0, capacity * sizeof(hashmap_entry_t));
+
+	map->entries = entries;
+	map->capacity = capacity;
+	map->count = 0;
+}
+
+int hashmap_put(hashmap_t *map, hashmap_key_t key, void *value)
+{
+	assert(map);
+	assert(value);
+
+	if (hashmap_find(map, key) != map->capacity) {
+		return -EEXIST;
+	}
+
+	if (map->count == map->capacity) {
+		return -ENOMEM;
+	}
+
+	uint32_t mask = map->capacity - 1;
+	uint32_t slot = hashmap_home_slot(map, key);
+	hashmap_entry_t entry = { .key = key, .value = value, .distance = 1 };
+
+	/* There is a free slot, so the loop ends */
+	while (map->entries[slot].distance != 0) {
+		/* Take the slot from an entry that is closer to its home, then go on with that entry */
+		if (map->entries[slot].distance < entry.distance) {
+			hashmap_entry_t swap = map->entries[slot];
+
+			map->entries[slot] = entry;
+			entry = swap;
+		}
+
+		slot = (slot + 1) & mask;
+		entry.distance++;
+	}
+
+	map->entries[slot] = entry;
+	map->count++;
+
+	return 0;
+}
+
+void *hashmap_get(const hashmap_t *map, hashmap_key_t key)
+{
+	assert(map);
+
+	uint32_t slot = hashmap_find(map, key);
+
+	return (slot != map->capacity) ? map->entries[slot].value : NULL;
+}
+
+void *hashmap_remove(hashmap_t *map, hashmap_key_t key)
+{
+	assert(map);
+
+	uint32_t slot = hashmap_find(map, key);
+
+	if (slot == map->capacity) {
+		return NULL;
+	}
+
+	uint32_t mask = map->capacity - 1;
+	void *value = map->entries[slot].value;
+	uint32_t next = (slot + 1) & mask;
+
+	/* Shift back following entries until an empty one or one in its home slot */
+	while (map->entries[next].distance > 1) {
+		map->entries[slot] = map->entries[next];
+		map->entries[slot].distance--;
+
+		slot = next;
+		next = (next + 1) & mask;
+	}
+
+	map->entries[slot].key = 0;
+	map->entries[slot].value = NULL;
+	map->entries[slot].distance = 0;
+	map->count--;
+
+	return value;
+}
+
+uint32_t hashmap_count(const hashmap_t *map)
+{
+	assert(map);
+
+	return map->count;
+}
@@ -0,0 +1,95 @@
+#ifndef __TOOLS_HASHMAP_H__
+#define __TOOLS_HASHMAP_H__
+
+/** @file Fixed capacity hash map of integer or pointer keys to pointer values.
+ *
+ * The map uses open addressing with Robin Hood probing: an entry that is further from its home slot takes the slot
+ * of an entry that is closer to its own, so probe sequences stay short and even. A lookup of a missing key stops as
+ * soon as it meets an entry closer to its home slot than the key would be. Removal shifts following entries back
+ * instead of leaving tombstones, so performance doesn't degrade after many removals.
+ *
+ * Entries storage is provided by a user, usually defined with HASHMAP_DEFINE(). The map never allocates memory.
+ * Capacity must be a power of two. Keep the load below ~90% of capacity for short probe sequences.
+ *
+ * The map isn't thread safe, a user has to provide locking.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+typedef uintptr_t hashmap_key_t;
+
+/* Single slot of a map */
+typedef struct _hashmap_entry {
+	hashmap_key_t key;
+	void *value;
+	/* Distance from home slot plus one, zero means the slot is empty */
+	uint32_t distance;
+} hashmap_entry_t;
+
+typedef struct _hashmap {
+	hashmap_entry_t *entries;
+	/* Number of slots, power of two */
+	uint32_t capacity;
+	/* Number of stored entries */
+	uint32_t count;
+} hashmap_t;
+
+/* Evaluates to the capacity, the array size is negative so the build fails, if it isn't a power of two */
+#define HASHMAP_CAPACITY_CHECKED(capacity)                                                         \
+	((((capacity) > 0) && (((capacity) & ((capacity) - 1)) == 0)) ? (capacity) : -1)
+
+/** @brief Define a hash map with storage for given number of entries
+ *
+ * The map is ready to use, no hashmap_init() call is needed.
+ *
+ * @param name Name of the map object
+ * @param _capacity Number of entries, must be a power of two
+ */
+#define HASHMAP_DEFINE(name, _capacity)                                                            \
+	static hashmap_entry_t hashmap_entries_##name[HASHMAP_CAPACITY_CHECKED(_capacity)];        \
+	hashmap_t name = { .entries = hashmap_entries_##name, .capacity = (_capacity), .count = 0 }
+
+/** @brief Initialize a map, the map is empty
+ *
+ * @param map Pointer to a map
+ * @param entries Storage for entries
+ * @param capacity Number of elements in entries, must be a power of two
+ */
+void hashmap_init(hashmap_t *map, hashmap_entry_t *entries, uint32_t capacity);
+
+/** @brief Add a key to a map
+ *
+ * @param map Pointer to a map
+ * @param key Key to add
+ * @param value Value stored for the key, must not be NULL
+ *
+ * @return 0 The key was added
+ *         -EEXIST The key is already in the map, its value is not changed
+ *         -ENOMEM The map is full
+ */
+int hashmap_put(hashmap_t *map, hashmap_key_t key, void *value);
+
+/** @brief Find value of a key
+ *
+ * @return Value stored for the key, NULL if the key isn't in the map
+ */
+void *hashmap_get(const hashmap_t *map, hashmap_key_t key);
+
+/** @brief Remove a key from a map
+ *
+ * @return Value that was stored for the key, NULL if the key wasn't in the map
+ */
+void *hashmap_remove(hashmap_t *map, hashmap_key_t key);
+
+/** @brief Get number of keys stored in a map */
+uint32_t hashmap_count(const hashmap_t *map);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __TOOLS_HASHMAP_H__ */
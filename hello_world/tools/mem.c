@@ -0,0 +1,304 @@
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "mem.h"
+
+#if defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_7M__)
+#define MEM_LDM_STM_ENABLED 1
+#endif
+
+/* Size of data moved by a single iteration of block loops, two LDM/STM bursts of four registers */
+#define MEM_BLOCK_SIZE 32
+/* Shorter areas are handled byte by byte, alignment handling doesn't pay off for them */
+#define MEM_SHORT_SIZE 16
+
+#define MEM_WORD_SIZE sizeof(uint32_t)
+#define MEM_IS_WORD_ALIGNED(ptr) (((uintptr_t)(ptr) & (MEM_WORD_SIZE - 1)) == 0)
+
+/* Compiler recognizes byte loops below as memcpy() or memset() and replaces them with calls. That would call these
+ * functions recursively when the C library functions are wrapped.
+ */
+#if defined(__GNUC__) && !defined(__clang__)
+#define MEM_NO_LIBCALL __attribute__((optimize("no-tree-loop-distribute-patterns")))
+#else
+#define MEM_NO_LIBCALL
+#endif
+
+/* Word that may be accessed at any address, and may alias any other type */
+typedef struct {
+	uint32_t value;
+} __attribute__((packed, may_alias)) mem_unaligned_word_t;
+
+typedef uint32_t __attribute__((may_alias)) mem_word_t;
+
+static inline uint32_t mem_unaligned_load(const uint8_t *src)
+{
+	return ((const mem_unaligned_word_t *)src)->value;
+}
+
+/* @brief Copy a number of MEM_BLOCK_SIZE blocks between word aligned areas, blocks must not be zero */
+MEM_NO_LIBCALL static inline void mem_blocks_copy(uint8_t *dst, const uint8_t *src, size_t blocks)
+{
+#ifdef MEM_LDM_STM_ENABLED
+	__asm__ volatile("1:\n\t"
+			 "ldmia	%[src]!, {r3, r4, r5, r6}\n\t"
+			 "stmia	%[dst]!, {r3, r4, r5, r6}\n\t"
+			 "ldmia	%[src]!, {r3, r4, r5, r6}\n\t"
+			 "stmia	%[dst]!, {r3, r4, r5, r6}\n\t"
+			 "subs	%[blocks], %[blocks], #1\n\t"
+			 "bne	1b\n\t"
+			 : [dst] "+r"(dst), [src] "+r"(src), [blocks] "+r"(blocks)
+			 :
+			 : "r3", "r4", "r5", "r6", "cc", "memory");
+#else
+	mem_word_t *dst_word = (mem_word_t *)dst;
+	const mem_word_t *src_word = (const mem_word_t *)src;
+
+	do {
+		dst_word[0] = src_word[0];
+		dst_word[1] = src_word[1];
+		dst_word[2] = src_word[2];
+		dst_word[3] = src_word[3];
+		dst_word[4] = src_word[4];
+		dst_word[5] = src_word[5];
+		dst_word[6] = src_word[6];
+		dst_word[7] = src_word[7];
+		dst_word += 8;
+		src_word += 8;
+	} while (--blocks != 0);
+#endif /* MEM_LDM_STM_ENABLED */
+}
+
+/* @brief Fill a number of MEM_BLOCK_SIZE blocks of a word aligned area, blocks must not be zero */
+MEM_NO_LIBCALL static inline void mem_blocks_set(uint8_t *dst, uint32_t pattern, size_t blocks)
+{
+#ifdef MEM_LDM_STM_ENABLED
+	__asm__ volatile("mov	r3, %[pattern]\n\t"
+			 "mov	r4, %[pattern]\n\t"
+			 "mov	r5, %[pattern]\n\t"
+			 "mov	r6, %[pattern]\n\t"
+			 "1:\n\t"
+			 "stmia	%[dst]!, {r3, r4, r5, r6}\n\t"
+			 "stmia	%[dst]!, {r3, r4, r5, r6}\n\t"
+			 "subs	%[blocks], %[blocks], #1\n\t"
+			 "bne	1b\n\t"
+			 : [dst] "+r"(dst), [blocks] "+r"(blocks)
+			 : [pattern] "r"(pattern)
+			 : "r3", "r4", "r5", "r6", "cc", "memory");
+#else
+	mem_word_t *dst_word = (mem_word_t *)dst;
+
+	do {
+		dst_word[0] = pattern;
+		dst_word[1] = pattern;
+		dst_word[2] = pattern;
+		dst_word[3] = pattern;
+		dst_word[4] = pattern;
+		dst_word[5] = pattern;
+		dst_word[6] = pattern;
+		dst_word[7] = pattern;
+		dst_word += 8;
+	} while (--blocks != 0);
+#endif /* MEM_LDM_STM_ENABLED */
+}
+
+/* @brief Copy memory in ascending address order
+ *
+ * Data is always loaded before it is stored to lower addresses, so it is safe for overlapping areas if destination
+ * is below source. Both mem_copy() and mem_move() use it.
+ */
+MEM_NO_LIBCALL static void mem_copy_forward(uint8_t *dst, const uint8_t *src, size_t size)
+{
+	if (size >= MEM_SHORT_SIZE) {
+		/* Align destination, unaligned stores cost more than unaligned loads */
+		while (!MEM_IS_WORD_ALIGNED(dst)) {
+			*dst++ = *src++;
+			size--;
+		}
+
+		if (MEM_IS_WORD_ALIGNED(src)) {
+			size_t blocks = size / MEM_BLOCK_SIZE;
+
+			if (blocks != 0) {
+				mem_blocks_copy(dst, src, blocks);
+				dst += blocks * MEM_BLOCK_SIZE;
+				src += blocks * MEM_BLOCK_SIZE;
+				size -= blocks * MEM_BLOCK_SIZE;
+			}
+
+			while (size >= MEM_WORD_SIZE) {
+				*(mem_word_t *)dst = *(const mem_word_t *)src;
+				dst += MEM_WORD_SIZE;
+				src += MEM_WORD_SIZE;
+				size -= MEM_WORD_SIZE;
+			}
+		} else {
+			/* LDM doesn't support unaligned addresses, use single loads */
+			while (size >= MEM_WORD_SIZE) {
+				*(mem_word_t *)dst = mem_unaligned_load(src);
+				dst += MEM_WORD_SIZE;
+				src += MEM_WORD_SIZE;
+				size -= MEM_WORD_SIZE;
+			}
+		}
+	}
+
+	while (size != 0) {
+		*dst++ = *src++;
+		size--;
+	}
+}
+
+/* @brief Copy memory in descending address order, for overlapping areas with destination above source */
+MEM_NO_LIBCALL static void mem_copy_backward(uint8_t *dst, const uint8_t *src, size_t size)
+{
+	/* Pointers are past the end of the areas */
+	dst += size;
+	src += size;
+
+	if (size >= MEM_SHORT_SIZE) {
+		while (!MEM_IS_WORD_ALIGNED(dst)) {
+			*--dst = *--src;
+			size--;
+		}
+
+		if (MEM_IS_WORD_ALIGNED(src)) {
+			while (size >= MEM_WORD_SIZE) {
+				dst -= MEM_WORD_SIZE;
+				src -= MEM_WORD_SIZE;
+				*(mem_word_t *)dst = *(const mem_word_t *)src;
+				size -= MEM_WORD_SIZE;
+			}
+		} else {
+			while (size >= MEM_WORD_SIZE) {
+				dst -= MEM_WORD_SIZE;
+				src -= MEM_WORD_SIZE;
+				*(mem_word_t *)dst = mem_unaligned_load(src);
+				size -= MEM_WORD_SIZE;
+			}
+		}
+	}
+
+	while (size != 0) {
+		*--dst = *--src;
+		size--;
+	}
+}
+
+void *mem_copy(void *restrict dst, const void *restrict src, size_t size)
+{
+	mem_copy_forward(dst, src, size);
+
+	return dst;
+}
+
+void *mem_move(void *dst, const void *src, size_t size)
+{
+	/* Unsigned difference is not less than size if destination is below source or areas do not overlap */
+	if ((uintptr_t)dst - (uintptr_t)src >= size) {
+		mem_copy_forward(dst, src, size);
+	} else {
+		mem_copy_backward(dst, src, size);
+	}
+
+	return dst;
+}
+
+MEM_NO_LIBCALL void *mem_set(void *dst, int value, size_t size)
+{
+	uint8_t *dst_byte = dst;
+	uint8_t byte = (uint8_t)value;
+
+	if (size >= MEM_SHORT_SIZE) {
+		uint32_t pattern = byte * 0x01010101UL;
+
+		while (!MEM_IS_WORD_ALIGNED(dst_byte)) {
+			*dst_byte++ = byte;
+			size--;
+		}
+
+		size_t blocks = size / MEM_BLOCK_SIZE;
+
+		if (blocks != 0) {
+			mem_blocks_set(dst_byte, pattern, blocks);
+			dst_byte += blocks * MEM_BLOCK_SIZE;
+			size -= blocks * MEM_BLOCK_SIZE;
+		}
+
+		while (size >= MEM_WORD_SIZE) {
+			*(mem_word_t *)dst_byte = pattern;
+			dst_byte += MEM_WORD_SIZE;
+			size -= MEM_WORD_SIZE;
+		}
+	}
+
+	while (size != 0) {
+		*dst_byte++ = byte;
+		size--;
+	}
+
+	return dst;
+}
+
+int mem_compare(const void *a, const void *b, size_t size)
+{
+	const uint8_t *a_byte = a;
+	const uint8_t *b_byte = b;
+
+	if (size >= MEM_SHORT_SIZE) {
+		while (!MEM_IS_WORD_ALIGNED(a_byte)) {
+			if (*a_byte != *b_byte) {
+				return *a_byte - *b_byte;
+			}
+			a_byte++;
+			b_byte++;
+			size--;
+		}
+
+		/* Skip equal words, the first different word is compared byte by byte below */
+		while (size >= MEM_WORD_SIZE && *(const mem_word_t *)a_byte == mem_unaligned_load(b_byte)) {
+			a_byte += MEM_WORD_SIZE;
+			b_byte += MEM_WORD_SIZE;
+			size -= MEM_WORD_SIZE;
+		}
+	}
+
+	while (size != 0) {
+		if (*a_byte != *b_byte) {
+			return *a_byte - *b_byte;
+		}
+		a_byte++;
+		b_byte++;
+		size--;
+	}
+
+	return 0;
+}
+
+#ifdef MEM_LIBC_WRAP_ENABLED
+/* Targets of linker --wrap option, see tools/CMakeLists.txt.
+ *
+ * Calls to the functions are also emitted by compiler during link time code generation, after unreferenced functions
+ * are dropped, so the functions are marked as used.
+ */
+__attribute__((used)) void *__wrap_memcpy(void *restrict dst, const void *restrict src, size_t size)
+{
+	return mem_copy(dst, src, size);
+}
+
+__attribute__((used)) void *__wrap_memmove(void *dst, const void *src, size_t size)
+{
+	return mem_move(dst, src, size);
+}
+
+__attribute__((used)) void *__wrap_memset(void *dst, int value, size_t size)
+{
+	return mem_set(dst, value, size);
+}
+
+__attribute__((used)) int __wrap_memcmp(const void *a, const void *b, size_t size)
+{
+	return mem_compare(a, b, size);
+}
+#endif /* MEM_LIBC_WRAP_ENABLED */
@@ -0,0 +1,42 @@
+#ifndef __TOOLS_MEM_H__
+#define __TOOLS_MEM_H__
+
+/** @file Memory copy, move, set and compare functions tuned for Cortex-M4.
+ *
+ * Destination is aligned to a word first, then bulk of data is moved in 32 byte blocks with LDM/STM bursts, then
+ * in words, then the tail in bytes. If source and destination have different alignment, source is read with
+ * unaligned word loads, that are supported by Cortex-M4 at a small cost. On other CPUs, e.g. on host for unit tests,
+ * portable C loops are used instead of LDM/STM.
+ *
+ * The functions have the same semantics as their standard library counterparts. When MEM_LIBC_WRAP_ENABLED is
+ * defined, memcpy(), memmove(), memset() and memcmp() calls of the whole image, including the C library itself, are
+ * redirected to these functions with linker --wrap option. Standard library versions stay available as
+ * __real_memcpy() etc.
+ */
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* @brief Copy memory areas that do not overlap, see memcpy() */
+void *mem_copy(void *dst, const void *src, size_t size);
+
+/* @brief Copy memory areas that may overlap, see memmove() */
+void *mem_move(void *dst, const void *src, size_t size);
+
+/* @brief Fill a memory area with a byte value, see memset() */
+void *mem_set(void *dst, int value, size_t size);
+
+/* @brief Compare memory areas, see memcmp()
+ *
+ * @return Difference of first pair of bytes that differ, as unsigned char, or zero if areas are equal
+ */
+int mem_compare(const void *a, const void *b, size_t size);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __TOOLS_MEM_H__ */
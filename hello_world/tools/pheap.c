@@ -0,0 +1,165 @@
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "pheap.h"
+
+/* @brief Link two roots, the one that goes later becomes the first child of the other one */
+static pheap_node_t *pheap_meld(pheap_t *heap, pheap_node_t *a, pheap_node_t *b)
+{
+	if (heap->less(b, a)) {
+		pheap_node_t *tmp = a;
+
+		a = b;
+		b = tmp;
+	}
+
+	b->prev = a;
+	b->next = a->child;
+	if (a->child != NULL) {
+		a->child->prev = b;
+	}
+	a->child = b;
+
+	return a;
+}
+
+/* @brief Merge a list of siblings into a single tree
+ *
+ * Two pass merge: siblings are melded in pairs from left to right, then the pairs are melded from right to left.
+ * The first pass keeps the pairs on a stack linked with next pointers, so no recursion is needed.
+ */
+static pheap_node_t *pheap_merge_pairs(pheap_t *heap, pheap_node_t *first)
+{
+	pheap_node_t *stack = NULL;
+	pheap_node_t *root = NULL;
+
+	while (first != NULL) {
+		pheap_node_t *a = first;
+		pheap_node_t *b = a->next;
+
+		a->next = NULL;
+		a->prev = NULL;
+
+		if (b != NULL) {
+			first = b->next;
+			b->next = NULL;
+			b->prev = NULL;
+
+			a = pheap_meld(heap, a, b);
+		} else {
+			first = NULL;
+		}
+
+		a->next = stack;
+		stack = a;
+	}
+
+	while (stack != NULL) {
+		pheap_node_t *a = stack;
+
+		stack = a->next;
+		a->next = NULL;
+
+		root = (root == NULL) ? a : pheap_meld(heap, root, a);
+	}
+
+	return root;
+}
+
+void pheap_init(pheap_t *heap, pheap_less_t less)
+{
+	assert(heap);
+	assert(less);
+
+	heap->root = NULL;
+	heap->less = less;
+}
+
+bool pheap_is_empty(pheap_t *heap)
+{
+	assert(heap);
+
+	return heap->root == NULL;
+}
+
+pheap_node_t *pheap_peek(pheap_t *heap)
+{
+	assert(heap);
+
+	return heap->root;
+}
+
+void pheap_insert(pheap_t *heap, pheap_node_t *node)
+{
+	assert(heap);
+	assert(node);
+
+	node->child = NULL;
+	node->next = NULL;
+	node->prev = NULL;
+
+	heap->root = (heap->root == NULL) ? node : pheap_meld(heap, heap->root, node);
+}
+
+pheap_node_t *pheap_pop(pheap_t *heap)
+{
+	assert(heap);
+
+	pheap_node_t *root = heap->root;
+
+	if (root == NULL) {
+		return NULL;
+	}
+
+	heap->root = pheap_merge_pairs(heap, root->child);
+	root->child = NULL;
+
+	return root;
+}
+
+void pheap_remove(pheap_t *heap, pheap_node_t *node)
+{
+	assert(heap);
+	assert(node);
+
+	if (node == heap->root) {
+		(void)pheap_pop(heap);
+
+		return;
+	}
+
+	assert(node->prev != NULL);
+
+	/* Unlink the subtree of the node from its parent or previous sibling */
+	if (node->prev->child == node) {
+		node->prev->child = node->next;
+	} else {
+		node->prev->next = node->next;
+	}
+
+	if (node->next != NULL) {
+		node->next->prev = node->prev;
+	}
+
+	node->next = NULL;
+	node->prev = NULL;
+
+	/* Children of the node form a new tree that is melded back */
+	pheap_node_t *subtree = pheap_merge_pairs(heap, node->child);
+
+	node->child = NULL;
+
+	if (subtree != NULL) {
+		heap->root = pheap_meld(heap, heap->root, subtree);
+	}
+}
+
+bool pheap_node_is_linked(pheap_t *heap, pheap_node_t *node)
+{
+	assert(heap);
+	assert(node);
+
+	return node->prev != NULL || node == heap->root;
+}
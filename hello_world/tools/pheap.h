@@ -0,0 +1,82 @@
+#ifndef __TOOLS_PHEAP_H__
+#define __TOOLS_PHEAP_H__
+
+/** @file This is an intrusive pairing heap, a priority queue.
+ *
+ * Insert and meld are O(1), peek of the minimum is O(1). Pop of the minimum and removal of any node are
+ * O(log n) amortized. Nodes are ordered by a compare function provided by a user, nodes that compare equal are
+ * popped in unspecified order. No operation uses recursion, so stack usage doesn't depend on number of nodes.
+ */
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/** @brief The structure is an internal type used to form a heap.
+ *
+ * This structure may be a member of other structure that stores actual node data. A node that isn't in a heap has
+ * NULL pointers.
+ */
+typedef struct _pheap_node {
+	/* The first child */
+	struct _pheap_node *child;
+	/* Next sibling */
+	struct _pheap_node *next;
+	/* Previous sibling, or parent for the first child, NULL for root */
+	struct _pheap_node *prev;
+} pheap_node_t;
+
+/** @brief Function that orders heap nodes
+ *
+ * @return true if node a goes before node b, false otherwise
+ */
+typedef bool (*pheap_less_t)(const pheap_node_t *a, const pheap_node_t *b);
+
+/** @brief The stucture holds a heap */
+typedef struct _pheap {
+	pheap_node_t *root;
+	pheap_less_t less;
+} pheap_t;
+
+void pheap_init(pheap_t *heap, pheap_less_t less);
+bool pheap_is_empty(pheap_t *heap);
+
+/** @brief Get the first node of a heap without removing it
+ *
+ * @return Pointer to the first node, NULL if the heap is empty
+ */
+pheap_node_t *pheap_peek(pheap_t *heap);
+
+/** @brief Add a node to a heap
+ *
+ * @param heap Pointer to a heap
+ * @param node Pointer to a node that isn't in any heap
+ */
+void pheap_insert(pheap_t *heap, pheap_node_t *node);
+
+/** @brief Remove the first node from a heap
+ *
+ * @return Pointer to the removed node, NULL if the heap is empty
+ */
+pheap_node_t *pheap_pop(pheap_t *heap);
+
+/** @brief Remove a node from a heap
+ *
+ * @param heap Pointer to a heap
+ * @param node Pointer to a node in the heap
+ */
+void pheap_remove(pheap_t *heap, pheap_node_t *node);
+
+/** @brief Check if a node is in a heap
+ *
+ * @param heap Pointer to a heap
+ * @param node Pointer to a node that is in the heap or isn't in any heap
+ */
+bool pheap_node_is_linked(pheap_t *heap, pheap_node_t *node);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __TOOLS_PHEAP_H__ */
@@ -0,0 +1,321 @@
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "rbtree.h"
+
+static inline bool rbtree_is_black(const rbtree_node_t *node)
+{
+	/* Missing leaves are black */
+	return node == NULL || node->color == RBTREE_BLACK;
+}
+
+static rbtree_node_t *rbtree_leftmost(rbtree_node_t *node)
+{
+	while (node->left != NULL) {
+		node = node->left;
+	}
+
+	return node;
+}
+
+/* @brief Put a node, or NULL, in place of other node in its parent */
+static void rbtree_replace(rbtree_t *tree, rbtree_node_t *old_node, rbtree_node_t *new_node)
+{
+	rbtree_node_t *parent = old_node->parent;
+
+	if (parent == NULL) {
+		tree->root = new_node;
+	} else if (parent->left == old_node) {
+		parent->left = new_node;
+	} else {
+		parent->right = new_node;
+	}
+
+	if (new_node != NULL) {
+		new_node->parent = parent;
+	}
+}
+
+static void rbtree_rotate_left(rbtree_t *tree, rbtree_node_t *node)
+{
+	rbtree_node_t *right = node->right;
+
+	node->right = right->left;
+	if (right->left != NULL) {
+		right->left->parent = node;
+	}
+
+	rbtree_replace(tree, node, right);
+
+	right->left = node;
+	node->parent = right;
+}
+
+static void rbtree_rotate_right(rbtree_t *tree, rbtree_node_t *node)
+{
+	rbtree_node_t *left = node->left;
+
+	node->left = left->right;
+	if (left->right != NULL) {
+		left->right->parent = node;
+	}
+
+	rbtree_replace(tree, node, left);
+
+	left->right = node;
+	node->parent = left;
+}
+
+static void rbtree_insert_fixup(rbtree_t *tree, rbtree_node_t *node)
+{
+	rbtree_node_t *parent;
+
+	while ((parent = node->parent) != NULL && parent->color == RBTREE_RED) {
+		/* Red parent isn't root, so grandparent exists */
+		rbtree_node_t *gparent = parent->parent;
+
+		if (parent == gparent->left) {
+			rbtree_node_t *uncle = gparent->right;
+
+			if (!rbtree_is_black(uncle)) {
+				parent->color = RBTREE_BLACK;
+				uncle->color = RBTREE_BLACK;
+				gparent->color = RBTREE_RED;
+				node = gparent;
+				continue;
+			}
+
+			if (node == parent->right) {
+				rbtree_rotate_left(tree, parent);
+				node = parent;
+				parent = node->parent;
+			}
+
+			parent->color = RBTREE_BLACK;
+			gparent->color = RBTREE_RED;
+			rbtree_rotate_right(tree, gparent);
+		} else {
+			rbtree_node_t *uncle = gparent->left;
+
+			if (!rbtree_is_black(uncle)) {
+				parent->color = RBTREE_BLACK;
+				uncle->color = RBTREE_BLACK;
+				gparent->color = RBTREE_RED;
+				node = gparent;
+				continue;
+			}
+
+			if (node == parent->left) {
+				rbtree_rotate_right(tree, parent);
+				node = parent;
+				parent = node->parent;
+			}
+
+			parent->color = RBTREE_BLACK;
+			gparent->color = RBTREE_RED;
+			rbtree_rotate_left(tree, gparent);
+		}
+	}
+
+	tree->root->color = RBTREE_BLACK;
+}
+
+/* @brief Restore tree properties after removal of a black node
+ *
+ * @param node Node that took place of the removed one, may be NULL
+ * @param parent Parent of the node, it is passed because the node may be NULL
+ */
+static void rbtree_remove_fixup(rbtree_t *tree, rbtree_node_t *node, rbtree_node_t *parent)
+{
+	while (node != tree->root && rbtree_is_black(node)) {
+		if (node == parent->left) {
+			rbtree_node_t *sibling = parent->right;
+
+			if (sibling->color == RBTREE_RED) {
+				sibling->color = RBTREE_BLACK;
+				parent->color = RBTREE_RED;
+				rbtree_rotate_left(tree, parent);
+				sibling = parent->right;
+			}
+
+			if (rbtree_is_black(sibling->left) && rbtree_is_black(sibling->right)) {
+				sibling->color = RBTREE_RED;
+				node = parent;
+				parent = node->parent;
+				continue;
+			}
+
+			if (rbtree_is_black(sibling->right)) {
+				sibling->left->color = RBTREE_BLACK;
+				sibling->color = RBTREE_RED;
+				rbtree_rotate_right(tree, sibling);
+				sibling = parent->right;
+			}
+
+			sibling->color = parent->color;
+			parent->color = RBTREE_BLACK;
+			sibling->right->color = RBTREE_BLACK;
+			rbtree_rotate_left(tree, parent);
+		} else {
+			rbtree_node_t *sibling = parent->left;
+
+			if (sibling->color == RBTREE_RED) {
+				sibling->color = RBTREE_BLACK;
+				parent->color = RBTREE_RED;
+				rbtree_rotate_right(tree, parent);
+				sibling = parent->left;
+			}
+
+			if (rbtree_is_black(sibling->left) && rbtree_is_black(sibling->right)) {
+				sibling->color = RBTREE_RED;
+				node = parent;
+				parent = node->parent;
+				continue;
+			}
+
+			if (rbtree_is_black(sibling->left)) {
+				sibling->right->color = RBTREE_BLACK;
+				sibling->color = RBTREE_RED;
+				rbtree_rotate_left(tree, sibling);
+				sibling = parent->left;
+			}
+
+			sibling->color = parent->color;
+			parent->color = RBTREE_BLACK;
+			sibling->left->color = RBTREE_BLACK;
+			rbtree_rotate_right(tree, parent);
+		}
+
+		node = tree->root;
+	}
+
+	if (node != NULL) {
+		node->color = RBTREE_BLACK;
+	}
+}
+
+void rbtree_init(rbtree_t *tree, rbtree_less_t less)
+{
+	assert(tree);
+	assert(less);
+
+	tree->root = NULL;
+	tree->first = NULL;
+	tree->less = less;
+}
+
+bool rbtree_is_empty(rbtree_t *tree)
+{
+	assert(tree);
+
+	return tree->root == NULL;
+}
+
+rbtree_node_t *rbtree_first(rbtree_t *tree)
+{
+	assert(tree);
+
+	return tree->first;
+}
+
+rbtree_node_t *rbtree_next(rbtree_node_t *node)
+{
+	assert(node);
+
+	if (node->right != NULL) {
+		return rbtree_leftmost(node->right);
+	}
+
+	while (node->parent != NULL && node == node->parent->right) {
+		node = node->parent;
+	}
+
+	return node->parent;
+}
+
+void rbtree_insert(rbtree_t *tree, rbtree_node_t *node)
+{
+	assert(tree);
+	assert(node);
+
+	rbtree_node_t *parent = NULL;
+	rbtree_node_t **link = &tree->root;
+	bool is_first = true;
+
+	/* Equal nodes go right, so those stay in order of insertion */
+	while (*link != NULL) {
+		parent = *link;
+
+		if (tree->less(node, parent)) {
+			link = &parent->left;
+		} else {
+			link = &parent->right;
+			is_first = false;
+		}
+	}
+
+	node->left = NULL;
+	node->right = NULL;
+	node->parent = parent;
+	node->color = RBTREE_RED;
+	*link = node;
+
+	if (is_first) {
+		tree->first = node;
+	}
+
+	rbtree_insert_fixup(tree, node);
+}
+
+void rbtree_remove(rbtree_t *tree, rbtree_node_t *node)
+{
+	assert(tree);
+	assert(node);
+
+	rbtree_node_t *child;
+	rbtree_node_t *parent;
+	uint8_t removed_color;
+
+	if (tree->first == node) {
+		tree->first = rbtree_next(node);
+	}
+
+	if (node->left == NULL || node->right == NULL) {
+		child = (node->left != NULL) ? node->left : node->right;
+		parent = node->parent;
+		removed_color = node->color;
+
+		rbtree_replace(tree, node, child);
+	} else {
+		/* Node with two children is replaced by its successor, that has no left child */
+		rbtree_node_t *successor = rbtree_leftmost(node->right);
+
+		child = successor->right;
+		removed_color = successor->color;
+
+		if (successor->parent == node) {
+			parent = successor;
+		} else {
+			parent = successor->parent;
+
+			rbtree_replace(tree, successor, child);
+			successor->right = node->right;
+			successor->right->parent = successor;
+		}
+
+		rbtree_replace(tree, node, successor);
+		successor->left = node->left;
+		successor->left->parent = successor;
+		successor->color = node->color;
+	}
+
+	if (removed_color == RBTREE_BLACK) {
+		rbtree_remove_fixup(tree, child, parent);
+	}
+
+	node->left = NULL;
+	node->right = NULL;
+	node->parent = NULL;
+}
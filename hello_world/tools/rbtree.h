@@ -0,0 +1,80 @@
+#ifndef __TOOLS_RBTREE_H__
+#define __TOOLS_RBTREE_H__
+
+/** @file This is an intrusive red-black tree.
+ *
+ * The tree keeps nodes ordered by a compare function provided by a user. Insert and remove are O(log n), the
+ * first node is cached so its lookup is O(1). Nodes that compare equal are kept in order of insertion, so the tree
+ * may be used as a FIFO ordered by key. No operation uses recursion.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+typedef enum {
+	RBTREE_RED,
+	RBTREE_BLACK,
+} RBTREE_COLOR_T;
+
+/** @brief The structure is an internal type used to form a tree.
+ *
+ * This structure may be a member of other structure that stores actual node data.
+ */
+typedef struct _rbtree_node {
+	struct _rbtree_node *left;
+	struct _rbtree_node *right;
+	struct _rbtree_node *parent;
+	uint8_t color;
+} rbtree_node_t;
+
+/** @brief Function that orders tree nodes
+ *
+ * @return true if node a goes before node b, false otherwise
+ */
+typedef bool (*rbtree_less_t)(const rbtree_node_t *a, const rbtree_node_t *b);
+
+/** @brief The stucture holds a tree */
+typedef struct _rbtree {
+	rbtree_node_t *root;
+	/* The first node in order, NULL if the tree is empty */
+	rbtree_node_t *first;
+	rbtree_less_t less;
+} rbtree_t;
+
+void rbtree_init(rbtree_t *tree, rbtree_less_t less);
+bool rbtree_is_empty(rbtree_t *tree);
+
+/** @brief Get the first node of a tree
+ *
+ * @return Pointer to the first node, NULL if the tree is empty
+ */
+rbtree_node_t *rbtree_first(rbtree_t *tree);
+
+/** @brief Get next node of a tree in order
+ *
+ * @return Pointer to next node, NULL if the node is the last one
+ */
+rbtree_node_t *rbtree_next(rbtree_node_t *node);
+
+/** @brief Add a node to a tree, after all nodes that compare equal to it
+ *
+ * @param tree Pointer to a tree
+ * @param node Pointer to a node that isn't in any tree
+ */
+void rbtree_insert(rbtree_t *tree, rbtree_node_t *node);
+
+/** @brief Remove a node from a tree
+ *
+ * @param tree Pointer to a tree
+ * @param node Pointer to a node in the tree
+ */
+void rbtree_remove(rbtree_t *tree, rbtree_node_t *node);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __TOOLS_RBTREE_H__ */
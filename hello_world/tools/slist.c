@@ -177,6 +177,33 @@ void slist_next_put(slist_t *list, slist_node_t *node, slist_node_t *new_node)
 	}
 }
 
+bool slist_find_remove(slist_t *list, slist_node_t *node)
+{
+	assert(list);
+	assert(node);
+
+	slist_node_t *prev = NULL;
+	slist_node_t *current = list->head;
+
+	while (current != NULL) {
+		if (current == node) {
+			if (prev == NULL) {
+				slist_head_remove(list);
+			} else {
+				slist_next_remove(list, prev);
+			}
+			node->next = NULL;
+
+			return true;
+		}
+
+		prev = current;
+		current = current->next;
+	}
+
+	return false;
+}
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
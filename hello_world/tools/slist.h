@@ -7,6 +7,8 @@
  * between head and tail iteration is required to find right element. That operation is of O(n)
  * complexity.
  */
+#include <stdbool.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -42,6 +44,17 @@ slist_node_t *slist_next_get(slist_t *list, slist_node_t *node);
 void slist_next_remove(slist_t *list, slist_node_t *node);
 void slist_next_put(slist_t *list, slist_node_t *node, slist_node_t *new_node);
 
+/** @brief Find a node in a list and remove it.
+ *
+ * The operation is O(n) because it has to find a node that precedes removed one.
+ *
+ * @param list Pointer to a list the node is removed from
+ * @param node Pointer to a node to be removed
+ *
+ * @return true if the node was found and removed, false if it is not in the list
+ */
+bool slist_find_remove(slist_t *list, slist_node_t *node);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
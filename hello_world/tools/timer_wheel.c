@@ -0,0 +1,120 @@
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "misc.h"
+#include "timer_wheel.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define TIMER_WHEEL_NODE_GET(node_ptr) CONTAINER_OF(node_ptr, timer_wheel_node_t, node)
+
+static uint32_t timer_wheel_slot_get(uint32_t tick, uint32_t level)
+{
+	return (tick >> (level * TIMER_WHEEL_LEVEL_BITS)) & TIMER_WHEEL_LEVEL_MASK;
+}
+
+/* Put a node into a slot selected by distance to expiry. Signed distance handles tick wrap. */
+static void timer_wheel_insert(timer_wheel_t *wheel, timer_wheel_node_t *node)
+{
+	int32_t delta = (int32_t)(node->expiry - wheel->tick);
+	uint32_t slot_tick = node->expiry;
+	uint32_t level;
+
+	if (delta < 0) {
+		/* Already expired, process it at the next tick */
+		delta = 0;
+		slot_tick = wheel->tick;
+	} else if ((uint32_t)delta >= TIMER_WHEEL_RANGE) {
+		/* Too far, park it at the last level slot that is cascaded before the wheel range ends */
+		delta = TIMER_WHEEL_RANGE - 1;
+		slot_tick = wheel->tick + TIMER_WHEEL_RANGE - 1;
+	}
+
+	for (level = 0; level < TIMER_WHEEL_LEVELS - 1; level++) {
+		if ((uint32_t)delta < (1UL << ((level + 1) * TIMER_WHEEL_LEVEL_BITS))) {
+			break;
+		}
+	}
+
+	dlist_tail_put(&wheel->slots[level][timer_wheel_slot_get(slot_tick, level)], &node->node);
+}
+
+/* Move nodes of a slot to lower levels. Returns slot index, zero means the level has wrapped. */
+static uint32_t timer_wheel_cascade(timer_wheel_t *wheel, uint32_t level)
+{
+	uint32_t slot = timer_wheel_slot_get(wheel->tick, level);
+	dlist_t nodes;
+	dlist_node_t *node;
+
+	dlist_init(&nodes);
+	dlist_tail_join(&nodes, &wheel->slots[level][slot]);
+
+	while ((node = dlist_head_get(&nodes)) != NULL) {
+		timer_wheel_insert(wheel, TIMER_WHEEL_NODE_GET(node));
+	}
+
+	return slot;
+}
+
+void timer_wheel_init(timer_wheel_t *wheel, uint32_t tick)
+{
+	assert(wheel);
+
+	for (uint32_t level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+		for (uint32_t slot = 0; slot < TIMER_WHEEL_LEVEL_SLOTS; slot++) {
+			dlist_init(&wheel->slots[level][slot]);
+		}
+	}
+
+	wheel->tick = tick;
+}
+
+void timer_wheel_add(timer_wheel_t *wheel, timer_wheel_node_t *node, uint32_t expiry)
+{
+	assert(wheel);
+	assert(node);
+
+	node->expiry = expiry;
+	timer_wheel_insert(wheel, node);
+}
+
+void timer_wheel_remove(timer_wheel_node_t *node)
+{
+	assert(node);
+
+	dlist_remove(&node->node);
+}
+
+bool timer_wheel_node_is_active(timer_wheel_node_t *node)
+{
+	assert(node);
+
+	return dlist_node_is_linked(&node->node);
+}
+
+void timer_wheel_advance(timer_wheel_t *wheel, dlist_t *expired)
+{
+	assert(wheel);
+	assert(expired);
+
+	/* When level 0 wraps, bring the nodes of the current slot of level 1 down, and so on for higher levels */
+	if (timer_wheel_slot_get(wheel->tick, 0) == 0) {
+		for (uint32_t level = 1; level < TIMER_WHEEL_LEVELS; level++) {
+			if (timer_wheel_cascade(wheel, level) != 0) {
+				break;
+			}
+		}
+	}
+
+	dlist_tail_join(expired, &wheel->slots[0][timer_wheel_slot_get(wheel->tick, 0)]);
+
+	wheel->tick++;
+}
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
@@ -0,0 +1,83 @@
+#ifndef __TOOLS_TIMER_WHEEL_H__
+#define __TOOLS_TIMER_WHEEL_H__
+
+/** @file Hierarchical timing wheel.
+ *
+ * The wheel keeps nodes that expire at an absolute tick. Level 0 has a slot per tick, each next level has a slot
+ * per full turn of the previous level. When a level wraps, a slot of the next level is cascaded: its nodes are
+ * added again and fall to lower levels. Add and remove are O(1). Advance by one tick is O(1) plus number of
+ * expired and cascaded nodes; each node is cascaded at most once per level, so the cost doesn't grow with number
+ * of nodes in the wheel.
+ *
+ * Ticks are 32-bit and wrap. Expiry further than TIMER_WHEEL_RANGE ticks is stored in the last level and
+ * cascaded until it is close enough.
+ *
+ * The wheel isn't thread safe, a user has to provide locking.
+ */
+#include <stdint.h>
+
+#include "dlist.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define TIMER_WHEEL_LEVEL_BITS 6
+#define TIMER_WHEEL_LEVEL_SLOTS (1UL << TIMER_WHEEL_LEVEL_BITS)
+#define TIMER_WHEEL_LEVEL_MASK (TIMER_WHEEL_LEVEL_SLOTS - 1)
+#define TIMER_WHEEL_LEVELS 4
+/* Number of ticks covered by all levels */
+#define TIMER_WHEEL_RANGE (1UL << (TIMER_WHEEL_LEVEL_BITS * TIMER_WHEEL_LEVELS))
+
+typedef struct _timer_wheel_node {
+	dlist_node_t node;
+	/* Absolute tick when the node expires */
+	uint32_t expiry;
+} timer_wheel_node_t;
+
+typedef struct _timer_wheel {
+	dlist_t slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_LEVEL_SLOTS];
+	/* Next tick to be processed, all nodes that expire before it have been already expired */
+	uint32_t tick;
+} timer_wheel_t;
+
+/** @brief Initialize a wheel
+ *
+ * @param wheel Pointer to a wheel
+ * @param tick Current tick, first tick to be processed by timer_wheel_advance()
+ */
+void timer_wheel_init(timer_wheel_t *wheel, uint32_t tick);
+
+/** @brief Add a node to a wheel
+ *
+ * Expiry in the past is treated as expiry at the next processed tick.
+ *
+ * @param wheel Pointer to a wheel
+ * @param node Pointer to a node that isn't in the wheel
+ * @param expiry Absolute tick when the node expires
+ */
+void timer_wheel_add(timer_wheel_t *wheel, timer_wheel_node_t *node, uint32_t expiry);
+
+/** @brief Remove a node from a wheel
+ *
+ * @param node Pointer to a node in a wheel
+ */
+void timer_wheel_remove(timer_wheel_node_t *node);
+
+/** @brief Check if a node is in a wheel */
+bool timer_wheel_node_is_active(timer_wheel_node_t *node);
+
+/** @brief Process next tick of a wheel
+ *
+ * Nodes that expire at the tick are removed from the wheel and appended to the expired list.
+ *
+ * @param wheel Pointer to a wheel
+ * @param expired Pointer to a list that gets expired nodes
+ */
+void timer_wheel_advance(timer_wheel_t *wheel, dlist_t *expired);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __TOOLS_TIMER_WHEEL_H__ */
@@ -0,0 +1,460 @@
+
+#include <assert.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "tlsf.h"
+
+#define TLSF_BLOCK_FREE_BIT ((size_t)1)
+#define TLSF_BLOCK_PREV_FREE_BIT ((size_t)2)
+#define TLSF_BLOCK_FLAGS_MASK (TLSF_BLOCK_FREE_BIT | TLSF_BLOCK_PREV_FREE_BIT)
+
+/* Allocated block costs its size field only, prev_phys of next block is in the payload of the block */
+#define TLSF_BLOCK_HEADER_OVERHEAD sizeof(size_t)
+#define TLSF_BLOCK_START_OFFSET (offsetof(tlsf_block_t, size) + sizeof(size_t))
+/* Free block payload holds free list links and prev_phys of next block */
+#define TLSF_BLOCK_SIZE_MIN (sizeof(tlsf_block_t) - sizeof(tlsf_block_t *))
+#define TLSF_BLOCK_SIZE_MAX (((size_t)1 << TLSF_FL_INDEX_MAX) - TLSF_ALIGN_SIZE)
+
+/* Index of most significant set bit, word must not be 0. Compiled to CLZ instruction. */
+static inline uint32_t tlsf_fls(uint32_t word)
+{
+	return 31 - __builtin_clz(word);
+}
+
+/* Index of least significant set bit, word must not be 0. Lowest set bit is isolated, so CLZ finds it too. */
+static inline uint32_t tlsf_ffs(uint32_t word)
+{
+	return tlsf_fls(word & (~word + 1));
+}
+
+static inline size_t tlsf_align_up(size_t value)
+{
+	return (value + (TLSF_ALIGN_SIZE - 1)) & ~(TLSF_ALIGN_SIZE - 1);
+}
+
+static inline size_t tlsf_align_down(size_t value)
+{
+	return value & ~(TLSF_ALIGN_SIZE - 1);
+}
+
+static inline size_t block_size(const tlsf_block_t *block)
+{
+	return block->size & ~TLSF_BLOCK_FLAGS_MASK;
+}
+
+static inline void block_size_set(tlsf_block_t *block, size_t size)
+{
+	block->size = size | (block->size & TLSF_BLOCK_FLAGS_MASK);
+}
+
+static inline bool block_is_free(const tlsf_block_t *block)
+{
+	return (block->size & TLSF_BLOCK_FREE_BIT) != 0;
+}
+
+static inline bool block_is_prev_free(const tlsf_block_t *block)
+{
+	return (block->size & TLSF_BLOCK_PREV_FREE_BIT) != 0;
+}
+
+static inline void *block_to_ptr(tlsf_block_t *block)
+{
+	return (uint8_t *)block + TLSF_BLOCK_START_OFFSET;
+}
+
+static inline tlsf_block_t *block_from_ptr(void *ptr)
+{
+	return (tlsf_block_t *)((uint8_t *)ptr - TLSF_BLOCK_START_OFFSET);
+}
+
+static inline tlsf_block_t *block_next(tlsf_block_t *block)
+{
+	/* Next block header starts at the last word of the block payload */
+	return (tlsf_block_t *)((uint8_t *)block_to_ptr(block) + block_size(block) -
+				TLSF_BLOCK_HEADER_OVERHEAD);
+}
+
+/* @brief Get next physical block and let it know where the block is */
+static inline tlsf_block_t *block_link_next(tlsf_block_t *block)
+{
+	tlsf_block_t *next = block_next(block);
+
+	next->prev_phys = block;
+
+	return next;
+}
+
+static void block_mark_free(tlsf_block_t *block)
+{
+	tlsf_block_t *next = block_link_next(block);
+
+	next->size |= TLSF_BLOCK_PREV_FREE_BIT;
+	block->size |= TLSF_BLOCK_FREE_BIT;
+}
+
+static void block_mark_used(tlsf_block_t *block)
+{
+	tlsf_block_t *next = block_next(block);
+
+	next->size &= ~TLSF_BLOCK_PREV_FREE_BIT;
+	block->size &= ~TLSF_BLOCK_FREE_BIT;
+}
+
+/* @brief Get indexes of a list a free block of the size is stored in */
+static void mapping_insert(size_t size, uint32_t *fl, uint32_t *sl)
+{
+	if (size < TLSF_SMALL_BLOCK_SIZE) {
+		*fl = 0;
+		*sl = size / (TLSF_SMALL_BLOCK_SIZE / TLSF_SL_INDEX_COUNT);
+	} else {
+		uint32_t msb = tlsf_fls(size);
+
+		*sl = (size >> (msb - TLSF_SL_INDEX_COUNT_LOG2)) ^ TLSF_SL_INDEX_COUNT;
+		*fl = msb - (TLSF_FL_INDEX_SHIFT - 1);
+	}
+}
+
+/* @brief Get indexes of the first list that has only blocks not smaller than the size
+ *
+ * Size is rounded up to the next list boundary, so any block of the found list fits. That is what keeps the search
+ * O(1), at cost of internal fragmentation up to 1/TLSF_SL_INDEX_COUNT of the size.
+ */
+static void mapping_search(size_t size, uint32_t *fl, uint32_t *sl)
+{
+	if (size >= TLSF_SMALL_BLOCK_SIZE) {
+		size += ((size_t)1 << (tlsf_fls(size) - TLSF_SL_INDEX_COUNT_LOG2)) - 1;
+	}
+
+	mapping_insert(size, fl, sl);
+}
+
+static tlsf_block_t *search_suitable_block(tlsf_t *tlsf, uint32_t *fl, uint32_t *sl)
+{
+	/* Lists of the same first level range with blocks large enough */
+	uint32_t sl_map = tlsf->sl_bitmap[*fl] & (~0UL << *sl);
+
+	if (sl_map == 0) {
+		/* Any list of larger first level range */
+		uint32_t fl_map = tlsf->fl_bitmap & (~0UL << (*fl + 1));
+
+		if (fl_map == 0) {
+			return NULL;
+		}
+
+		*fl = tlsf_ffs(fl_map);
+		sl_map = tlsf->sl_bitmap[*fl];
+	}
+
+	*sl = tlsf_ffs(sl_map);
+
+	return tlsf->blocks[*fl][*sl];
+}
+
+static void free_block_remove(tlsf_t *tlsf, tlsf_block_t *block, uint32_t fl, uint32_t sl)
+{
+	tlsf_block_t *prev = block->prev_free;
+	tlsf_block_t *next = block->next_free;
+
+	if (next != NULL) {
+		next->prev_free = prev;
+	}
+
+	if (prev != NULL) {
+		prev->next_free = next;
+	} else {
+		tlsf->blocks[fl][sl] = next;
+
+		if (next == NULL) {
+			tlsf->sl_bitmap[fl] &= ~(1UL << sl);
+
+			if (tlsf->sl_bitmap[fl] == 0) {
+				tlsf->fl_bitmap &= ~(1UL << fl);
+			}
+		}
+	}
+
+	tlsf->free_size -= block_size(block);
+	tlsf->free_blocks--;
+}
+
+static void free_block_insert(tlsf_t *tlsf, tlsf_block_t *block)
+{
+	uint32_t fl;
+	uint32_t sl;
+
+	mapping_insert(block_size(block), &fl, &sl);
+
+	tlsf_block_t *head = tlsf->blocks[fl][sl];
+
+	block->next_free = head;
+	block->prev_free = NULL;
+	if (head != NULL) {
+		head->prev_free = block;
+	}
+
+	tlsf->blocks[fl][sl] = block;
+	tlsf->fl_bitmap |= (1UL << fl);
+	tlsf->sl_bitmap[fl] |= (1UL << sl);
+
+	tlsf->free_size += block_size(block);
+	tlsf->free_blocks++;
+}
+
+static void free_block_unlink(tlsf_t *tlsf, tlsf_block_t *block)
+{
+	uint32_t fl;
+	uint32_t sl;
+
+	mapping_insert(block_size(block), &fl, &sl);
+	free_block_remove(tlsf, block, fl, sl);
+}
+
+/* @brief Split a free block that isn't in a free list, remaining part is put into a free list */
+static void block_trim(tlsf_t *tlsf, tlsf_block_t *block, size_t size)
+{
+	/* Remaining part must be able to hold a free block */
+	if (block_size(block) < size + sizeof(tlsf_block_t)) {
+		return;
+	}
+
+	tlsf_block_t *remaining =
+		(tlsf_block_t *)((uint8_t *)block_to_ptr(block) + size - TLSF_BLOCK_HEADER_OVERHEAD);
+
+	/* The remaining block gets flags of a free block with used previous block, those are set below */
+	remaining->size = block_size(block) - (size + TLSF_BLOCK_HEADER_OVERHEAD);
+	block_size_set(block, size);
+
+	block_mark_free(remaining);
+	free_block_insert(tlsf, remaining);
+}
+
+/* @brief Merge a block with its previous physical block, return the merged block */
+static tlsf_block_t *block_absorb(tlsf_block_t *prev, tlsf_block_t *block)
+{
+	block_size_set(prev, block_size(prev) + block_size(block) + TLSF_BLOCK_HEADER_OVERHEAD);
+	block_link_next(prev);
+
+	return prev;
+}
+
+void tlsf_init(tlsf_t *tlsf)
+{
+	assert(tlsf);
+
+	tlsf->fl_bitmap = 0;
+
+	for (uint32_t fl = 0; fl < TLSF_FL_INDEX_COUNT; fl++) {
+		tlsf->sl_bitmap[fl] = 0;
+
+		for (uint32_t sl = 0; sl < TLSF_SL_INDEX_COUNT; sl++) {
+			tlsf->blocks[fl][sl] = NULL;
+		}
+	}
+
+	tlsf->free_size = 0;
+	tlsf->used_size = 0;
+	tlsf->used_peak = 0;
+	tlsf->free_blocks = 0;
+	tlsf->allocations = 0;
+	tlsf->failures = 0;
+}
+
+int tlsf_pool_add(tlsf_t *tlsf, void *mem, size_t size)
+{
+	assert(tlsf);
+	assert(mem);
+
+	uintptr_t start = tlsf_align_up((uintptr_t)mem);
+	size_t skipped = start - (uintptr_t)mem;
+
+	/* Pool holds a free block and a zero size sentinel block that ends the pool */
+	if (size < skipped + 2 * TLSF_BLOCK_HEADER_OVERHEAD + TLSF_BLOCK_SIZE_MIN) {
+		return -EINVAL;
+	}
+
+	size_t pool_size = tlsf_align_down(size - skipped - 2 * TLSF_BLOCK_HEADER_OVERHEAD);
+
+	if (pool_size < TLSF_BLOCK_SIZE_MIN || pool_size > TLSF_BLOCK_SIZE_MAX) {
+		return -EINVAL;
+	}
+
+	/* Block header starts one word before the pool, prev_phys of the first block is never accessed because there is
+	 * no previous free block.
+	 */
+	tlsf_block_t *block = (tlsf_block_t *)(start - TLSF_BLOCK_HEADER_OVERHEAD);
+
+	block->size = pool_size | TLSF_BLOCK_FREE_BIT;
+	free_block_insert(tlsf, block);
+
+	tlsf_block_t *sentinel = block_link_next(block);
+
+	sentinel->size = TLSF_BLOCK_PREV_FREE_BIT;
+
+	return 0;
+}
+
+void *tlsf_malloc(tlsf_t *tlsf, size_t size)
+{
+	assert(tlsf);
+
+	uint32_t fl;
+	uint32_t sl;
+
+	if (size == 0) {
+		return NULL;
+	}
+
+	if (size > TLSF_BLOCK_SIZE_MAX) {
+		tlsf->failures++;
+
+		return NULL;
+	}
+
+	size = tlsf_align_up(size);
+	if (size < TLSF_BLOCK_SIZE_MIN) {
+		size = TLSF_BLOCK_SIZE_MIN;
+	}
+
+	mapping_search(size, &fl, &sl);
+
+	tlsf_block_t *block = NULL;
+
+	if (fl < TLSF_FL_INDEX_COUNT) {
+		block = search_suitable_block(tlsf, &fl, &sl);
+	}
+
+	if (block == NULL) {
+		tlsf->failures++;
+
+		return NULL;
+	}
+
+	free_block_remove(tlsf, block, fl, sl);
+	block_trim(tlsf, block, size);
+	block_mark_used(block);
+
+	tlsf->used_size += block_size(block);
+	if (tlsf->used_size > tlsf->used_peak) {
+		tlsf->used_peak = tlsf->used_size;
+	}
+	tlsf->allocations++;
+
+	return block_to_ptr(block);
+}
+
+void tlsf_free(tlsf_t *tlsf, void *ptr)
+{
+	assert(tlsf);
+
+	if (ptr == NULL) {
+		return;
+	}
+
+	tlsf_block_t *block = block_from_ptr(ptr);
+
+	/* Double free */
+	assert(!block_is_free(block));
+
+	tlsf->used_size -= block_size(block);
+
+	if (block_is_prev_free(block)) {
+		tlsf_block_t *prev = block->prev_phys;
+
+		free_block_unlink(tlsf, prev);
+		block = block_absorb(prev, block);
+	}
+
+	tlsf_block_t *next = block_next(block);
+
+	if (block_is_free(next)) {
+		free_block_unlink(tlsf, next);
+		block = block_absorb(block, next);
+	}
+
+	block_mark_free(block);
+	free_block_insert(tlsf, block);
+}
+
+size_t tlsf_block_size(void *ptr)
+{
+	assert(ptr);
+
+	return block_size(block_from_ptr(ptr));
+}
+
+void tlsf_stats_get(tlsf_t *tlsf, tlsf_stats_t *stats)
+{
+	assert(tlsf);
+	assert(stats);
+
+	stats->free_size = tlsf->free_size;
+	stats->used_size = tlsf->used_size;
+	stats->used_peak = tlsf->used_peak;
+	stats->free_blocks = tlsf->free_blocks;
+	stats->allocations = tlsf->allocations;
+	stats->failures = tlsf->failures;
+	stats->largest_free = 0;
+
+	if (tlsf->fl_bitmap == 0) {
+		return;
+	}
+
+	/* The largest block is in the highest non-empty list, blocks in a list are not sorted */
+	uint32_t fl = tlsf_fls(tlsf->fl_bitmap);
+	uint32_t sl = tlsf_fls(tlsf->sl_bitmap[fl]);
+
+	for (tlsf_block_t *block = tlsf->blocks[fl][sl]; block != NULL; block = block->next_free) {
+		if (block_size(block) > stats->largest_free) {
+			stats->largest_free = block_size(block);
+		}
+	}
+}
+
+bool tlsf_check(tlsf_t *tlsf)
+{
+	assert(tlsf);
+
+	size_t free_size = 0;
+	uint32_t free_blocks = 0;
+
+	for (uint32_t fl = 0; fl < TLSF_FL_INDEX_COUNT; fl++) {
+		bool fl_used = (tlsf->fl_bitmap & (1UL << fl)) != 0;
+
+		if (fl_used != (tlsf->sl_bitmap[fl] != 0)) {
+			return false;
+		}
+
+		for (uint32_t sl = 0; sl < TLSF_SL_INDEX_COUNT; sl++) {
+			tlsf_block_t *block = tlsf->blocks[fl][sl];
+			bool sl_used = (tlsf->sl_bitmap[fl] & (1UL << sl)) != 0;
+
+			if (sl_used != (block != NULL)) {
+				return false;
+			}
+
+			for (tlsf_block_t *prev = NULL; block != NULL; prev = block, block = block->next_free) {
+				uint32_t block_fl;
+				uint32_t block_sl;
+				tlsf_block_t *next = block_next(block);
+
+				mapping_insert(block_size(block), &block_fl, &block_sl);
+
+				/* Free blocks are merged, so a free block has no free neighbours */
+				if (!block_is_free(block) || block_is_prev_free(block) ||
+				    block->prev_free != prev || block_fl != fl || block_sl != sl ||
+				    block_is_free(next) || !block_is_prev_free(next) ||
+				    next->prev_phys != block) {
+					return false;
+				}
+
+				free_size += block_size(block);
+				free_blocks++;
+			}
+		}
+	}
+
+	return free_size == tlsf->free_size && free_blocks == tlsf->free_blocks;
+}
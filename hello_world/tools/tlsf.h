@@ -0,0 +1,145 @@
+#ifndef __TOOLS_TLSF_H__
+#define __TOOLS_TLSF_H__
+
+/** @file Two-level segregated fit (TLSF) memory allocator.
+ *
+ * Free blocks are kept in segregated lists. First level splits sizes by power of two, second level splits each
+ * power of two range into TLSF_SL_INDEX_COUNT lists. A bitmap per level tells which lists are not empty, so a
+ * suitable list is found by a couple of count-leading-zeros instructions. Allocation and free are O(1) in the worst
+ * case, no matter of number of blocks. Neighbour free blocks are merged immediately on free.
+ *
+ * Each tlsf_t is an independent heap, e.g. one per RAM bank. A heap may be built of many memory pools. Allocated
+ * memory is aligned to TLSF_ALIGN_SIZE and has TLSF_ALIGN_SIZE bytes of overhead.
+ *
+ * The allocator isn't thread safe, a user has to provide locking.
+ */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* Alignment of allocated memory, a size of pointer */
+#if UINTPTR_MAX > 0xFFFFFFFFUL
+#define TLSF_ALIGN_SIZE_LOG2 3
+#else
+#define TLSF_ALIGN_SIZE_LOG2 2
+#endif
+#define TLSF_ALIGN_SIZE (1UL << TLSF_ALIGN_SIZE_LOG2)
+
+/* Number of second level lists per first level range, log2 */
+#define TLSF_SL_INDEX_COUNT_LOG2 4
+#define TLSF_SL_INDEX_COUNT (1UL << TLSF_SL_INDEX_COUNT_LOG2)
+
+/* Sizes below TLSF_SMALL_BLOCK_SIZE are kept in first level list 0, split linearly */
+#define TLSF_FL_INDEX_SHIFT (TLSF_SL_INDEX_COUNT_LOG2 + TLSF_ALIGN_SIZE_LOG2)
+#define TLSF_SMALL_BLOCK_SIZE (1UL << TLSF_FL_INDEX_SHIFT)
+
+/* Largest supported block is below 2^TLSF_FL_INDEX_MAX bytes */
+#define TLSF_FL_INDEX_MAX 30
+#define TLSF_FL_INDEX_COUNT (TLSF_FL_INDEX_MAX - TLSF_FL_INDEX_SHIFT + 1)
+
+typedef struct _tlsf_block {
+	/* Previous physical block, valid only if it is free. It is stored in the last word of the previous block. */
+	struct _tlsf_block *prev_phys;
+	/* Size of the block payload, two lowest bits are used for block flags */
+	size_t size;
+	/* Free list links, valid only if the block is free. Those are in the block payload. */
+	struct _tlsf_block *next_free;
+	struct _tlsf_block *prev_free;
+} tlsf_block_t;
+
+typedef struct _tlsf_stats {
+	/* Number of bytes in free blocks */
+	size_t free_size;
+	/* Number of bytes in allocated blocks, including alignment of requested size */
+	size_t used_size;
+	/* The highest value of used_size */
+	size_t used_peak;
+	/* Size of the largest free block, the largest allocation that succeeds */
+	size_t largest_free;
+	uint32_t free_blocks;
+	uint32_t allocations;
+	/* Number of allocations that failed due to lack of suitable free block */
+	uint32_t failures;
+} tlsf_stats_t;
+
+typedef struct _tlsf {
+	/* Bit per first level index, set if any list of the first level range isn't empty */
+	uint32_t fl_bitmap;
+	/* Bit per second level list of each first level range, set if the list isn't empty */
+	uint32_t sl_bitmap[TLSF_FL_INDEX_COUNT];
+	tlsf_block_t *blocks[TLSF_FL_INDEX_COUNT][TLSF_SL_INDEX_COUNT];
+	size_t free_size;
+	size_t used_size;
+	size_t used_peak;
+	uint32_t free_blocks;
+	uint32_t allocations;
+	uint32_t failures;
+} tlsf_t;
+
+/** @brief Initialize a heap, the heap has no memory until a pool is added
+ *
+ * @param tlsf Pointer to a heap
+ */
+void tlsf_init(tlsf_t *tlsf);
+
+/** @brief Add memory pool to a heap
+ *
+ * The memory is owned by the heap until the end of the program. Pools are not merged, even if adjacent.
+ *
+ * @param tlsf Pointer to a heap
+ * @param mem Pointer to a memory
+ * @param size Size of the memory
+ *
+ * @return 0 Pool added
+ *         -EINVAL Memory is too small or too large for a pool
+ */
+int tlsf_pool_add(tlsf_t *tlsf, void *mem, size_t size);
+
+/** @brief Allocate memory from a heap
+ *
+ * @param tlsf Pointer to a heap
+ * @param size Number of bytes to allocate
+ *
+ * @return Pointer to allocated memory aligned to TLSF_ALIGN_SIZE, NULL if size is 0 or there is no suitable block
+ */
+void *tlsf_malloc(tlsf_t *tlsf, size_t size);
+
+/** @brief Release memory allocated from a heap
+ *
+ * @param tlsf Pointer to a heap the memory was allocated from
+ * @param ptr Pointer to allocated memory, NULL is ignored
+ */
+void tlsf_free(tlsf_t *tlsf, void *ptr);
+
+/** @brief Get usable size of allocated memory, it may be larger than requested
+ *
+ * @param ptr Pointer to allocated memory
+ */
+size_t tlsf_block_size(void *ptr);
+
+/** @brief Get heap statistics
+ *
+ * The function walks all free blocks, its execution time isn't bounded.
+ *
+ * @param tlsf Pointer to a heap
+ * @param [out] stats Pointer to store statistics in
+ */
+void tlsf_stats_get(tlsf_t *tlsf, tlsf_stats_t *stats);
+
+/** @brief Check consistency of heap free lists and bitmaps
+ *
+ * Intended for tests and debugging, its execution time isn't bounded.
+ *
+ * @return true if the heap is consistent, false otherwise
+ */
+bool tlsf_check(tlsf_t *tlsf);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __TOOLS_TLSF_H__ */
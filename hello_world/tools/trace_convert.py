@@ -0,0 +1,198 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2023 Piotr Pryga
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+
+"""Convert a kernel trace dump into Chrome trace event JSON.
+
+The input is a binary stream produced by trace_dump() (see sys/trace.h): trace_dump_header_t followed by
+trace_record_t records, oldest first. The output can be opened in Perfetto UI (https://ui.perfetto.dev) or
+chrome://tracing.
+
+Example:
+    trace_convert.py trace.bin -o trace.json --names 1=main,2=idle
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+TRACE_DUMP_MAGIC = 0x4352544B
+TRACE_DUMP_VERSION = 2
+
+HEADER_FORMAT = "<IHHIII"
+RECORD_FORMAT = "<IBBHI"
+
+# Must match TRACE_EVENT_T in sys/trace.h
+TRACE_EVENT_SWITCH = 1
+TRACE_EVENT_SWAP_REQUEST = 2
+TRACE_EVENT_READY = 3
+TRACE_EVENT_BLOCK = 4
+TRACE_EVENT_WAKE = 5
+TRACE_EVENT_ISR_ENTER = 6
+TRACE_EVENT_ISR_EXIT = 7
+TRACE_EVENT_LOCK_ACQUIRE = 8
+TRACE_EVENT_LOCK_CONTEND = 9
+TRACE_EVENT_MARKER = 10
+
+INSTANT_EVENT_NAMES = {
+    TRACE_EVENT_SWAP_REQUEST: "swap request",
+    TRACE_EVENT_READY: "ready",
+    TRACE_EVENT_BLOCK: "block",
+    TRACE_EVENT_WAKE: "wake",
+    TRACE_EVENT_LOCK_ACQUIRE: "lock acquire",
+    TRACE_EVENT_LOCK_CONTEND: "lock contend",
+}
+
+PID = 1
+CPU_TID = 0
+ISR_TID_BASE = 1000
+
+
+def read_dump(stream):
+    data = stream.read()
+    header_size = struct.calcsize(HEADER_FORMAT)
+    if len(data) < header_size:
+        raise ValueError("dump is shorter than its header")
+
+    magic, version, record_size, record_count, lost_count, timestamp_hz = struct.unpack_from(
+        HEADER_FORMAT, data, 0)
+    if magic != TRACE_DUMP_MAGIC:
+        raise ValueError("bad magic 0x%08x" % magic)
+    if version != TRACE_DUMP_VERSION:
+        raise ValueError("unsupported dump version %d" % version)
+    if record_size != struct.calcsize(RECORD_FORMAT):
+        raise ValueError("unexpected record size %d" % record_size)
+
+    records = []
+    offset = header_size
+    for _ in range(record_count):
+        if offset + record_size > len(data):
+            break
+        records.append(struct.unpack_from(RECORD_FORMAT, data, offset))
+        offset += record_size
+
+    return records, lost_count, timestamp_hz
+
+
+def unwrap_timestamps(records):
+    """CYCCNT is 32 bit, assume there is less than one wrap between two consecutive records."""
+    base = 0
+    previous = None
+    for timestamp, event, _, data, arg in records:
+        if previous is not None and timestamp < previous:
+            base += 1 << 32
+        previous = timestamp
+        yield base + timestamp, event, data, arg
+
+
+class Converter:
+    def __init__(self, timestamp_hz, names):
+        self.cycles_per_us = timestamp_hz / 1e6
+        self.names = names
+        self.events = []
+        self.start = None
+        self.current = None
+        self.current_since = None
+        self.isr_since = {}
+
+    def thread_name(self, thread):
+        return self.names.get(thread, "thread %d" % thread)
+
+    def us(self, cycles):
+        return (cycles - self.start) / self.cycles_per_us
+
+    def slice(self, name, tid, begin, end, args=None):
+        event = {"name": name, "ph": "X", "pid": PID, "tid": tid, "ts": self.us(begin),
+                 "dur": (end - begin) / self.cycles_per_us}
+        if args:
+            event["args"] = args
+        self.events.append(event)
+
+    def instant(self, name, tid, timestamp, args=None):
+        event = {"name": name, "ph": "i", "s": "t", "pid": PID, "tid": tid, "ts": self.us(timestamp)}
+        if args:
+            event["args"] = args
+        self.events.append(event)
+
+    def add(self, timestamp, event, data, arg):
+        if self.start is None:
+            self.start = timestamp
+            self.current_since = timestamp
+
+        if event == TRACE_EVENT_SWITCH:
+            if self.current is not None:
+                self.slice(self.thread_name(self.current), CPU_TID, self.current_since, timestamp)
+            self.current = arg
+            self.current_since = timestamp
+        elif event == TRACE_EVENT_ISR_ENTER:
+            self.isr_since[data] = timestamp
+        elif event == TRACE_EVENT_ISR_EXIT:
+            since = self.isr_since.pop(data, None)
+            if since is not None:
+                self.slice("exception %d" % data, ISR_TID_BASE + data, since, timestamp)
+        elif event == TRACE_EVENT_MARKER:
+            self.instant("marker %d" % data, CPU_TID, timestamp, {"value": arg})
+        elif event in INSTANT_EVENT_NAMES:
+            if event in (TRACE_EVENT_LOCK_ACQUIRE, TRACE_EVENT_LOCK_CONTEND):
+                args = {"lock": "0x%08x" % arg}
+            else:
+                args = {"thread": self.thread_name(arg)}
+            self.instant(INSTANT_EVENT_NAMES[event], CPU_TID, timestamp, args)
+
+    def finish(self, timestamp):
+        if self.current is not None and timestamp is not None:
+            self.slice(self.thread_name(self.current), CPU_TID, self.current_since, timestamp)
+
+        metadata = [{"name": "process_name", "ph": "M", "pid": PID, "args": {"name": "kernel"}},
+                    {"name": "thread_name", "ph": "M", "pid": PID, "tid": CPU_TID, "args": {"name": "CPU"}}]
+        for tid in sorted({event["tid"] for event in self.events if event["tid"] >= ISR_TID_BASE}):
+            metadata.append({"name": "thread_name", "ph": "M", "pid": PID, "tid": tid,
+                             "args": {"name": "exception %d" % (tid - ISR_TID_BASE)}})
+
+        return {"traceEvents": metadata + self.events, "displayTimeUnit": "ns"}
+
+
+def parse_names(text):
+    names = {}
+    if not text:
+        return names
+    for item in text.split(","):
+        thread_id, name = item.split("=", 1)
+        names[int(thread_id, 0)] = name
+    return names
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("input", help="binary trace dump")
+    parser.add_argument("-o", "--output", help="output JSON file, stdout if not given")
+    parser.add_argument("--names", help="thread names, comma separated list of id=name")
+    args = parser.parse_args()
+
+    with open(args.input, "rb") as stream:
+        records, lost_count, timestamp_hz = read_dump(stream)
+
+    if lost_count:
+        print("warning: %d records were overwritten before the dump" % lost_count, file=sys.stderr)
+
+    converter = Converter(timestamp_hz, parse_names(args.names))
+    last = None
+    for timestamp, event, data, arg in unwrap_timestamps(records):
+        converter.add(timestamp, event, data, arg)
+        last = timestamp
+
+    trace = converter.finish(last)
+
+    if args.output:
+        with open(args.output, "w") as output:
+            json.dump(trace, output)
+    else:
+        json.dump(trace, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()